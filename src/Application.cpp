@@ -1,6 +1,8 @@
 #include "Application.h"
 #include "utils/Fonts.h"
 #include "utils/Config.h"
+#include "utils/Document.h"
+#include "utils/JobSystem.h"
 #include "widgets/MainMenu.h"
 #include "widgets/Logger.h"
 #include "widgets/Options.h"
@@ -8,7 +10,10 @@
 #include <iostream>
 #include <windows.h>
 
+#include "utils/rendering/FrameExporter.h"
+#include "utils/rendering/MeshFile.h"
 #include "utils/rendering/Meshes.h"
+#include "utils/rendering/SoftwareRasterizer.h"
 
 static Renderer::Mesh mesh;
 
@@ -42,7 +47,7 @@ Application::Application()
     /* Make the newly created window the current context */
     glfwMakeContextCurrent(m_window);
 
-    /* Unlock the framerate */
+    /* Sync to the display's refresh rate, the frame limiter can only lower it */
     glfwSwapInterval(1);
 
     /* Initialize the GLEW library */
@@ -64,9 +69,35 @@ Application::Application()
     ImGui::CreateContext();
 
     ImGui::StyleColorsDark();
+    // Installed first so that ImGui's callbacks chain to ours.
+    InstallEventCallbacks();
     ImGui_ImplGlfw_InitForOpenGL(m_window, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
 
+    Init();
+    LoadFramePacing();
+}
+
+Application::Application(const ExportOptions& options)
+{
+    m_isHeadless = true;
+    m_exportOptions = options;
+    m_width = float(options.width);
+    m_heigth = float(options.height);
+
+    ImGui::CreateContext();
+    ImGui::StyleColorsDark();
+    // Frames are rendered on the CPU, which handles large meshes like the OpenGL back-end does.
+    ImGui::GetIO().BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+
+    Init();
+}
+
+void Application::Init()
+{
+    // Physics, meshes, logs and exported frames all share the job system's workers.
+    Jobs::Init();
+
     // Load all fonts found.
     int fontSize = DEFAULT_FONT_SIZE;
     try
@@ -97,18 +128,50 @@ Application::Application()
 
     m_error = false;
 
-    std::vector<Renderer::Triangle> tris = { Renderer::Triangle({ 0, 0 }, { 1, 0 }, { 0, 1 }, 0xFFFFFFFF),
-                                             Renderer::Triangle({ 0, 1 }, { 0.5f, 0.5f }, { 1, 1 }, 0xFF0000FF) };
-    mesh = Renderer::Mesh(tris, ImVec2(100, 100), ImVec2(m_width / 2, m_heigth / 2));
+    // Load the mesh, or create its file from the default triangles the first time.
+    std::string meshPath = File::GetPathOfFile("Default.rmesh");
+    std::shared_ptr<const Renderer::MeshGeometry> geometry = Renderer::MeshFile::Load(meshPath);
+    if (geometry == nullptr)
+    {
+        std::vector<Renderer::Triangle> tris = { Renderer::Triangle({ 0, 0 }, { 1, 0 }, { 0, 1 }, 0xFFFFFFFF),
+                                                 Renderer::Triangle({ 0, 1 }, { 0.5f, 0.5f }, { 1, 1 }, 0xFF0000FF) };
+        geometry = Renderer::Mesh::BuildGeometry(tris);
+        Renderer::MeshFile::Save(meshPath, *geometry);
+    }
+    mesh = Renderer::Mesh(geometry, ImVec2(100, 100), ImVec2(m_width / 2, m_heigth / 2));
+
+    float lodPixelError = Renderer::Mesh::DEFAULT_LOD_PIXEL_ERROR;
+    try
+    {
+        lodPixelError = Config::GetField<float>("LodPixelError");
+    }
+    catch (std::invalid_argument)
+    {
+        Config::SetField<float>("LodPixelError", lodPixelError);
+    }
+    mesh.LodPixelError(lodPixelError);
+
+    // The rocket is the world's first entity, it falls once the simulation is started.
+    PlaceRocket(mesh);
 }
 
 Application::~Application()
 {
+    // Nothing may submit jobs once the workers are stopped.
+    m_physics.Stop();
+    Jobs::Shutdown();
+
     /* Terminate OpenGL, GLFW, GLEW and ImGui */
-    ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
+    if (m_isHeadless == false)
+    {
+        ImGui_ImplOpenGL3_Shutdown();
+        ImGui_ImplGlfw_Shutdown();
+    }
     ImGui::DestroyContext();
-    glfwTerminate();
+    if (m_isHeadless == false)
+    {
+        glfwTerminate();
+    }
 }
 
 void Application::AddWidget(std::function<void()> widgetFunction)
@@ -118,8 +181,11 @@ void Application::AddWidget(std::function<void()> widgetFunction)
 
 void Application::Run()
 {
+    m_lastFrameTime = glfwGetTime();
     while (!glfwWindowShouldClose(m_window))
     {
+        WaitForNextFrame();
+
         GLCall(glClearColor(RENDER_COLOR_BLACK));
 
         /* Start the Dear ImGui frame */
@@ -127,54 +193,269 @@ void Application::Run()
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
-        /* Set the size and position of the main window (the next one that will be created) */
-        ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiCond_Once);
-        ImGui::SetNextWindowSize(ImVec2(m_width, m_heigth), ImGuiCond_Once);
+        DrawFrame();
+        SetSimulationRunning(m_physics.IsRunning());
+
+        /* Render and draw the frame */
+        ImGui::Render();
+
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+        glfwSwapBuffers(m_window);
 
-        ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding, 0);
-        ImGui::Begin("Main Menu", nullptr, ImGuiWindowFlags_MenuBar | ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoBringToFrontOnFocus);
-        ImGui::PopStyleVar();
+        UpdateFramePacing();
+    }
+}
 
-        ImGui::ShowMetricsWindow();
-        static float size[2] = { 100, 100 };
-        static float pos[2] = { m_width / 2, m_heigth / 2 };
-        static float anchor[2] = { 0.5f, 0.5f };
-        static float rot = 0.0f;
+void Application::LoadFramePacing()
+{
+    try
+    {
+        m_frameRateLimit = Config::GetField<float>("FrameRateLimit");
+    }
+    catch (std::invalid_argument)
+    {
+        Config::SetField<float>("FrameRateLimit", m_frameRateLimit);
+    }
+    try
+    {
+        m_throttledFrameRate = Config::GetField<float>("ThrottledFrameRate");
+    }
+    catch (std::invalid_argument)
+    {
+        Config::SetField<float>("ThrottledFrameRate", m_throttledFrameRate);
+    }
+    try
+    {
+        m_idleRedrawInterval = Config::GetField<float>("IdleRedrawInterval");
+    }
+    catch (std::invalid_argument)
+    {
+        Config::SetField<float>("IdleRedrawInterval", m_idleRedrawInterval);
+    }
+}
+
+void Application::InstallEventCallbacks()
+{
+    // Any event from the window wakes the application up for a few frames.
+    glfwSetWindowUserPointer(m_window, this);
+    static auto onEvent = [](GLFWwindow* window)
+    {
+        static_cast<Application*>(glfwGetWindowUserPointer(window))->RequestRedraw();
+    };
+    glfwSetCursorPosCallback(m_window, [](GLFWwindow* window, double, double) { onEvent(window); });
+    glfwSetCursorEnterCallback(m_window, [](GLFWwindow* window, int) { onEvent(window); });
+    glfwSetMouseButtonCallback(m_window, [](GLFWwindow* window, int, int, int) { onEvent(window); });
+    glfwSetScrollCallback(m_window, [](GLFWwindow* window, double, double) { onEvent(window); });
+    glfwSetKeyCallback(m_window, [](GLFWwindow* window, int, int, int, int) { onEvent(window); });
+    glfwSetCharCallback(m_window, [](GLFWwindow* window, unsigned int) { onEvent(window); });
+    glfwSetWindowSizeCallback(m_window, [](GLFWwindow* window, int, int) { onEvent(window); });
+    glfwSetWindowFocusCallback(m_window, [](GLFWwindow* window, int) { onEvent(window); });
+    glfwSetWindowRefreshCallback(m_window, [](GLFWwindow* window) { onEvent(window); });
+}
+
+double Application::GetFramePeriod() const
+{
+    switch (m_pacing)
+    {
+        case FRAME_PACING_THROTTLED:
+            return 1.0 / m_throttledFrameRate;
+        case FRAME_PACING_IDLE:
+            return m_idleRedrawInterval;
+        case FRAME_PACING_FULL:
+        default:
+            return m_frameRateLimit > 0.0f ? 1.0 / m_frameRateLimit : 0.0;
+    }
+}
+
+void Application::WaitForNextFrame()
+{
+    // Nothing is drawn while minimized.
+    while (glfwGetWindowAttrib(m_window, GLFW_ICONIFIED) == GLFW_TRUE && !glfwWindowShouldClose(m_window))
+    {
+        glfwWaitEvents();
+    }
+
+    // Sleep in the event loop until the next frame is due. Input only cuts the wait short when
+    // throttled or idle, at full rate the frame limiter holds until its deadline regardless.
+    double deadline = m_lastFrameTime + GetFramePeriod();
+    double now = glfwGetTime();
+    while (now < deadline && (m_pacing == FRAME_PACING_FULL || m_framesToRedraw == 0))
+    {
+        glfwWaitEventsTimeout(deadline - now);
+        now = glfwGetTime();
+    }
+    glfwPollEvents();
+    m_lastFrameTime = glfwGetTime();
+}
+
+void Application::UpdateFramePacing()
+{
+    if (m_framesToRedraw > 0)
+    {
+        m_framesToRedraw--;
+    }
+
+    const ImGuiIO& io = ImGui::GetIO();
+    if (m_framesToRedraw > 0 || ImGui::IsAnyItemActive() == true || m_idleRedrawInterval <= 0.0f)
+    {
+        m_pacing = FRAME_PACING_FULL;
+    }
+    else if (m_isSimulationRunning == true || io.WantTextInput == true || ImGui::IsAnyItemHovered() == true)
+    {
+        // Keeps the simulation's display, blinking text cursors and tooltips moving at a lower rate.
+        m_pacing = m_throttledFrameRate > 0.0f ? FRAME_PACING_THROTTLED : FRAME_PACING_FULL;
+    }
+    else
+    {
+        m_pacing = FRAME_PACING_IDLE;
+    }
+}
+
+bool Application::Export()
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(m_width, m_heigth);
+    io.DeltaTime = 1.0f / m_exportOptions.frameRate;
+    // Nothing should be saved from a headless run.
+    io.IniFilename = nullptr;
+
+    Renderer::SoftwareRasterizer rasterizer(m_exportOptions.rasterizerThreads);
+    rasterizer.AddFontAtlas(io.Fonts);
+    Renderer::FrameExporter exporter(m_exportOptions.directory, m_exportOptions.format,
+                                     m_exportOptions.encoderThreads);
+
+    Logging::System.Info("Exporting frames: ", m_exportOptions.frameCount);
+    for (unsigned int frame = 0; frame < m_exportOptions.frameCount; frame++)
+    {
+        // Every frame advances the virtual time by exactly one frame period, physics included.
+        m_physics.Advance(io.DeltaTime);
+        ImGui::NewFrame();
+        DrawFrame();
+        ImGui::Render();
+
+        rasterizer.Render(ImGui::GetDrawData(), IM_COL32(0, 0, 0, 255));
+        // Hand the frame over without copying it, the rasterizer gets a recycled buffer instead.
+        std::vector<ImU32> pixels = exporter.AcquireBuffer();
+        rasterizer.SwapPixels(pixels);
+        exporter.Submit(std::move(pixels), rasterizer.Width(), rasterizer.Height());
+    }
+
+    return exporter.Finish();
+}
+
+void Application::DrawFrame()
+{
+    /* Set the size and position of the main window (the next one that will be created) */
+    ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiCond_Once);
+    ImGui::SetNextWindowSize(ImVec2(m_width, m_heigth), ImGuiCond_Once);
+
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding, 0);
+    ImGui::Begin("Main Menu", nullptr, ImGuiWindowFlags_MenuBar | ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoBringToFrontOnFocus);
+    ImGui::PopStyleVar();
+
+    static float size[2] = { 100, 100 };
+    static float pos[2] = { m_width / 2, m_heigth / 2 };
+    static float anchor[2] = { 0.5f, 0.5f };
+    static float rot = 0.0f;
+    // The world can only be edited while the physics thread is stopped.
+    if (m_physics.IsRunning() == false)
+    {
+        bool isEdited = false;
         if (ImGui::SliderFloat2("Size", size, 0, 1000))
         {
             mesh.Size(ImVec2(size[0], size[1]));
+            isEdited = true;
         }
         if (ImGui::SliderFloat2("Position", pos, 0, m_width))
         {
             mesh.Pos(ImVec2(pos[0], pos[1]));
+            isEdited = true;
         }
         if (ImGui::SliderFloat2("Anchor", anchor, 0, 1))
         {
             mesh.Anchor(ImVec2(anchor[0], anchor[1]));
+            isEdited = true;
         }
         if (ImGui::SliderFloat("Rotation", &rot, 0, 360.f))
         {
             mesh.Rotation(rot);
+            isEdited = true;
         }
-
-        mesh.Draw();
-        for (const std::function<void()>& widget : m_widgets)
+        if (isEdited == true)
         {
-            /* Process all widgets */
-            widget();
+            PlaceRocket(mesh);
         }
+    }
 
-        ImGui::End();
+    // The physics thread publishes the world, the objects are drawn where it was after its latest step.
+    const Simulation::WorldSnapshot& snapshot = m_physics.Latest();
+    if (ImGui::Button(m_physics.IsRunning() == true ? "Stop Simulation" : "Start Simulation"))
+    {
+        if (m_physics.IsRunning() == true)
+        {
+            m_physics.Stop();
+        }
+        else
+        {
+            m_physics.Start();
+        }
+    }
+    ImGui::SameLine();
+    ImGui::Text("T+%.3f s, step %llu", snapshot.time, snapshot.step);
 
-        /* Render and draw the frame */
-        ImGui::Render();
+    // The entities are gathered by shared mesh, and every mesh draws all its instances at once.
+    Simulation::EntityStore& entities = m_physics.DrawnEntities();
+    std::vector<Renderer::Mesh>& meshes = entities.Meshes();
+    if ( m_drawnInstances.size() < meshes.size() )
+    {
+        m_drawnInstances.resize(meshes.size());
+    }
+    for ( std::vector<Renderer::MeshInstance>& instances : m_drawnInstances )
+    {
+        instances.clear();
+    }
+    entities.ForEach(Simulation::ENTITY_VISIBLE, [&](const Simulation::Archetype& archetype)
+                     {
+                         for ( size_t row = 0; row < archetype.Size(); row++ )
+                         {
+                             const unsigned int index = archetype.indices[row];
+                             const Simulation::EntityVisual& visual = archetype.visuals[row];
+                             if ( index < snapshot.bodies.size() && visual.mesh != Simulation::EntityVisual::NO_MESH )
+                             {
+                                 Renderer::MeshInstance instance;
+                                 instance.pos = snapshot.bodies[index].position;
+                                 instance.size = visual.size;
+                                 instance.rotation = visual.rotation;
+                                 instance.tint = visual.tint;
+                                 m_drawnInstances[visual.mesh].push_back(instance);
+                             }
+                         }
+                     });
+    for ( size_t i = 0; i < meshes.size(); i++ )
+    {
+        if ( m_drawnInstances[i].empty() == false )
+        {
+            meshes[i].DrawInstances(m_drawnInstances[i]);
+        }
+    }
 
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    for (const std::function<void()>& widget : m_widgets)
+    {
+        /* Process all widgets */
+        widget();
+    }
 
-        glfwSwapBuffers(m_window);
+    ImGui::End();
+}
 
-        glfwPollEvents();
-    }
+void Application::PlaceRocket(const Renderer::Mesh& rocketMesh)
+{
+    // Rebuilt rather than edited, which also puts it back at rest where the mesh is.
+    Simulation::World& world = m_physics.GetWorld();
+    world.Entities().Destroy(m_rocket);
+    m_rocket = world.AddObject(Renderer::Object(rocketMesh, true, rocketMesh, true, rocketMesh.Pos(), true, ImVec2(), true));
+    m_physics.Publish();
 }
 
 void Application::windowSizeCallback(GLFWwindow* win, int w, int h)
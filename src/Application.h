@@ -14,19 +14,64 @@
 
 #include "glErrors.h"
 
+#include "simulation/PhysicsThread.h"
+#include "utils/rendering/ImageFile.h"
+#include "utils/rendering/Object.h"
+
+#include <string>
 #include <vector>
 #include <functional>
 
 #define CEP_COLOR_LIGHT_GRAY ImVec4(0.33984375f, 0.33984375f, 0.33984375f, 1.0f)
 
+/**
+ * Settings of a headless export, where frames are rendered on the CPU and written to image files.
+ */
+struct ExportOptions
+{
+    std::string directory = "export";
+    unsigned int frameCount = 600;
+    float frameRate = 60.0f;            //!< Frames per second of virtual time, independent of how fast they are rendered.
+    int width = 1920;
+    int height = 1080;
+    Renderer::ImageFile::ImageFormat_t format = Renderer::ImageFile::IMAGE_FORMAT_PNG;
+    unsigned int rasterizerThreads = 0; //!< 0 for one per core.
+    unsigned int encoderThreads = 0;    //!< Frames encoded at once on the job system, 0 for one per worker.
+};
+
+/**
+ * How soon the windowed application draws its next frame.
+ */
+typedef enum
+{
+    FRAME_PACING_FULL = 0,      //!< As soon as the frame limiter allows.
+    FRAME_PACING_THROTTLED,     //!< At the throttled frame rate, or sooner on input.
+    FRAME_PACING_IDLE,          //!< On input only, or after the idle redraw interval.
+} FramePacing_t;
+
 class Application
 {
 public:
+    static constexpr float DEFAULT_FRAME_RATE_LIMIT = 60.0f;
+    static constexpr float DEFAULT_THROTTLED_FRAME_RATE = 10.0f;
+    static constexpr float DEFAULT_IDLE_REDRAW_INTERVAL = 1.0f;
+    //! ImGui needs a few frames after an event to settle hover states and window sizes.
+    static constexpr int REDRAW_FRAMES_AFTER_EVENT = 3;
+
     Application(void);
+    /**
+     * @brief   Create a headless application, without any window nor OpenGL context, for Export.
+     */
+    explicit Application(const ExportOptions& options);
     ~Application(void);
 
     void AddWidget(std::function<void()> widgetFunction);
     void Run(void);
+    /**
+     * @brief   Run the frames of a headless application as fast as possible and write them to image files.
+     * @retval  False if any frame couldn't be written.
+     */
+    bool Export(void);
     inline float GetWidth(void)
     {
         return m_width;
@@ -39,16 +84,52 @@ public:
     {
         return m_error;
     }
+    /**
+     * @brief   Draw the next few frames at full rate, for something animated outside of ImGui's input.
+     */
+    inline void RequestRedraw(void)
+    {
+        m_framesToRedraw = REDRAW_FRAMES_AFTER_EVENT;
+    }
+    /**
+     * @brief   While a simulation runs, the UI is redrawn at the throttled frame rate even without input.
+     */
+    inline void SetSimulationRunning(bool isRunning)
+    {
+        m_isSimulationRunning = isRunning;
+    }
 
 private:
     float m_width = 800.0f;
     float m_heigth = 600.0f;
     bool m_error = true;
+    bool m_isHeadless = false;
+    ExportOptions m_exportOptions;
 
     GLFWwindow* m_window = NULL;
 
+    float m_frameRateLimit = DEFAULT_FRAME_RATE_LIMIT;          //!< 0 for the display's refresh rate.
+    float m_throttledFrameRate = DEFAULT_THROTTLED_FRAME_RATE;  //!< 0 to never throttle.
+    float m_idleRedrawInterval = DEFAULT_IDLE_REDRAW_INTERVAL;  //!< Seconds, 0 to never idle.
+    bool m_isSimulationRunning = false;
+    int m_framesToRedraw = REDRAW_FRAMES_AFTER_EVENT;
+    double m_lastFrameTime = 0.0;
+    FramePacing_t m_pacing = FRAME_PACING_FULL;
+
     std::vector<std::function<void()>> m_widgets;
 
+    Simulation::PhysicsThread m_physics;
+    Simulation::EntityHandle m_rocket = Simulation::EntityHandle();
+    std::vector<std::vector<Renderer::MeshInstance>> m_drawnInstances;     //!< Per shared mesh, kept between frames.
+
+    void Init(void);
+    void DrawFrame(void);
+    void PlaceRocket(const Renderer::Mesh& rocketMesh);
+    void LoadFramePacing(void);
+    void InstallEventCallbacks(void);
+    void WaitForNextFrame(void);
+    void UpdateFramePacing(void);
+    double GetFramePeriod(void) const;
     void windowSizeCallback(GLFWwindow* win, int w, int h);
 
 };
@@ -22,8 +22,16 @@
 
  /* Includes */
 #include "Application.h"
+#include "simulation/BatchFlight.h"
+#include "simulation/Dispersion.h"
+#include "simulation/Symplectic.h"
+#include "utils/JobSystem.h"
+#include "utils/rendering/VertexTransform.h"
+#include <chrono>
+#include <cmath>
 #include <iostream>
 #include <sstream>
+#include <string>
 
 /* Private defines */
 
@@ -32,10 +40,65 @@
 
 
 /* Private function declarations */
+static int BenchmarkTransform(void);
+static int BenchmarkOrbit(double orbits);
+static int BenchmarkFlights(size_t flightCount);
+static bool ParseDispersionParameters(int argc, char** argv, Simulation::DispersionParameters& parameters);
+static int Disperse(const Simulation::DispersionParameters& parameters);
+static bool ParseExportOptions(int argc, char** argv, ExportOptions& options);
+static int Export(const ExportOptions& options);
 
 
 int main(int argc, char** argv)
 {
+    if ( argc > 1 && std::string(argv[1]) == "--benchmark-transform" )
+    {
+        return BenchmarkTransform();
+    }
+    if ( argc > 1 && std::string(argv[1]) == "--benchmark-orbit" )
+    {
+        double orbits = 100.0;
+        if ( argc > 2 && (std::istringstream(argv[2]) >> orbits).fail() == true )
+        {
+            std::cout << "Usage: " << argv[0] << " --benchmark-orbit [<orbits>]" << std::endl;
+            return -1;
+        }
+        return BenchmarkOrbit(orbits);
+    }
+    if ( argc > 1 && std::string(argv[1]) == "--benchmark-flights" )
+    {
+        size_t flightCount = 2000;
+        if ( argc > 2 && ((std::istringstream(argv[2]) >> flightCount).fail() == true || flightCount == 0) )
+        {
+            std::cout << "Usage: " << argv[0] << " --benchmark-flights [<count>]" << std::endl;
+            return -1;
+        }
+        return BenchmarkFlights(flightCount);
+    }
+    if ( argc > 1 && std::string(argv[1]) == "--dispersion" )
+    {
+        Simulation::DispersionParameters parameters;
+        if ( ParseDispersionParameters(argc, argv, parameters) == false )
+        {
+            std::cout << "Usage: " << argv[0] << " --dispersion [--flights <count>] [--seed <seed>]"
+                " [--wind <m/s>] [--parachute <drag area m^2>] [--atmosphere standard|hot|cold] [--batched 0|1]"
+                " [--motor <.eng or .rse file> [--motor-name <name>]] [--dry-mass <kg>]" << std::endl;
+            return -1;
+        }
+        return Disperse(parameters);
+    }
+    if ( argc > 1 && std::string(argv[1]) == "--export" )
+    {
+        ExportOptions options;
+        if ( ParseExportOptions(argc, argv, options) == false )
+        {
+            std::cout << "Usage: " << argv[0] << " --export <directory> [--frames <count>] [--fps <rate>]"
+                " [--size <width>x<height>] [--format png|raw] [--render-threads <count>] [--encode-threads <count>]"
+                << std::endl;
+            return -1;
+        }
+        return Export(options);
+    }
 
     Application app;
     if ( app.GetHasError() == true )
@@ -51,6 +114,343 @@ int main(int argc, char** argv)
 }
 
 /* Private function definitions */
+/**
+ * @brief   Time the vertex transform kernels on a mesh-sized batch of vertices
+ *          and check that every SIMD variant matches the scalar code.
+ * @retval  0 if every variant is within 1 ulp of the scalar code, -1 otherwise.
+ */
+static int BenchmarkTransform(void)
+{
+    using namespace Renderer::VertexTransform;
+    const size_t vertexCount = 100000;
+    const int iterations = 200;
+
+    std::cout << "Transforming " << vertexCount << " vertices " << iterations << " times." << std::endl;
+    int status = 0;
+    for ( const BenchmarkResult& result : Benchmark(vertexCount, iterations) )
+    {
+        std::cout << GetInstructionSetName(result.set) << ":\t"
+            << result.nsPerVertex << " ns/vertex, "
+            << (result.nsPerVertex * double(vertexCount)) / 1000000.0 << " ms/frame, "
+            << "max error " << result.maxUlpError << " ulp" << std::endl;
+        if ( result.maxUlpError > 1 )
+        {
+            status = -1;
+        }
+    }
+    std::cout << "Using " << GetInstructionSetName(GetBestInstructionSet()) << std::endl;
+
+    return status;
+}
+
+/**
+ * @brief   Propagate a reference two-body orbit with every integrator and print how far
+ *          each one drifts from the exact solution.
+ * @param   orbits: Number of revolutions to propagate.
+ * @retval  0.
+ */
+static int BenchmarkOrbit(double orbits)
+{
+    std::cout << "Propagating " << orbits << " orbits." << std::endl;
+    for ( const Simulation::OrbitBenchmarkResult& result : Simulation::BenchmarkOrbit(orbits) )
+    {
+        std::cout << result.method << (result.isThroughWorld == true ? " (World)" : "") << ":\t";
+        if ( result.step > 0.0 )
+        {
+            std::cout << "step " << result.step << " s, ";
+        }
+        else
+        {
+            std::cout << "tolerance " << result.tolerance << ", ";
+        }
+        std::cout << result.evaluations << " evaluations, "
+            << "energy error max " << result.maxEnergyError << " final " << result.finalEnergyError << ", "
+            << "position error " << result.positionError << " km, "
+            << result.milliseconds << " ms" << std::endl;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief   Time the flights of a dispersion on one thread, one by one with Flight then in the
+ *          SIMD lanes of every supported instruction set, and print how far the lanes land from Flight.
+ * @param   flightCount: Number of flights of the dispersion.
+ * @retval  0 if every instruction set ends the flights like Flight, -1 otherwise.
+ */
+static int BenchmarkFlights(size_t flightCount)
+{
+    using namespace Simulation;
+    DispersionParameters parameters;
+    parameters.nominal.windSpeed = 4.0;
+    std::vector<RocketParameters> rockets;
+    for ( size_t i = 0; i < flightCount; i++ )
+    {
+        rockets.push_back(DrawRocket(parameters, i));
+    }
+
+    std::cout << "Simulating " << flightCount << " flights." << std::endl;
+    int status = 0;
+    for ( const BatchFlight::BenchmarkResult& result : BatchFlight::Benchmark(rockets) )
+    {
+        std::cout << result.method << " (" << result.lanes << " lanes):\t"
+            << result.flightsPerSecond << " flights/s, "
+            << result.evaluationsPerFlight << " evaluations/flight, "
+            << "max error apogee " << result.maxApogeeError << " m, landing " << result.maxLandingError << " m";
+        if ( result.statusMismatches > 0 )
+        {
+            std::cout << ", " << result.statusMismatches << " flights ended differently";
+            status = -1;
+        }
+        std::cout << std::endl;
+    }
+
+    return status;
+}
+
+/**
+ * @brief   Parse the arguments of --dispersion.
+ * @retval  False if an argument is unknown or invalid.
+ */
+static bool ParseDispersionParameters(int argc, char** argv, Simulation::DispersionParameters& parameters)
+{
+    for ( int i = 2; i < argc; i += 2 )
+    {
+        std::string name = argv[i];
+        if ( i + 1 >= argc )
+        {
+            return false;
+        }
+        std::istringstream value(argv[i + 1]);
+
+        if ( name == "--flights" )
+        {
+            value >> parameters.flightCount;
+        }
+        else if ( name == "--seed" )
+        {
+            value >> parameters.seed;
+        }
+        else if ( name == "--wind" )
+        {
+            value >> parameters.nominal.windSpeed;
+        }
+        else if ( name == "--parachute" )
+        {
+            value >> parameters.nominal.parachuteDragArea;
+        }
+        else if ( name == "--atmosphere" )
+        {
+            const std::string model = value.str();
+            if ( model == "standard" )
+            {
+                parameters.nominal.atmosphere = Simulation::ATMOSPHERE_STANDARD;
+            }
+            else if ( model == "hot" )
+            {
+                parameters.nominal.atmosphere = Simulation::ATMOSPHERE_HOT_DAY;
+            }
+            else if ( model == "cold" )
+            {
+                parameters.nominal.atmosphere = Simulation::ATMOSPHERE_COLD_DAY;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else if ( name == "--motor" )
+        {
+            // The first motor of the file, unless --motor-name picks another.
+            std::vector<const Simulation::Motor*> motors;
+            Simulation::MotorFileStatus_t status = Simulation::MotorLibrary::Load(value.str(), &motors);
+            if ( status != Simulation::MOTOR_FILE_OK )
+            {
+                std::cout << "Unable to load " << value.str() << ": " << Simulation::GetMotorFileStatusName(status) << std::endl;
+                return false;
+            }
+            parameters.nominal.motor = motors.front();
+        }
+        else if ( name == "--motor-name" )
+        {
+            parameters.nominal.motor = Simulation::MotorLibrary::Find(value.str());
+            if ( parameters.nominal.motor == nullptr )
+            {
+                std::cout << "No motor " << value.str() << " loaded" << std::endl;
+                return false;
+            }
+        }
+        else if ( name == "--dry-mass" )
+        {
+            value >> parameters.nominal.dryMass;
+        }
+        else if ( name == "--batched" )
+        {
+            value >> parameters.isBatched;
+        }
+        else
+        {
+            return false;
+        }
+
+        if ( value.fail() == true )
+        {
+            return false;
+        }
+    }
+
+    return parameters.flightCount > 0;
+}
+
+/**
+ * @brief   Fly a dispersion of the nominal rocket on every core, without a window, and print
+ *          the landing ellipse, the apogee distribution and the failures.
+ * @retval  0 if every flight landed and the landing ellipse holds its confidence of the landings it
+ *          wasn't fit on, -1 otherwise.
+ */
+static int Disperse(const Simulation::DispersionParameters& parameters)
+{
+    using namespace Simulation;
+    Jobs::Init();
+    DispersionReport report = RunDispersion(parameters);
+    Jobs::Shutdown();
+
+    std::cout << "Flew " << parameters.flightCount << " flights (" << Atmosphere::GetModelName(parameters.nominal.atmosphere)
+        << " atmosphere) in " << report.milliseconds << " ms ("
+        << report.evaluationCount / parameters.flightCount << " evaluations/flight)." << std::endl;
+    if ( parameters.nominal.motor != nullptr )
+    {
+        const Motor& motor = *parameters.nominal.motor;
+        std::cout << "Motor:\t" << motor.Manufacturer() << " " << motor.Name() << ", " << motor.TotalImpulse() << " N s, "
+            << motor.AverageThrust() << " N average, " << motor.MaxThrust() << " N max, " << motor.BurnTime() << " s" << std::endl;
+    }
+    for ( int status = 0; status < FLIGHT_STATUS_COUNT; status++ )
+    {
+        std::cout << GetFlightStatusName(FlightStatus_t(status)) << ":\t" << report.statusCounts[status] << std::endl;
+    }
+    const DistributionSummary& apogee = report.apogee;
+    std::cout << "Apogee:\tmean " << apogee.mean << " m, deviation " << apogee.deviation << " m, "
+        << "min " << apogee.minimum << " m, 1% " << apogee.percentile1 << " m, median " << apogee.median << " m, "
+        << "99% " << apogee.percentile99 << " m, max " << apogee.maximum << " m" << std::endl;
+    std::cout << "Flight time:\tmean " << report.flightTime.mean << " s, max " << report.flightTime.maximum << " s" << std::endl;
+    const LandingEllipse& landing = report.landing;
+    std::cout << "Landing ellipse (" << parameters.ellipseConfidence * 100.0 << "%):\tcenter "
+        << landing.centerEast << " m east, " << landing.centerNorth << " m north, "
+        << "axes " << landing.semiMajorAxis << " x " << landing.semiMinorAxis << " m, "
+        << "major axis at " << landing.orientation << " deg, holds " << landing.containedFraction * 100.0 << "% of the landings left out of its fit"
+        << std::endl;
+    // Too few landings, or landings on a line, have no ellipse to check. The fraction p held out of n landings
+    // varies by sqrt(p (1 - p) / n) from counting them and as much from fitting the halves, 3 deviations are a miss.
+    if ( landing.heldOutCount > 0 )
+    {
+        const double expected = landing.expectedFraction;
+        const double deviation = 2.0 * std::sqrt((expected * (1.0 - expected)) / double(landing.heldOutCount));
+        if ( landing.containedFraction < expected - (3.0 * deviation) )
+        {
+            std::cout << "The landing ellipse holds less than its confidence." << std::endl;
+            return -1;
+        }
+    }
+
+    return report.statusCounts[FLIGHT_LANDED] == parameters.flightCount ? 0 : -1;
+}
+
+/**
+ * @brief   Parse the arguments of --export.
+ * @retval  False if an argument is unknown or invalid.
+ */
+static bool ParseExportOptions(int argc, char** argv, ExportOptions& options)
+{
+    if ( argc < 3 )
+    {
+        return false;
+    }
+    options.directory = argv[2];
+
+    for ( int i = 3; i < argc; i += 2 )
+    {
+        std::string name = argv[i];
+        if ( i + 1 >= argc )
+        {
+            return false;
+        }
+        std::istringstream value(argv[i + 1]);
+        char separator = 0;
+
+        if ( name == "--frames" )
+        {
+            value >> options.frameCount;
+        }
+        else if ( name == "--fps" )
+        {
+            value >> options.frameRate;
+        }
+        else if ( name == "--size" )
+        {
+            value >> options.width >> separator >> options.height;
+            if ( separator != 'x' )
+            {
+                return false;
+            }
+        }
+        else if ( name == "--format" )
+        {
+            if ( value.str() == "png" )
+            {
+                options.format = Renderer::ImageFile::IMAGE_FORMAT_PNG;
+            }
+            else if ( value.str() == "raw" )
+            {
+                options.format = Renderer::ImageFile::IMAGE_FORMAT_RAW;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else if ( name == "--render-threads" )
+        {
+            value >> options.rasterizerThreads;
+        }
+        else if ( name == "--encode-threads" )
+        {
+            value >> options.encoderThreads;
+        }
+        else
+        {
+            return false;
+        }
+
+        if ( value.fail() == true )
+        {
+            return false;
+        }
+    }
+
+    return options.frameRate > 0.0f && options.width > 0 && options.height > 0;
+}
+
+/**
+ * @brief   Render frames without a window and write them to image files, as fast as the CPU allows.
+ * @retval  0 if every frame was written, -1 otherwise.
+ */
+static int Export(const ExportOptions& options)
+{
+    Application app(options);
+    if ( app.GetHasError() == true )
+    {
+        std::cout << "Unable to initialize application" << std::endl;
+        return -1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool isWritten = app.Export();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Exported " << options.frameCount << " frames to " << options.directory << " in "
+        << seconds << " s (" << options.frameCount / seconds << " frames/s)" << std::endl;
+    return isWritten == true ? 0 : -1;
+}
 
 /* Have a wonderful day :) */
 /**
@@ -0,0 +1,109 @@
+#include "Atmosphere.h"
+#include <cmath>
+#include <vector>
+
+namespace Simulation::Atmosphere
+{
+// Constants of the 1976 model.
+static constexpr double GAS_CONSTANT = 8.31432;             //!< J/(mol K).
+static constexpr double MOLAR_MASS = 0.0289644;             //!< Of the air, in kg/mol.
+static constexpr double GRAVITY = 9.80665;                  //!< m/s^2, that defines the geopotential altitude.
+static constexpr double EARTH_RADIUS = 6356766.0;           //!< m.
+static constexpr double HEAT_CAPACITY_RATIO = 1.4;
+static constexpr double SEA_LEVEL_TEMPERATURE = 288.15;     //!< K.
+static constexpr double SEA_LEVEL_PRESSURE = 101325.0;      //!< Pa.
+
+struct Layer
+{
+    double height;                  //!< Geopotential altitude of its base, in m.
+    double lapseRate;               //!< Change of the temperature with height, in K/m.
+};
+
+// The first layer also extends below sea level.
+static constexpr Layer LAYERS[] = {
+    { 0.0, -0.0065 }, { 11000.0, 0.0 }, { 20000.0, 0.001 }, { 32000.0, 0.0028 },
+    { 47000.0, 0.0 }, { 51000.0, -0.0028 }, { 71000.0, -0.002 },
+};
+static constexpr size_t LAYER_COUNT = sizeof(LAYERS) / sizeof(LAYERS[0]);
+
+static double GetLogPressureDrop(double lapseRate, double baseTemperature, double thickness);
+
+const double* GetTable(AirProperty_t property)
+{
+    static const std::vector<double> tables = []()
+    {
+        const double offsets[ATMOSPHERE_COUNT] = { 0.0, HOT_DAY_OFFSET, COLD_DAY_OFFSET };
+        std::vector<double> values(AIR_PROPERTY_COUNT * ATMOSPHERE_COUNT * NODE_COUNT);
+        for (size_t model = 0; model < ATMOSPHERE_COUNT; model++)
+        {
+            for (size_t node = 0; node < NODE_COUNT; node++)
+            {
+                const AirSample air = Compute(MIN_ALTITUDE + (double(node) * ALTITUDE_STEP), offsets[model]);
+                const size_t index = (model * NODE_COUNT) + node;
+                values[(AIR_DENSITY * ATMOSPHERE_COUNT * NODE_COUNT) + index] = air.density;
+                values[(AIR_PRESSURE * ATMOSPHERE_COUNT * NODE_COUNT) + index] = air.pressure;
+                values[(AIR_TEMPERATURE * ATMOSPHERE_COUNT * NODE_COUNT) + index] = air.temperature;
+                values[(AIR_SPEED_OF_SOUND * ATMOSPHERE_COUNT * NODE_COUNT) + index] = air.speedOfSound;
+            }
+        }
+        return values;
+    }();
+    return tables.data() + (size_t(property) * ATMOSPHERE_COUNT * NODE_COUNT);
+}
+
+AirSample Sample(double altitude, AtmosphereModel_t model)
+{
+    AirSample air;
+    air.density = Interpolate(GetTable(AIR_DENSITY, model), altitude);
+    air.pressure = Interpolate(GetTable(AIR_PRESSURE, model), altitude);
+    air.temperature = Interpolate(GetTable(AIR_TEMPERATURE, model), altitude);
+    air.speedOfSound = Interpolate(GetTable(AIR_SPEED_OF_SOUND, model), altitude);
+    return air;
+}
+
+AirSample Compute(double altitude, double temperatureOffset)
+{
+    const double height = (EARTH_RADIUS * altitude) / (EARTH_RADIUS + altitude);
+
+    // Climb the layers below, the pressure falls through each of them.
+    double baseTemperature = SEA_LEVEL_TEMPERATURE + temperatureOffset;
+    double logPressure = std::log(SEA_LEVEL_PRESSURE);
+    size_t layer = 0;
+    while (layer + 1 < LAYER_COUNT && height > LAYERS[layer + 1].height)
+    {
+        const double thickness = LAYERS[layer + 1].height - LAYERS[layer].height;
+        logPressure -= GetLogPressureDrop(LAYERS[layer].lapseRate, baseTemperature, thickness);
+        baseTemperature += LAYERS[layer].lapseRate * thickness;
+        layer++;
+    }
+    const double thickness = height - LAYERS[layer].height;
+    logPressure -= GetLogPressureDrop(LAYERS[layer].lapseRate, baseTemperature, thickness);
+
+    AirSample air;
+    air.temperature = baseTemperature + (LAYERS[layer].lapseRate * thickness);
+    air.pressure = std::exp(logPressure);
+    air.density = (air.pressure * MOLAR_MASS) / (GAS_CONSTANT * air.temperature);
+    air.speedOfSound = std::sqrt((HEAT_CAPACITY_RATIO * GAS_CONSTANT * air.temperature) / MOLAR_MASS);
+    return air;
+}
+
+const char* GetModelName(AtmosphereModel_t model)
+{
+    static const char* names[ATMOSPHERE_COUNT] = { "Standard", "Hot day", "Cold day" };
+    return model < ATMOSPHERE_COUNT ? names[model] : "Unknown";
+}
+
+/**
+ * @brief   Get how much the logarithm of the pressure falls through a thickness of geopotential
+ *          altitude, in hydrostatic equilibrium, with the temperature changing linearly from its base.
+ */
+static double GetLogPressureDrop(double lapseRate, double baseTemperature, double thickness)
+{
+    const double scale = (GRAVITY * MOLAR_MASS) / GAS_CONSTANT;
+    if (lapseRate == 0.0)
+    {
+        return (scale * thickness) / baseTemperature;
+    }
+    return (scale / lapseRate) * std::log((baseTemperature + (lapseRate * thickness)) / baseTemperature);
+}
+}
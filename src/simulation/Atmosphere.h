@@ -0,0 +1,99 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * The U.S. Standard Atmosphere 1976 up to 86 km, and hot and cold days that shift its temperature
+ * at every altitude while keeping its sea level pressure.
+ * The air is tabulated every ALTITUDE_STEP when first used and then read with linear
+ * interpolation, without branches: drag needs the density at every derivative evaluation, where
+ * the powers and exponentials of the model would cost more than the rest of the derivative.
+ * With 10 m between nodes the interpolation is within 3e-5 of the model next to the bends of the
+ * temperature between its layers, and within 4e-7 elsewhere. Outside the table, the air is that
+ * of its nearest end.
+ */
+namespace Simulation
+{
+typedef enum
+{
+    ATMOSPHERE_STANDARD = 0,
+    ATMOSPHERE_HOT_DAY,                 //!< Standard + HOT_DAY_OFFSET at every altitude.
+    ATMOSPHERE_COLD_DAY,                //!< Standard + COLD_DAY_OFFSET at every altitude.
+    ATMOSPHERE_COUNT,
+} AtmosphereModel_t;
+
+typedef enum
+{
+    AIR_DENSITY = 0,                    //!< kg/m^3.
+    AIR_PRESSURE,                       //!< Pa.
+    AIR_TEMPERATURE,                    //!< K.
+    AIR_SPEED_OF_SOUND,                 //!< m/s.
+    AIR_PROPERTY_COUNT,
+} AirProperty_t;
+
+struct AirSample
+{
+    double density = 0.0;               //!< kg/m^3.
+    double pressure = 0.0;              //!< Pa.
+    double temperature = 0.0;           //!< K.
+    double speedOfSound = 0.0;          //!< m/s.
+};
+
+namespace Atmosphere
+{
+static constexpr double MIN_ALTITUDE = -1000.0;     //!< Geometric altitude of the first node, in m.
+static constexpr double MAX_ALTITUDE = 86000.0;     //!< Of the last node, where the 1976 model changes composition.
+static constexpr double ALTITUDE_STEP = 10.0;       //!< m between nodes.
+static constexpr size_t NODE_COUNT = size_t((MAX_ALTITUDE - MIN_ALTITUDE) / ALTITUDE_STEP) + 1;
+static constexpr double HOT_DAY_OFFSET = 20.0;      //!< K.
+static constexpr double COLD_DAY_OFFSET = -20.0;    //!< K.
+
+/**
+ * @brief   Get the table of a property: NODE_COUNT nodes for each model, one model after the other.
+ *          The tables of every property are computed together on the first call, from any thread.
+ */
+const double* GetTable(AirProperty_t property);
+
+/**
+ * @brief   Get the NODE_COUNT nodes of a property for one model.
+ */
+inline const double* GetTable(AirProperty_t property, AtmosphereModel_t model)
+{
+    return GetTable(property) + (size_t(model) * NODE_COUNT);
+}
+
+/**
+ * @brief   Interpolate the nodes of one model at a geometric altitude in m.
+ */
+inline double Interpolate(const double* nodes, double altitude)
+{
+    // Clamped so that NaN ends up on the first node rather than out of the table.
+    const double position = std::max(0.0, std::min((altitude - MIN_ALTITUDE) * (1.0 / ALTITUDE_STEP),
+                                                   double(NODE_COUNT - 1)));
+    const size_t index = std::min(size_t(position), NODE_COUNT - 2);
+    const double fraction = position - double(index);
+    return nodes[index] + (fraction * (nodes[index + 1] - nodes[index]));
+}
+
+/**
+ * @brief   Get the density of the air at a geometric altitude in m, in kg/m^3, from the tables.
+ */
+inline double GetDensity(double altitude, AtmosphereModel_t model = ATMOSPHERE_STANDARD)
+{
+    return Interpolate(GetTable(AIR_DENSITY, model), altitude);
+}
+
+/**
+ * @brief   Get every property of the air at a geometric altitude in m, from the tables.
+ */
+AirSample Sample(double altitude, AtmosphereModel_t model = ATMOSPHERE_STANDARD);
+
+/**
+ * @brief   Compute the air of the model at a geometric altitude in m, without the tables.
+ * @param   temperatureOffset: Added to the standard temperature, in K.
+ */
+AirSample Compute(double altitude, double temperatureOffset = 0.0);
+
+const char* GetModelName(AtmosphereModel_t model);
+}
+}
@@ -0,0 +1,181 @@
+#include "BatchFlight.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace Simulation::BatchFlight
+{
+namespace
+{
+/**
+ * A single lane of plain doubles, for CPUs without SIMD extensions.
+ */
+struct ScalarLanes
+{
+    static constexpr size_t COUNT = 1;
+    using Real = double;
+    using Mask = bool;
+
+    static inline Real Set(double value)
+    {
+        return value;
+    }
+    static inline Real Load(const double* values)
+    {
+        return *values;
+    }
+    static inline void Store(double* values, Real value)
+    {
+        *values = value;
+    }
+    static inline Real Sqrt(Real value)
+    {
+        return std::sqrt(value);
+    }
+    static inline Real Min(Real a, Real b)
+    {
+        return std::min(a, b);
+    }
+    static inline Real Max(Real a, Real b)
+    {
+        return std::max(a, b);
+    }
+    static inline Mask Less(Real a, Real b)
+    {
+        return a < b;
+    }
+    static inline Mask LessEqual(Real a, Real b)
+    {
+        return a <= b;
+    }
+    static inline Mask Or(Mask a, Mask b)
+    {
+        return a || b;
+    }
+    static inline Real Select(Mask mask, Real a, Real b)
+    {
+        return mask == true ? a : b;
+    }
+    static inline Real Truncate(Real value)
+    {
+        return std::trunc(value);
+    }
+    static inline Real Gather(const double* table, Real indices)
+    {
+        return table[size_t(indices)];
+    }
+};
+}
+}
+
+#include "simulation/BatchFlightKernel.h"
+
+namespace Simulation::BatchFlight
+{
+using namespace Renderer::VertexTransform;
+
+size_t SimulateScalar(const RocketParameters* rockets, FlightResult* results, size_t count)
+{
+    return SimulateLanes<ScalarLanes>(rockets, results, count);
+}
+
+size_t Simulate(const RocketParameters* rockets, FlightResult* results, size_t count)
+{
+    static const InstructionSetEnum_t set = GetBestInstructionSet();
+    return Simulate(set, rockets, results, count);
+}
+
+size_t Simulate(InstructionSetEnum_t set, const RocketParameters* rockets, FlightResult* results, size_t count)
+{
+    switch (set)
+    {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+        case INSTRUCTION_SET_SSE2:
+            return SimulateSse2(rockets, results, count);
+        case INSTRUCTION_SET_AVX2:
+            return SimulateAvx2(rockets, results, count);
+        case INSTRUCTION_SET_AVX512:
+            return SimulateAvx512(rockets, results, count);
+#endif
+        default:
+            return SimulateScalar(rockets, results, count);
+    }
+}
+
+size_t GetLaneCount(InstructionSetEnum_t set)
+{
+    switch (set)
+    {
+        case INSTRUCTION_SET_SSE2:
+            return 2;
+        case INSTRUCTION_SET_AVX2:
+            return 4;
+        case INSTRUCTION_SET_AVX512:
+            return 8;
+        default:
+            return 1;
+    }
+}
+
+std::vector<BenchmarkResult> Benchmark(const std::vector<RocketParameters>& rockets)
+{
+    std::vector<BenchmarkResult> results;
+    const size_t count = rockets.size();
+    if (count == 0)
+    {
+        return results;
+    }
+
+    std::vector<FlightResult> reference(count);
+    BenchmarkResult flightResult;
+    flightResult.method = "Flight";
+    Flight flight;
+    size_t evaluations = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++)
+    {
+        reference[i] = flight.Simulate(rockets[i]);
+        evaluations += flight.EvaluationCount();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    flightResult.flightsPerSecond = double(count) / seconds;
+    flightResult.evaluationsPerFlight = double(evaluations) / double(count);
+    results.push_back(flightResult);
+
+    std::vector<FlightResult> flights(count);
+    for (int set = INSTRUCTION_SET_SCALAR; set < INSTRUCTION_SET_COUNT; set++)
+    {
+        if (IsSupported(InstructionSetEnum_t(set)) == false)
+        {
+            continue;
+        }
+        BenchmarkResult result;
+        result.method = GetInstructionSetName(InstructionSetEnum_t(set));
+        result.lanes = GetLaneCount(InstructionSetEnum_t(set));
+        start = std::chrono::steady_clock::now();
+        evaluations = Simulate(InstructionSetEnum_t(set), rockets.data(), flights.data(), count);
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.flightsPerSecond = double(count) / seconds;
+        result.evaluationsPerFlight = double(evaluations) / double(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            if (flights[i].status != reference[i].status)
+            {
+                result.statusMismatches++;
+                continue;
+            }
+            if (flights[i].status != FLIGHT_LANDED)
+            {
+                continue;
+            }
+            result.maxApogeeError = std::max(result.maxApogeeError, std::abs(flights[i].apogee - reference[i].apogee));
+            result.maxLandingError = std::max(result.maxLandingError,
+                                              std::hypot(flights[i].landingEast - reference[i].landingEast,
+                                                         flights[i].landingNorth - reference[i].landingNorth));
+        }
+        results.push_back(result);
+    }
+    return results;
+}
+}
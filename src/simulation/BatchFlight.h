@@ -0,0 +1,61 @@
+#pragma once
+#include "simulation/Flight.h"
+#include "utils/rendering/VertexTransform.h"
+#include <vector>
+
+/**
+ * Flights simulated side by side in the SIMD lanes of the CPU, one flight per lane of doubles:
+ * 2 with SSE2, 4 with AVX2 and 8 with AVX-512.
+ * The state of the flights is stored as structures of arrays across the lanes, and every stage of
+ * a Dormand-Prince step computes the derivatives of all the lanes with the same instructions. Each
+ * lane keeps its own step size, and accepts or rejects its steps on its own. Apogee, landing and
+ * burnout are then handled lane by lane. A lane whose flight is over, because it landed or
+ * failed, is refilled with the next flight of the batch, so lanes don't idle behind the slowest
+ * flight.
+ * The flights follow the same model and tolerances as Flight. Their results agree with it within
+ * the tolerances, but aren't bit for bit the same: lanes start with a fixed step instead of an
+ * estimated one and keep it across phases.
+ * The instruction set is detected like for the vertex transforms.
+ */
+namespace Simulation::BatchFlight
+{
+using Renderer::VertexTransform::InstructionSetEnum_t;
+
+static constexpr double INITIAL_STEP = 0.001;   //!< First step of a flight, in s, grown by the step control.
+
+struct BenchmarkResult
+{
+    const char* method = "";            //!< "Flight", or the name of the instruction set.
+    size_t lanes = 1;
+    double flightsPerSecond = 0.0;
+    double evaluationsPerFlight = 0.0;
+    double maxApogeeError = 0.0;        //!< Largest difference with Flight, in m.
+    double maxLandingError = 0.0;       //!< Largest distance to the landing point of Flight, in m.
+    size_t statusMismatches = 0;        //!< Flights that didn't end like with Flight.
+};
+
+/**
+ * @brief   Simulate count flights on the calling thread, with the widest instruction set supported.
+ * @param   results: Where to write the count results.
+ * @retval  The number of derivative evaluations, counted per flight.
+ */
+size_t Simulate(const RocketParameters* rockets, FlightResult* results, size_t count);
+
+/**
+ * @brief   Same as Simulate, but with a specific instruction set, that must be supported by the CPU.
+ */
+size_t Simulate(InstructionSetEnum_t set, const RocketParameters* rockets, FlightResult* results, size_t count);
+
+/**
+ * @brief   Get the number of flights simulated at once with an instruction set.
+ */
+size_t GetLaneCount(InstructionSetEnum_t set);
+
+/**
+ * @brief   Time Flight and every supported instruction set on the same flights, on one thread,
+ *          and compare their results with those of Flight.
+ * @param   rockets: The flights to simulate.
+ * @retval  The results of Flight first, then one per supported instruction set.
+ */
+std::vector<BenchmarkResult> Benchmark(const std::vector<RocketParameters>& rockets);
+}
@@ -0,0 +1,111 @@
+#include "simulation/BatchFlight.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+// Everything after, the kernel included, is compiled for AVX2. MSVC lets any function use any intrinsic.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC target("avx2")
+#endif
+
+namespace Simulation::BatchFlight
+{
+namespace
+{
+struct Avx2Real
+{
+    __m256d v;
+};
+
+inline Avx2Real operator+(Avx2Real a, Avx2Real b)
+{
+    return { _mm256_add_pd(a.v, b.v) };
+}
+inline Avx2Real operator-(Avx2Real a, Avx2Real b)
+{
+    return { _mm256_sub_pd(a.v, b.v) };
+}
+inline Avx2Real operator*(Avx2Real a, Avx2Real b)
+{
+    return { _mm256_mul_pd(a.v, b.v) };
+}
+inline Avx2Real operator/(Avx2Real a, Avx2Real b)
+{
+    return { _mm256_div_pd(a.v, b.v) };
+}
+
+struct Avx2Lanes
+{
+    static constexpr size_t COUNT = 4;
+    using Real = Avx2Real;
+    using Mask = __m256d;
+
+    static inline Real Set(double value)
+    {
+        return { _mm256_set1_pd(value) };
+    }
+    static inline Real Load(const double* values)
+    {
+        return { _mm256_load_pd(values) };
+    }
+    static inline void Store(double* values, Real value)
+    {
+        _mm256_store_pd(values, value.v);
+    }
+    static inline Real Sqrt(Real value)
+    {
+        return { _mm256_sqrt_pd(value.v) };
+    }
+    static inline Real Min(Real a, Real b)
+    {
+        return { _mm256_min_pd(a.v, b.v) };
+    }
+    static inline Real Max(Real a, Real b)
+    {
+        return { _mm256_max_pd(a.v, b.v) };
+    }
+    static inline Mask Less(Real a, Real b)
+    {
+        return _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ);
+    }
+    static inline Mask LessEqual(Real a, Real b)
+    {
+        return _mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ);
+    }
+    static inline Mask Or(Mask a, Mask b)
+    {
+        return _mm256_or_pd(a, b);
+    }
+    static inline Real Select(Mask mask, Real a, Real b)
+    {
+        return { _mm256_blendv_pd(b.v, a.v, mask) };
+    }
+    static inline Real Truncate(Real value)
+    {
+        return { _mm256_round_pd(value.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC) };
+    }
+    static inline Real Gather(const double* table, Real indices)
+    {
+        return { _mm256_i32gather_pd(table, _mm256_cvttpd_epi32(indices.v), 8) };
+    }
+};
+}
+}
+
+#include "simulation/BatchFlightKernel.h"
+
+namespace Simulation::BatchFlight
+{
+size_t SimulateAvx2(const RocketParameters* rockets, FlightResult* results, size_t count)
+{
+    return SimulateLanes<Avx2Lanes>(rockets, results, count);
+}
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#endif
+#endif
@@ -0,0 +1,111 @@
+#include "simulation/BatchFlight.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+// Everything after, the kernel included, is compiled for AVX-512. MSVC lets any function use any intrinsic.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC target("avx512f")
+#endif
+
+namespace Simulation::BatchFlight
+{
+namespace
+{
+struct Avx512Real
+{
+    __m512d v;
+};
+
+inline Avx512Real operator+(Avx512Real a, Avx512Real b)
+{
+    return { _mm512_add_pd(a.v, b.v) };
+}
+inline Avx512Real operator-(Avx512Real a, Avx512Real b)
+{
+    return { _mm512_sub_pd(a.v, b.v) };
+}
+inline Avx512Real operator*(Avx512Real a, Avx512Real b)
+{
+    return { _mm512_mul_pd(a.v, b.v) };
+}
+inline Avx512Real operator/(Avx512Real a, Avx512Real b)
+{
+    return { _mm512_div_pd(a.v, b.v) };
+}
+
+struct Avx512Lanes
+{
+    static constexpr size_t COUNT = 8;
+    using Real = Avx512Real;
+    using Mask = __mmask8;
+
+    static inline Real Set(double value)
+    {
+        return { _mm512_set1_pd(value) };
+    }
+    static inline Real Load(const double* values)
+    {
+        return { _mm512_load_pd(values) };
+    }
+    static inline void Store(double* values, Real value)
+    {
+        _mm512_store_pd(values, value.v);
+    }
+    static inline Real Sqrt(Real value)
+    {
+        return { _mm512_sqrt_pd(value.v) };
+    }
+    static inline Real Min(Real a, Real b)
+    {
+        return { _mm512_min_pd(a.v, b.v) };
+    }
+    static inline Real Max(Real a, Real b)
+    {
+        return { _mm512_max_pd(a.v, b.v) };
+    }
+    static inline Mask Less(Real a, Real b)
+    {
+        return _mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ);
+    }
+    static inline Mask LessEqual(Real a, Real b)
+    {
+        return _mm512_cmp_pd_mask(a.v, b.v, _CMP_LE_OQ);
+    }
+    static inline Mask Or(Mask a, Mask b)
+    {
+        return Mask(a | b);
+    }
+    static inline Real Select(Mask mask, Real a, Real b)
+    {
+        return { _mm512_mask_blend_pd(mask, b.v, a.v) };
+    }
+    static inline Real Truncate(Real value)
+    {
+        return { _mm512_roundscale_pd(value.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC) };
+    }
+    static inline Real Gather(const double* table, Real indices)
+    {
+        return { _mm512_i32gather_pd(_mm512_cvttpd_epi32(indices.v), table, 8) };
+    }
+};
+}
+}
+
+#include "simulation/BatchFlightKernel.h"
+
+namespace Simulation::BatchFlight
+{
+size_t SimulateAvx512(const RocketParameters* rockets, FlightResult* results, size_t count)
+{
+    return SimulateLanes<Avx512Lanes>(rockets, results, count);
+}
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#endif
+#endif
@@ -0,0 +1,704 @@
+#pragma once
+#include "simulation/BatchFlight.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ * The lane kernel of BatchFlight, compiled once per instruction set.
+ * Only for the BatchFlight translation units: each one includes it after the standard headers
+ * and after selecting its target, and instantiates it with the lanes of its instruction set.
+ * Everything here is a template on the lanes, or has internal linkage, so that the linker never
+ * merges code compiled for different instruction sets.
+ *
+ * The lanes L provide:
+ *  - COUNT, Real (COUNT doubles), Mask (COUNT booleans), with the arithmetic operators on Real;
+ *  - Set, Load and Store, the latter two on aligned arrays of COUNT doubles;
+ *  - Sqrt, Min, Max, Less, LessEqual, Or, and Select(mask, a, b), a where mask is set and b elsewhere;
+ *  - Truncate, toward 0, and Gather(table, indices), the doubles of a table at whole indices below 2^31.
+ */
+namespace Simulation::BatchFlight
+{
+size_t SimulateScalar(const RocketParameters* rockets, FlightResult* results, size_t count);
+size_t SimulateSse2(const RocketParameters* rockets, FlightResult* results, size_t count);
+size_t SimulateAvx2(const RocketParameters* rockets, FlightResult* results, size_t count);
+size_t SimulateAvx512(const RocketParameters* rockets, FlightResult* results, size_t count);
+
+namespace
+{
+constexpr size_t STATE_SIZE = Flight::STATE_SIZE;
+constexpr size_t STAGE_COUNT = 7;
+constexpr double PI = 3.14159265358979323846;
+
+typedef enum
+{
+    PHASE_BOOST = 0,
+    PHASE_COAST,
+    PHASE_DESCENT,
+} Phase_t;
+
+typedef enum
+{
+    EVENT_RAIL_EXIT = 0,
+    EVENT_APOGEE,
+    EVENT_LANDING,
+} Event_t;
+
+/**
+ * The flights in the lanes: their state and parameters as arrays across the lanes for the
+ * vectorized stages, and their bookkeeping lane by lane.
+ */
+template <typename L>
+struct Lanes
+{
+    static constexpr size_t N = L::COUNT;
+
+    alignas(64) double y[STATE_SIZE][N] = {};
+    alignas(64) double next[STATE_SIZE][N] = {};                //!< The state at the end of the step tried.
+    alignas(64) double stages[STAGE_COUNT][STATE_SIZE][N] = {}; //!< The derivatives of the step tried, the 1st at y.
+    alignas(64) double error[N] = {};
+    alignas(64) double step[N] = {};
+    alignas(64) double time[N] = {};
+    // Parameters of the flights, 0 thrust and mass flow once burnt out.
+    alignas(64) double thrust[N] = {};      //!< Constant, or the scale of the thrust of the motor.
+    alignas(64) double massFlow[N] = {};
+    alignas(64) double dragArea[N] = {};
+    alignas(64) double rail[3][N] = {};
+    alignas(64) double onRail[N] = {};      //!< 1 on the rail, 0 once off it.
+    alignas(64) double windEast[N] = {};
+    alignas(64) double windNorth[N] = {};
+    alignas(64) double atmosphere[N] = {};  //!< Index of the first density node of the atmosphere, in airDensity.
+    const double* airDensity = Atmosphere::GetTable(AIR_DENSITY);
+    alignas(64) double burning[N] = {};     //!< 1 burning a motor, 0 for a constant thrust or once burnt out.
+    alignas(64) double motorSample[N] = {}; //!< Index of the first thrust sample of the motor, in motorSamples.
+    alignas(64) double motorInverseStep[N] = {};
+    alignas(64) double massPerImpulse[N] = {};
+    // The thrust samples of every motor launched in the lanes, one after the other, and their motors.
+    std::vector<double> motorSamples = std::vector<double>();
+    std::vector<const Motor*> sampledMotors = std::vector<const Motor*>();
+
+    double railLengthSquared[N] = {};
+    double end[N] = {};                     //!< End of the phase.
+    bool isLast[N] = {};                    //!< The step tried ends the phase.
+    bool isActive[N] = {};
+    bool isRejected[N] = {};                //!< The last step tried was rejected.
+    bool isStale[N] = {};                   //!< The derivative at y changed, after an event or a burnout.
+    Phase_t phase[N] = {};
+    size_t flight[N] = {};
+    size_t stepCount[N] = {};
+    FlightResult result[N] = {};
+};
+
+template <typename L>
+struct LaneParameters
+{
+    typename L::Real thrust;
+    typename L::Real massFlow;
+    typename L::Real dragArea;
+    typename L::Real rail[3];
+    typename L::Real onRail;
+    typename L::Real windEast;
+    typename L::Real windNorth;
+    typename L::Real atmosphere;
+    const double* airDensity;
+    typename L::Real burning;
+    typename L::Real motorSample;
+    typename L::Real motorInverseStep;
+    typename L::Real massPerImpulse;
+    const double* motorSamples;
+    bool hasMotors;
+};
+
+/**
+ * @brief   Atmosphere::Interpolate in every lane, each from the nodes of its own atmosphere.
+ */
+template <typename L>
+inline typename L::Real GetLaneAirDensity(const LaneParameters<L>& p, typename L::Real altitude)
+{
+    using Real = typename L::Real;
+    const Real position = L::Max(L::Set(0.0), L::Min((altitude - L::Set(Atmosphere::MIN_ALTITUDE)) *
+                                                         L::Set(1.0 / Atmosphere::ALTITUDE_STEP),
+                                                     L::Set(double(Atmosphere::NODE_COUNT - 1))));
+    const Real index = L::Min(L::Truncate(position), L::Set(double(Atmosphere::NODE_COUNT - 2)));
+    const Real fraction = position - index;
+    const Real low = L::Gather(p.airDensity, index + p.atmosphere);
+    const Real high = L::Gather(p.airDensity + 1, index + p.atmosphere);
+    return low + (fraction * (high - low));
+}
+
+/**
+ * @brief   Motor::GetThrust and Motor::GetMassFlow in the lanes burning a motor, each from the samples of its own motor.
+ *          Every motor has SAMPLE_COUNT + 1 samples, so only where they start and their step differ.
+ */
+template <typename L>
+inline void GetLaneMotors(const LaneParameters<L>& p, typename L::Real time, typename L::Real& thrust,
+                          typename L::Real& massFlow)
+{
+    using Real = typename L::Real;
+    const Real position = L::Max(L::Set(0.0), L::Min(time * p.motorInverseStep, L::Set(double(Motor::SAMPLE_COUNT))));
+    const Real index = L::Min(L::Truncate(position), L::Set(double(Motor::SAMPLE_COUNT - 1)));
+    const Real fraction = position - index;
+    const Real low = L::Gather(p.motorSamples, index + p.motorSample);
+    const Real high = L::Gather(p.motorSamples + 1, index + p.motorSample);
+    const Real motorThrust = low + (fraction * (high - low));
+    const typename L::Mask isBurning = L::Less(L::Set(0.5), p.burning);
+    thrust = L::Select(isBurning, thrust * motorThrust, thrust);
+    massFlow = L::Select(isBurning, p.massPerImpulse * motorThrust, massFlow);
+}
+
+/**
+ * @brief   The same derivative as Flight::Derivative, for every lane.
+ */
+template <typename L>
+inline void GetDerivative(const LaneParameters<L>& p, typename L::Real time, const typename L::Real* y,
+                          typename L::Real* dydt)
+{
+    using Real = typename L::Real;
+    using Mask = typename L::Mask;
+    const Real zero = L::Set(0.0);
+    const Real one = L::Set(1.0);
+
+    const Real airVelocity[3] = { y[3] - p.windEast, y[4] - p.windNorth, y[5] };
+    const Real airSpeed = L::Sqrt((airVelocity[0] * airVelocity[0]) + (airVelocity[1] * airVelocity[1]) +
+                                  (airVelocity[2] * airVelocity[2]));
+    const Real mass = y[Flight::MASS];
+    const Real drag = (L::Set(0.5) * GetLaneAirDensity<L>(p, y[Flight::ALTITUDE]) * p.dragArea * airSpeed) / mass;
+    Real force = p.thrust;
+    Real massFlow = p.massFlow;
+    if (p.hasMotors == true)
+    {
+        GetLaneMotors<L>(p, time, force, massFlow);
+    }
+    const Real thrust = force / mass;
+    const Mask isOnRail = L::Less(L::Set(0.5), p.onRail);
+    const Mask isAlongRail = L::Or(isOnRail, L::LessEqual(airSpeed, zero));
+    const Real speed = L::Select(isAlongRail, one, airSpeed);
+
+    Real acceleration[3];
+    for (int i = 0; i < 3; i++)
+    {
+        const Real direction = L::Select(isAlongRail, p.rail[i], airVelocity[i] / speed);
+        acceleration[i] = (thrust * direction) - (drag * airVelocity[i]);
+    }
+    acceleration[2] = acceleration[2] - L::Set(Flight::GRAVITY);
+
+    const Real along = (acceleration[0] * p.rail[0]) + (acceleration[1] * p.rail[1]) + (acceleration[2] * p.rail[2]);
+    for (int i = 0; i < 3; i++)
+    {
+        acceleration[i] = L::Select(isOnRail, along * p.rail[i], acceleration[i]);
+    }
+
+    dydt[0] = y[3];
+    dydt[1] = y[4];
+    dydt[2] = y[5];
+    dydt[3] = acceleration[0];
+    dydt[4] = acceleration[1];
+    dydt[5] = acceleration[2];
+    dydt[Flight::MASS] = zero - massFlow;
+}
+
+template <typename L>
+inline LaneParameters<L> LoadParameters(const Lanes<L>& lanes)
+{
+    LaneParameters<L> p;
+    p.thrust = L::Load(lanes.thrust);
+    p.massFlow = L::Load(lanes.massFlow);
+    p.dragArea = L::Load(lanes.dragArea);
+    for (int i = 0; i < 3; i++)
+    {
+        p.rail[i] = L::Load(lanes.rail[i]);
+    }
+    p.onRail = L::Load(lanes.onRail);
+    p.windEast = L::Load(lanes.windEast);
+    p.windNorth = L::Load(lanes.windNorth);
+    p.atmosphere = L::Load(lanes.atmosphere);
+    p.airDensity = lanes.airDensity;
+    p.burning = L::Load(lanes.burning);
+    p.motorSample = L::Load(lanes.motorSample);
+    p.motorInverseStep = L::Load(lanes.motorInverseStep);
+    p.massPerImpulse = L::Load(lanes.massPerImpulse);
+    p.motorSamples = lanes.motorSamples.data();
+    p.hasMotors = std::any_of(std::begin(lanes.burning), std::end(lanes.burning), [](double burning) { return burning != 0.0; });
+    return p;
+}
+
+/**
+ * @brief   Try a step of every lane, of its own size, the lanes that aren't active included.
+ *          Fills next, the stages 2 to 7 and the error of every lane.
+ */
+template <typename L>
+inline void TryStep(Lanes<L>& lanes)
+{
+    using namespace DormandPrinceTableau;
+    using Real = typename L::Real;
+    const LaneParameters<L> p = LoadParameters(lanes);
+    const Real h = L::Load(lanes.step);
+    const Real t = L::Load(lanes.time);
+
+    Real y[STATE_SIZE];
+    Real k[STAGE_COUNT][STATE_SIZE];
+    Real stage[STATE_SIZE];
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        y[i] = L::Load(lanes.y[i]);
+        k[0][i] = L::Load(lanes.stages[0][i]);
+    }
+
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        stage[i] = y[i] + (h * L::Set(A21) * k[0][i]);
+    }
+    GetDerivative<L>(p, t + (L::Set(C2) * h), stage, k[1]);
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        stage[i] = y[i] + (h * ((L::Set(A31) * k[0][i]) + (L::Set(A32) * k[1][i])));
+    }
+    GetDerivative<L>(p, t + (L::Set(C3) * h), stage, k[2]);
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        stage[i] = y[i] + (h * ((L::Set(A41) * k[0][i]) + (L::Set(A42) * k[1][i]) + (L::Set(A43) * k[2][i])));
+    }
+    GetDerivative<L>(p, t + (L::Set(C4) * h), stage, k[3]);
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        stage[i] = y[i] + (h * ((L::Set(A51) * k[0][i]) + (L::Set(A52) * k[1][i]) + (L::Set(A53) * k[2][i]) +
+                                (L::Set(A54) * k[3][i])));
+    }
+    GetDerivative<L>(p, t + (L::Set(C5) * h), stage, k[4]);
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        stage[i] = y[i] + (h * ((L::Set(A61) * k[0][i]) + (L::Set(A62) * k[1][i]) + (L::Set(A63) * k[2][i]) +
+                                (L::Set(A64) * k[3][i]) + (L::Set(A65) * k[4][i])));
+    }
+    GetDerivative<L>(p, t + h, stage, k[5]);
+    Real next[STATE_SIZE];
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        next[i] = y[i] + (h * ((L::Set(A71) * k[0][i]) + (L::Set(A73) * k[2][i]) + (L::Set(A74) * k[3][i]) +
+                               (L::Set(A75) * k[4][i]) + (L::Set(A76) * k[5][i])));
+    }
+    GetDerivative<L>(p, t + h, next, k[6]);
+
+    // Root mean square of the errors, each relative to its tolerance, like DormandPrince.
+    const Real zero = L::Set(0.0);
+    const Real relative = L::Set(Flight::RELATIVE_TOLERANCE);
+    const double absolute[STATE_SIZE] = { Flight::POSITION_TOLERANCE, Flight::POSITION_TOLERANCE,
+                                          Flight::POSITION_TOLERANCE, Flight::VELOCITY_TOLERANCE,
+                                          Flight::VELOCITY_TOLERANCE, Flight::VELOCITY_TOLERANCE,
+                                          Flight::MASS_TOLERANCE };
+    Real sum = zero;
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        const Real error = h * ((L::Set(E1) * k[0][i]) + (L::Set(E3) * k[2][i]) + (L::Set(E4) * k[3][i]) +
+                                (L::Set(E5) * k[4][i]) + (L::Set(E6) * k[5][i]) + (L::Set(E7) * k[6][i]));
+        const Real magnitude = L::Max(L::Max(y[i], zero - y[i]), L::Max(next[i], zero - next[i]));
+        const Real ratio = error / (L::Set(absolute[i]) + (relative * magnitude));
+        sum = sum + (ratio * ratio);
+    }
+    L::Store(lanes.error, L::Sqrt(sum / L::Set(double(STATE_SIZE))));
+
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        L::Store(lanes.next[i], next[i]);
+        for (size_t s = 1; s < STAGE_COUNT; s++)
+        {
+            L::Store(lanes.stages[s][i], k[s][i]);
+        }
+    }
+}
+
+/**
+ * @brief   Recompute the derivative at y of the stale lanes.
+ * @retval  The number of active lanes recomputed.
+ */
+template <typename L>
+inline size_t Refresh(Lanes<L>& lanes)
+{
+    using Real = typename L::Real;
+    Real y[STATE_SIZE];
+    Real dydt[STATE_SIZE];
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        y[i] = L::Load(lanes.y[i]);
+    }
+    GetDerivative<L>(LoadParameters(lanes), L::Load(lanes.time), y, dydt);
+
+    alignas(64) double values[L::COUNT];
+    size_t count = 0;
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        L::Store(values, dydt[i]);
+        for (size_t lane = 0; lane < L::COUNT; lane++)
+        {
+            if (lanes.isStale[lane] == true)
+            {
+                lanes.stages[0][i][lane] = values[lane];
+            }
+        }
+    }
+    for (size_t lane = 0; lane < L::COUNT; lane++)
+    {
+        count += (lanes.isStale[lane] == true && lanes.isActive[lane] == true) ? 1 : 0;
+        lanes.isStale[lane] = false;
+    }
+    return count;
+}
+
+/**
+ * @brief   Interpolate the state of a lane within its step tried, like DormandPrince::Interpolate.
+ * @param   theta: Fraction of the step.
+ */
+template <typename L>
+inline void Interpolate(const Lanes<L>& lanes, size_t lane, double theta, double* y)
+{
+    using namespace DormandPrinceTableau;
+    const double h = lanes.step[lane];
+    const double theta1 = 1.0 - theta;
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        const double start = lanes.y[i][lane];
+        const double difference = lanes.next[i][lane] - start;
+        const double spline = (h * lanes.stages[0][i][lane]) - difference;
+        const double curvature = difference - (h * lanes.stages[6][i][lane]) - spline;
+        const double correction = h * ((D1 * lanes.stages[0][i][lane]) + (D3 * lanes.stages[2][i][lane]) +
+                                       (D4 * lanes.stages[3][i][lane]) + (D5 * lanes.stages[4][i][lane]) +
+                                       (D6 * lanes.stages[5][i][lane]) + (D7 * lanes.stages[6][i][lane]));
+        y[i] = start + (theta * (difference + (theta1 * (spline + (theta * (curvature + (theta1 * correction)))))));
+    }
+}
+
+/**
+ * @brief   Get where the thrust samples of a motor start in motorSamples, appending them the first time.
+ */
+template <typename L>
+inline size_t GetMotorSamples(Lanes<L>& lanes, const Motor& motor)
+{
+    const auto found = std::find(lanes.sampledMotors.begin(), lanes.sampledMotors.end(), &motor);
+    const size_t first = size_t(found - lanes.sampledMotors.begin()) * (Motor::SAMPLE_COUNT + 1);
+    if (found == lanes.sampledMotors.end())
+    {
+        lanes.sampledMotors.push_back(&motor);
+        lanes.motorSamples.insert(lanes.motorSamples.end(), motor.ThrustSamples().begin(), motor.ThrustSamples().end());
+    }
+    return first;
+}
+
+/**
+ * @brief   Start the flight of a rocket in a lane, like Flight::Simulate.
+ * @retval  False if it can't lift off, its result is then already final.
+ */
+template <typename L>
+inline bool Launch(Lanes<L>& lanes, size_t lane, const RocketParameters& rocket, size_t flight)
+{
+    const double tilt = rocket.launchTilt * (PI / 180.0);
+    const double azimuth = rocket.launchAzimuth * (PI / 180.0);
+    const double windDirection = rocket.windDirection * (PI / 180.0);
+    lanes.rail[0][lane] = std::sin(tilt) * std::sin(azimuth);
+    lanes.rail[1][lane] = std::sin(tilt) * std::cos(azimuth);
+    lanes.rail[2][lane] = std::cos(tilt);
+    lanes.railLengthSquared[lane] = rocket.railLength * rocket.railLength;
+    lanes.onRail[lane] = 1.0;
+    lanes.windEast[lane] = -rocket.windSpeed * std::sin(windDirection);
+    lanes.windNorth[lane] = -rocket.windSpeed * std::cos(windDirection);
+    lanes.atmosphere[lane] = double(size_t(rocket.atmosphere) * Atmosphere::NODE_COUNT);
+    lanes.burning[lane] = rocket.motor != nullptr ? 1.0 : 0.0;
+    if (rocket.motor != nullptr)
+    {
+        lanes.motorSample[lane] = double(GetMotorSamples(lanes, *rocket.motor));
+        lanes.motorInverseStep[lane] = rocket.motor->InverseStep();
+        lanes.massPerImpulse[lane] = rocket.motor->MassPerImpulse();
+    }
+    lanes.thrust[lane] = rocket.motor != nullptr ? rocket.thrustScale : rocket.thrust * rocket.thrustScale;
+    lanes.massFlow[lane] = rocket.burnTime > 0.0 ? rocket.propellantMass / rocket.burnTime : 0.0;
+    lanes.dragArea[lane] = rocket.dragCoefficient * PI * 0.25 * rocket.diameter * rocket.diameter;
+
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        lanes.y[i][lane] = 0.0;
+    }
+    const bool canLiftOff = GetLiftoff(rocket, lanes.time[lane], lanes.y[Flight::MASS][lane]);
+    lanes.end[lane] = GetBoostEnd(rocket, lanes.time[lane]);
+    lanes.step[lane] = INITIAL_STEP;
+    lanes.phase[lane] = PHASE_BOOST;
+    lanes.flight[lane] = flight;
+    lanes.stepCount[lane] = 0;
+    lanes.isRejected[lane] = false;
+    lanes.isStale[lane] = true;
+    lanes.result[lane] = FlightResult();
+    if (canLiftOff == false)
+    {
+        lanes.result[lane].status = FLIGHT_NO_LIFTOFF;
+    }
+    return canLiftOff;
+}
+
+/**
+ * @brief   Get a value of a lane that crosses 0 downwards when the event happens, like Flight::GetEventValue.
+ */
+template <typename L>
+inline double GetEventValue(const Lanes<L>& lanes, size_t lane, Event_t event, const double* y)
+{
+    switch (event)
+    {
+        case EVENT_RAIL_EXIT:
+            return std::min(lanes.railLengthSquared[lane] - ((y[0] * y[0]) + (y[1] * y[1]) + (y[2] * y[2])),
+                            y[Flight::ALTITUDE]);
+        case EVENT_APOGEE:
+            return y[Flight::VERTICAL_SPEED];
+        default:
+            return y[Flight::ALTITUDE];
+    }
+}
+
+template <typename L>
+inline void OpenParachute(Lanes<L>& lanes, size_t lane, const RocketParameters& rocket)
+{
+    lanes.phase[lane] = PHASE_DESCENT;
+    lanes.dragArea[lane] = rocket.parachuteDragArea > 0.0 ? rocket.parachuteDragArea : lanes.dragArea[lane];
+}
+
+/**
+ * @brief   Accept or reject the step a lane tried, and move its flight to its next phase, like Flight::Simulate.
+ * @retval  False once the flight is over, its result is then final.
+ */
+template <typename L>
+inline bool Advance(Lanes<L>& lanes, size_t lane, const RocketParameters& rocket)
+{
+    FlightResult& result = lanes.result[lane];
+    const double error = lanes.error[lane];
+    double& h = lanes.step[lane];
+    if (!(error <= 1.0))
+    {
+        if (h <= DormandPrince::DEFAULT_MIN_STEP)
+        {
+            result.status = FLIGHT_INTEGRATION_FAILED;
+            return false;
+        }
+        const double scale = std::isfinite(error) == true ?
+            std::max(DormandPrince::MIN_SCALE, DormandPrince::SAFETY * std::pow(error, -0.2)) : DormandPrince::MIN_SCALE;
+        h = std::max(h * scale, DormandPrince::DEFAULT_MIN_STEP);
+        lanes.isRejected[lane] = true;
+        return true;
+    }
+    if (++lanes.stepCount[lane] > DormandPrince::DEFAULT_MAX_STEPS)
+    {
+        result.status = FLIGHT_INTEGRATION_FAILED;
+        return false;
+    }
+
+    double next[STATE_SIZE];
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        next[i] = lanes.next[i][lane];
+    }
+    result.maxSpeed = std::max(result.maxSpeed, std::sqrt((next[3] * next[3]) + (next[4] * next[4]) + (next[5] * next[5])));
+    if (next[Flight::ALTITUDE] > result.apogee)
+    {
+        result.apogee = next[Flight::ALTITUDE];
+        result.apogeeTime = lanes.time[lane] + h;
+    }
+
+    const Event_t event = lanes.onRail[lane] != 0.0 ? EVENT_RAIL_EXIT :
+        (lanes.phase[lane] == PHASE_COAST ? EVENT_APOGEE : EVENT_LANDING);
+    double y[STATE_SIZE];
+    // Where the event value is known to be below 0, as a fraction of the step.
+    double eventEnd = 1.0;
+    bool isEventFound = GetEventValue(lanes, lane, event, next) < 0.0;
+    if (isEventFound == false && event == EVENT_RAIL_EXIT && lanes.y[Flight::VERTICAL_SPEED][lane] > 0.0 &&
+        next[Flight::VERTICAL_SPEED] <= 0.0)
+    {
+        // Topped out on the rail during the step, maybe past the top of the rail and back below it, like Flight::FindRailTop.
+        double low = 0.0;
+        while ((eventEnd - low) * h > Flight::EVENT_TOLERANCE)
+        {
+            const double middle = 0.5 * (low + eventEnd);
+            Interpolate(lanes, lane, middle, y);
+            if (y[Flight::VERTICAL_SPEED] <= 0.0)
+            {
+                eventEnd = middle;
+            }
+            else
+            {
+                low = middle;
+            }
+        }
+        Interpolate(lanes, lane, eventEnd, y);
+        isEventFound = GetEventValue(lanes, lane, event, y) < 0.0;
+    }
+    if (isEventFound == true)
+    {
+        // Bisect the step for where the event value crosses 0.
+        double low = 0.0;
+        double high = eventEnd;
+        while ((high - low) * h > Flight::EVENT_TOLERANCE)
+        {
+            const double middle = 0.5 * (low + high);
+            Interpolate(lanes, lane, middle, y);
+            if (GetEventValue(lanes, lane, event, y) < 0.0)
+            {
+                high = middle;
+            }
+            else
+            {
+                low = middle;
+            }
+        }
+        Interpolate(lanes, lane, high, y);
+        const double time = lanes.time[lane] + (high * h);
+        if (event == EVENT_RAIL_EXIT && y[Flight::ALTITUDE] > 0.0)
+        {
+            lanes.onRail[lane] = 0.0;
+            if (lanes.phase[lane] == PHASE_COAST && y[Flight::VERTICAL_SPEED] <= 0.0)
+            {
+                OpenParachute(lanes, lane, rocket);
+            }
+        }
+        else if (event == EVENT_RAIL_EXIT)
+        {
+            // Slid back down to the foot of the rail, it never flew.
+            result.status = FLIGHT_NO_LIFTOFF;
+            return false;
+        }
+        else if (event == EVENT_APOGEE)
+        {
+            result.apogee = y[Flight::ALTITUDE];
+            result.apogeeTime = time;
+            OpenParachute(lanes, lane, rocket);
+        }
+        else
+        {
+            result.status = FLIGHT_LANDED;
+            result.landingEast = y[0];
+            result.landingNorth = y[1];
+            result.flightTime = time;
+            return false;
+        }
+        // The next phase starts from the event.
+        for (size_t i = 0; i < STATE_SIZE; i++)
+        {
+            lanes.y[i][lane] = y[i];
+        }
+        lanes.time[lane] = time;
+        lanes.isStale[lane] = true;
+        lanes.isRejected[lane] = false;
+        return true;
+    }
+
+    for (size_t i = 0; i < STATE_SIZE; i++)
+    {
+        lanes.y[i][lane] = next[i];
+        lanes.stages[0][i][lane] = lanes.stages[6][i][lane];
+    }
+    lanes.time[lane] = lanes.isLast[lane] == true ? lanes.end[lane] : lanes.time[lane] + h;
+
+    double scale = error > 0.0 ? std::min(DormandPrince::MAX_SCALE, DormandPrince::SAFETY * std::pow(error, -0.2)) :
+        DormandPrince::MAX_SCALE;
+    if (lanes.isRejected[lane] == true)
+    {
+        scale = std::min(scale, 1.0);
+    }
+    h *= scale;
+    lanes.isRejected[lane] = false;
+
+    if (lanes.isLast[lane] == true)
+    {
+        if (lanes.phase[lane] == PHASE_BOOST && lanes.time[lane] < std::min(GetBurnTime(rocket), rocket.maxFlightTime))
+        {
+            // A bend of the thrust curve, the derivative is still continuous.
+            lanes.end[lane] = GetBoostEnd(rocket, lanes.time[lane]);
+            return true;
+        }
+        if (lanes.phase[lane] != PHASE_BOOST || lanes.time[lane] >= rocket.maxFlightTime)
+        {
+            result.status = FLIGHT_TIMEOUT;
+            return false;
+        }
+        // Burnout.
+        lanes.y[Flight::MASS][lane] = GetBurnoutMass(rocket);
+        lanes.burning[lane] = 0.0;
+        lanes.thrust[lane] = 0.0;
+        lanes.massFlow[lane] = 0.0;
+        lanes.end[lane] = rocket.maxFlightTime;
+        lanes.phase[lane] = PHASE_COAST;
+        if (lanes.onRail[lane] == 0.0 && lanes.y[Flight::VERTICAL_SPEED][lane] <= 0.0)
+        {
+            OpenParachute(lanes, lane, rocket);
+        }
+        lanes.isStale[lane] = true;
+    }
+    return true;
+}
+
+/**
+ * @brief   Simulate the flights, L::COUNT at a time.
+ * @retval  The number of derivative evaluations of the flights.
+ */
+template <typename L>
+size_t SimulateLanes(const RocketParameters* rockets, FlightResult* results, size_t count)
+{
+    static constexpr size_t N = L::COUNT;
+    Lanes<L> lanes;
+    // The lanes left empty still compute, on a harmless state.
+    for (size_t lane = 0; lane < N; lane++)
+    {
+        lanes.y[Flight::MASS][lane] = 1.0;
+        lanes.step[lane] = INITIAL_STEP;
+        lanes.rail[2][lane] = 1.0;
+    }
+
+    size_t nextFlight = 0;
+    size_t activeCount = 0;
+    size_t evaluations = 0;
+    // Fill the lane with the next flight that can lift off.
+    auto fill = [&](size_t lane)
+    {
+        lanes.isActive[lane] = false;
+        while (nextFlight < count && lanes.isActive[lane] == false)
+        {
+            const size_t flight = nextFlight++;
+            lanes.isActive[lane] = Launch(lanes, lane, rockets[flight], flight);
+            if (lanes.isActive[lane] == false)
+            {
+                results[flight] = lanes.result[lane];
+            }
+        }
+        activeCount += lanes.isActive[lane] == true ? 1 : 0;
+    };
+    for (size_t lane = 0; lane < N; lane++)
+    {
+        fill(lane);
+    }
+
+    while (activeCount > 0)
+    {
+        if (std::any_of(std::begin(lanes.isStale), std::end(lanes.isStale), [](bool isStale) { return isStale; }) == true)
+        {
+            evaluations += Refresh(lanes);
+        }
+        for (size_t lane = 0; lane < N; lane++)
+        {
+            if (lanes.isActive[lane] == true)
+            {
+                const double remaining = lanes.end[lane] - lanes.time[lane];
+                // The last step ends exactly at end, and is stretched rather than leaving a sliver after it.
+                lanes.isLast[lane] = lanes.step[lane] >= remaining * 0.99;
+                lanes.step[lane] = lanes.isLast[lane] == true ? remaining : lanes.step[lane];
+            }
+        }
+        TryStep(lanes);
+        evaluations += 6 * activeCount;
+
+        for (size_t lane = 0; lane < N; lane++)
+        {
+            if (lanes.isActive[lane] == true && Advance(lanes, lane, rockets[lanes.flight[lane]]) == false)
+            {
+                results[lanes.flight[lane]] = lanes.result[lane];
+                activeCount--;
+                fill(lane);
+            }
+        }
+    }
+    return evaluations;
+}
+}
+}
@@ -0,0 +1,112 @@
+#include "simulation/BatchFlight.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+// Everything after, the kernel included, is compiled for SSE2. MSVC lets any function use any intrinsic.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC target("sse2")
+#endif
+
+namespace Simulation::BatchFlight
+{
+namespace
+{
+struct Sse2Real
+{
+    __m128d v;
+};
+
+inline Sse2Real operator+(Sse2Real a, Sse2Real b)
+{
+    return { _mm_add_pd(a.v, b.v) };
+}
+inline Sse2Real operator-(Sse2Real a, Sse2Real b)
+{
+    return { _mm_sub_pd(a.v, b.v) };
+}
+inline Sse2Real operator*(Sse2Real a, Sse2Real b)
+{
+    return { _mm_mul_pd(a.v, b.v) };
+}
+inline Sse2Real operator/(Sse2Real a, Sse2Real b)
+{
+    return { _mm_div_pd(a.v, b.v) };
+}
+
+struct Sse2Lanes
+{
+    static constexpr size_t COUNT = 2;
+    using Real = Sse2Real;
+    using Mask = __m128d;
+
+    static inline Real Set(double value)
+    {
+        return { _mm_set1_pd(value) };
+    }
+    static inline Real Load(const double* values)
+    {
+        return { _mm_load_pd(values) };
+    }
+    static inline void Store(double* values, Real value)
+    {
+        _mm_store_pd(values, value.v);
+    }
+    static inline Real Sqrt(Real value)
+    {
+        return { _mm_sqrt_pd(value.v) };
+    }
+    static inline Real Min(Real a, Real b)
+    {
+        return { _mm_min_pd(a.v, b.v) };
+    }
+    static inline Real Max(Real a, Real b)
+    {
+        return { _mm_max_pd(a.v, b.v) };
+    }
+    static inline Mask Less(Real a, Real b)
+    {
+        return _mm_cmplt_pd(a.v, b.v);
+    }
+    static inline Mask LessEqual(Real a, Real b)
+    {
+        return _mm_cmple_pd(a.v, b.v);
+    }
+    static inline Mask Or(Mask a, Mask b)
+    {
+        return _mm_or_pd(a, b);
+    }
+    static inline Real Select(Mask mask, Real a, Real b)
+    {
+        return { _mm_or_pd(_mm_and_pd(mask, a.v), _mm_andnot_pd(mask, b.v)) };
+    }
+    static inline Real Truncate(Real value)
+    {
+        return { _mm_cvtepi32_pd(_mm_cvttpd_epi32(value.v)) };
+    }
+    static inline Real Gather(const double* table, Real indices)
+    {
+        const __m128i index = _mm_cvttpd_epi32(indices.v);
+        return { _mm_set_pd(table[_mm_cvtsi128_si32(_mm_shuffle_epi32(index, 1))], table[_mm_cvtsi128_si32(index)]) };
+    }
+};
+}
+}
+
+#include "simulation/BatchFlightKernel.h"
+
+namespace Simulation::BatchFlight
+{
+size_t SimulateSse2(const RocketParameters* rockets, FlightResult* results, size_t count)
+{
+    return SimulateLanes<Sse2Lanes>(rockets, results, count);
+}
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#endif
+#endif
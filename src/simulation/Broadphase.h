@@ -0,0 +1,65 @@
+#pragma once
+#include "utils/rendering/Bvh.h"
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace Simulation
+{
+/**
+ * Two proxies whose bounds overlap, the lowest id first.
+ */
+typedef std::pair<unsigned int, unsigned int> ProxyPair;
+
+inline ProxyPair MakeProxyPair(unsigned int a, unsigned int b)
+{
+    return a < b ? ProxyPair(a, b) : ProxyPair(b, a);
+}
+
+inline uint64_t GetPairKey(const ProxyPair& pair)
+{
+    return (uint64_t(pair.first) << 32) | pair.second;
+}
+
+inline ProxyPair GetKeyPair(uint64_t key)
+{
+    return ProxyPair((unsigned int)(key >> 32), (unsigned int)(key & 0xFFFFFFFF));
+}
+
+typedef enum
+{
+    BROADPHASE_SWEEP_AND_PRUNE = 0,
+    BROADPHASE_UNIFORM_GRID,
+} BroadphaseType_t;
+
+/**
+ * @class   Broadphase
+ * @brief   Finds the pairs of proxies (bounding boxes) that overlap, without testing every pair.
+ *          Proxies are identified by ids chosen by the caller, e.g. the index of their object.
+ *          Proxies are added, moved and removed during a frame, then UpdatePairs reports how
+ *          the set of overlapping pairs changed since the previous frame.
+ *          Touching boxes overlap, like Aabb::Overlaps.
+ */
+class Broadphase
+{
+public:
+    virtual ~Broadphase() = default;
+
+    virtual void AddProxy(unsigned int id, const Renderer::Aabb& bounds) = 0;
+    virtual void MoveProxy(unsigned int id, const Renderer::Aabb& bounds) = 0;
+    virtual void RemoveProxy(unsigned int id) = 0;
+
+    /**
+     * @brief   Finish the frame and list the pairs that started and stopped overlapping since the last call.
+     *          A pair that started and stopped overlapping within the frame isn't listed.
+     * @param   added: Filled with the new pairs, sorted.
+     * @param   removed: Filled with the pairs that don't overlap anymore, sorted.
+     */
+    virtual void UpdatePairs(std::vector<ProxyPair>& added, std::vector<ProxyPair>& removed) = 0;
+
+    /**
+     * @brief   Get every overlapping pair as of the last UpdatePairs, sorted.
+     */
+    virtual void GetPairs(std::vector<ProxyPair>& out) const = 0;
+};
+}
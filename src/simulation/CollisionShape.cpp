@@ -0,0 +1,84 @@
+#include "CollisionShape.h"
+#include "utils/rendering/VertexTransform.h"
+
+namespace Simulation
+{
+CollisionShape::CollisionShape(std::shared_ptr<const Renderer::MeshGeometry> geometry) : m_geometry(std::move(geometry))
+{
+    const Array<ImVec2>& vertices = m_geometry->Vertices();
+    const Array<unsigned int>& indices = m_geometry->Indices();
+    const size_t triangleCount = m_geometry->TriangleCount();
+
+    std::vector<Renderer::Aabb> bounds(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        for (int v = 0; v < 3; v++)
+        {
+            bounds[t].Add(vertices[indices[(t * 3) + v]]);
+        }
+    }
+    std::vector<unsigned int> order;
+    m_bvh = Renderer::Bvh::Build(bounds, LEAF_SIZE, order);
+
+    // One batch per leaf, the unused lanes repeat the leaf's last triangle.
+    const Array<Renderer::BvhNode>& nodes = m_bvh.Nodes();
+    m_nodeBatches.assign(nodes.size(), 0);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        if (nodes[i].IsLeaf() == false)
+        {
+            continue;
+        }
+        m_nodeBatches[i] = (unsigned int)m_batches.size();
+        TriangleBatch batch = {};
+        batch.count = nodes[i].count;
+        for (unsigned int lane = 0; lane < 4; lane++)
+        {
+            batch.triangle[lane] = order[nodes[i].first + (lane < batch.count ? lane : batch.count - 1)];
+        }
+        m_batches.push_back(batch);
+    }
+}
+
+void CollisionShape::SetTransform(const Renderer::Transform& transform)
+{
+    if (m_isPlaced == true && transform == m_transform)
+    {
+        return;
+    }
+    m_transform = transform;
+    m_isPlaced = true;
+
+    const Array<ImVec2>& vertices = m_geometry->Vertices();
+    const Array<unsigned int>& indices = m_geometry->Indices();
+    m_vertices.resize(vertices.size());
+    Renderer::VertexTransform::Apply(transform, vertices.data(), m_vertices.data(), vertices.size());
+
+    for (TriangleBatch& batch : m_batches)
+    {
+        for (unsigned int lane = 0; lane < 4; lane++)
+        {
+            for (int v = 0; v < 3; v++)
+            {
+                const ImVec2& p = m_vertices[indices[(batch.triangle[lane] * 3) + v]];
+                batch.x[v][lane] = p.x;
+                batch.y[v][lane] = p.y;
+            }
+        }
+    }
+
+    m_bvh.Refit([this](const Renderer::BvhNode& leaf)
+                {
+                    const TriangleBatch& batch = m_batches[m_nodeBatches[&leaf - m_bvh.Nodes().data()]];
+                    Renderer::Aabb bounds;
+                    for (unsigned int lane = 0; lane < batch.count; lane++)
+                    {
+                        for (int v = 0; v < 3; v++)
+                        {
+                            bounds.Add(ImVec2(batch.x[v][lane], batch.y[v][lane]));
+                        }
+                    }
+                    return bounds;
+                });
+}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "simulation/TriangleTest.h"
+#include "utils/rendering/Bvh.h"
+#include "utils/rendering/MeshGeometry.h"
+#include "utils/rendering/Transform.h"
+#include <memory>
+#include <vector>
+
+namespace Simulation
+{
+/**
+ * @class   CollisionShape
+ * @brief   The triangles of a collision mesh placed in the world, under a bounding volume hierarchy
+ *          with up to LEAF_SIZE triangles per leaf, for exact collision tests.
+ *          The hierarchy is built once, in mesh coordinates, and shared by the copies of a shape.
+ *          Placing a shape transforms its vertices and refits the bounds of the copied hierarchy,
+ *          which keeps its structure: a transform never requires a rebuild.
+ *          The triangles of each leaf are stored as a TriangleBatch, ready for TriangleTest.
+ */
+class CollisionShape
+{
+public:
+    static constexpr unsigned int LEAF_SIZE = 4;
+
+    CollisionShape() = default;
+    /**
+     * @brief   Build the hierarchy of a geometry's triangles.
+     */
+    explicit CollisionShape(std::shared_ptr<const Renderer::MeshGeometry> geometry);
+
+    /**
+     * @brief   Place the shape in the world. Nothing is done if the transform didn't change.
+     * @param   transform: From mesh to world coordinates.
+     */
+    void SetTransform(const Renderer::Transform& transform);
+
+    /**
+     * @brief   Get the hierarchy, in world coordinates.
+     */
+    inline const Renderer::Bvh& GetBvh() const
+    {
+        return m_bvh;
+    }
+    /**
+     * @brief   Get the triangles of a leaf of the hierarchy, in world coordinates.
+     */
+    inline const TriangleBatch& GetBatch(unsigned int leaf) const
+    {
+        return m_batches[m_nodeBatches[leaf]];
+    }
+    inline const std::shared_ptr<const Renderer::MeshGeometry>& Geometry() const
+    {
+        return m_geometry;
+    }
+
+private:
+    std::shared_ptr<const Renderer::MeshGeometry> m_geometry = nullptr;
+    Renderer::Bvh m_bvh = Renderer::Bvh();
+    std::vector<unsigned int> m_nodeBatches = std::vector<unsigned int>();  //!< For every leaf node, the index of its batch.
+    std::vector<TriangleBatch> m_batches = std::vector<TriangleBatch>();
+    std::vector<ImVec2> m_vertices = std::vector<ImVec2>();                 //!< Vertices in world coordinates.
+    Renderer::Transform m_transform = Renderer::Transform();
+    bool m_isPlaced = false;
+};
+}
@@ -0,0 +1,123 @@
+#include "CollisionWorld.h"
+#include "simulation/SweepAndPrune.h"
+#include "simulation/UniformGrid.h"
+#include "utils/JobSystem.h"
+
+namespace Simulation
+{
+static inline bool IsSameBounds(const Renderer::Aabb& a, const Renderer::Aabb& b)
+{
+    return a.min.x == b.min.x && a.min.y == b.min.y && a.max.x == b.max.x && a.max.y == b.max.y;
+}
+
+CollisionWorld::CollisionWorld(BroadphaseType_t type) : m_type(type), m_broadphase(MakeBroadphase(type, 0.0f))
+{
+}
+
+CollisionWorld::CollisionWorld(const CollisionWorld& other)
+{
+    *this = other;
+}
+
+CollisionWorld& CollisionWorld::operator=(const CollisionWorld& other)
+{
+    if (this != &other)
+    {
+        // The broadphase is rebuilt from the bounds rather than copied.
+        m_type = other.m_type;
+        m_cellSize = other.m_cellSize;
+        m_broadphase = MakeBroadphase(m_type, m_cellSize);
+        m_bounds = other.m_bounds;
+        for (unsigned int id = 0; id < m_bounds.size(); id++)
+        {
+            if (m_bounds[id].IsEmpty() == false)
+            {
+                m_broadphase->AddProxy(id, m_bounds[id]);
+            }
+        }
+        m_broadphase->UpdatePairs(m_added, m_removed);
+        m_added = other.m_added;
+        m_removed = other.m_removed;
+        m_pairs = other.m_pairs;
+    }
+    return *this;
+}
+
+void CollisionWorld::SetBroadphase(BroadphaseType_t type, float cellSize)
+{
+    m_type = type;
+    m_cellSize = cellSize;
+    m_broadphase = MakeBroadphase(type, cellSize);
+    for (unsigned int id = 0; id < m_bounds.size(); id++)
+    {
+        if (m_bounds[id].IsEmpty() == false)
+        {
+            m_broadphase->AddProxy(id, m_bounds[id]);
+        }
+    }
+    // The new broadphase finds the same pairs, none of them are new.
+    m_broadphase->UpdatePairs(m_added, m_removed);
+    m_added.clear();
+    m_removed.clear();
+}
+
+void CollisionWorld::Update(const EntityStore& entities)
+{
+    const size_t count = entities.IndexCount() > m_bounds.size() ? entities.IndexCount() : m_bounds.size();
+    m_nextBounds.assign(count, Renderer::Aabb());
+    // Every entity writes its own bounds, so the rows are split among jobs.
+    entities.ForEach(ENTITY_COLLIDABLE, [this](const Archetype& archetype)
+                     {
+                         Jobs::ParallelFor(archetype.Size(), BOUNDS_GRAIN, [&](size_t begin, size_t end)
+                                           {
+                                               for (size_t row = begin; row < end; row++)
+                                               {
+                                                   m_nextBounds[archetype.indices[row]] =
+                                                       archetype.bodies[row].GetSweptBounds(archetype.positions[row], archetype.previousPositions[row]);
+                                               }
+                                           });
+                     });
+
+    m_bounds.resize(count);
+    for (unsigned int id = 0; id < count; id++)
+    {
+        const Renderer::Aabb& bounds = m_nextBounds[id];
+        const Renderer::Aabb& previous = m_bounds[id];
+        if (bounds.IsEmpty() == true)
+        {
+            if (previous.IsEmpty() == false)
+            {
+                m_broadphase->RemoveProxy(id);
+            }
+        }
+        else if (previous.IsEmpty() == true)
+        {
+            m_broadphase->AddProxy(id, bounds);
+        }
+        else if (IsSameBounds(bounds, previous) == false)
+        {
+            m_broadphase->MoveProxy(id, bounds);
+        }
+    }
+    m_bounds.swap(m_nextBounds);
+    m_bounds.resize(entities.IndexCount());
+
+    m_broadphase->UpdatePairs(m_added, m_removed);
+    if (m_added.empty() == false || m_removed.empty() == false)
+    {
+        m_broadphase->GetPairs(m_pairs);
+    }
+}
+
+std::unique_ptr<Broadphase> CollisionWorld::MakeBroadphase(BroadphaseType_t type, float cellSize)
+{
+    switch (type)
+    {
+        case BROADPHASE_UNIFORM_GRID:
+            return std::make_unique<UniformGrid>(cellSize > 0.0f ? cellSize : UniformGrid::DEFAULT_CELL_SIZE);
+        case BROADPHASE_SWEEP_AND_PRUNE:
+        default:
+            return std::make_unique<SweepAndPrune>();
+    }
+}
+}
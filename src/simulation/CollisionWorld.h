@@ -0,0 +1,81 @@
+#pragma once
+#include "simulation/Broadphase.h"
+#include "simulation/EntityStore.h"
+#include <memory>
+#include <vector>
+
+namespace Simulation
+{
+/**
+ * @class   CollisionWorld
+ * @brief   Tracks the bounds of the collidable entities of a world and the pairs of entities
+ *          whose bounds overlap, the candidates for exact collision tests.
+ *          The bounds are swept over the last step, so the pairs include whatever a fast entity
+ *          passed by during the step, not only what it overlaps at its end.
+ *          Entities are identified by their index. Only the entities whose bounds changed are
+ *          moved in the broadphase, and the pairs are updated incrementally from step to step.
+ *          The broadphase can be swapped at any time without changing the pairs.
+ */
+class CollisionWorld
+{
+public:
+    static constexpr size_t BOUNDS_GRAIN = 4096;    //!< Entities whose bounds are computed per job.
+
+    explicit CollisionWorld(BroadphaseType_t type = BROADPHASE_SWEEP_AND_PRUNE);
+    CollisionWorld(const CollisionWorld& other);
+    CollisionWorld& operator=(const CollisionWorld& other);
+    CollisionWorld(CollisionWorld&& other) = default;
+    CollisionWorld& operator=(CollisionWorld&& other) = default;
+
+    /**
+     * @brief   Replace the broadphase, moving every proxy over.
+     * @param   cellSize: Cell size of a uniform grid, 0 for its default.
+     */
+    void SetBroadphase(BroadphaseType_t type, float cellSize = 0.0f);
+    inline BroadphaseType_t GetBroadphaseType() const
+    {
+        return m_type;
+    }
+
+    /**
+     * @brief   Update the bounds of every entity and the overlapping pairs.
+     *          Entities that aren't collidable, or have no collision geometry, have no proxy.
+     */
+    void Update(const EntityStore& entities);
+
+    /**
+     * @brief   Get the pairs of entities whose bounds started overlapping during the last Update, sorted.
+     */
+    inline const std::vector<ProxyPair>& AddedPairs() const
+    {
+        return m_added;
+    }
+    /**
+     * @brief   Get the pairs of entities whose bounds stopped overlapping during the last Update, sorted.
+     */
+    inline const std::vector<ProxyPair>& RemovedPairs() const
+    {
+        return m_removed;
+    }
+    /**
+     * @brief   Get every pair of entities whose bounds overlap, sorted.
+     */
+    inline const std::vector<ProxyPair>& Pairs() const
+    {
+        return m_pairs;
+    }
+
+private:
+    static std::unique_ptr<Broadphase> MakeBroadphase(BroadphaseType_t type, float cellSize);
+
+private:
+    BroadphaseType_t m_type = BROADPHASE_SWEEP_AND_PRUNE;
+    float m_cellSize = 0.0f;
+    std::unique_ptr<Broadphase> m_broadphase;
+    std::vector<Renderer::Aabb> m_bounds = std::vector<Renderer::Aabb>();   //!< Bounds of every entity, empty when it has no proxy.
+    std::vector<Renderer::Aabb> m_nextBounds = std::vector<Renderer::Aabb>(); //!< Scratch, bounds of the update.
+    std::vector<ProxyPair> m_added = std::vector<ProxyPair>();
+    std::vector<ProxyPair> m_removed = std::vector<ProxyPair>();
+    std::vector<ProxyPair> m_pairs = std::vector<ProxyPair>();
+};
+}
@@ -0,0 +1,207 @@
+#include "ContinuousCollision.h"
+#include <float.h>
+#include <math.h>
+
+namespace Simulation
+{
+static inline float GetArea(const Renderer::Aabb& bounds)
+{
+    return (bounds.max.x - bounds.min.x) * (bounds.max.y - bounds.min.y);
+}
+
+/**
+ * Narrow [enter, leave] to the times at which an interval moving by speed overlaps a still one.
+ * @retval  False if they never overlap during [enter, leave].
+ */
+static inline bool SweepInterval(float minA, float maxA, float minB, float maxB, float speed, float& enter, float& leave)
+{
+    if (speed == 0.0f)
+    {
+        return maxA >= minB && minA <= maxB;
+    }
+    float t0 = (minB - maxA) / speed;
+    float t1 = (maxB - minA) / speed;
+    if (t0 > t1)
+    {
+        const float t = t0;
+        t0 = t1;
+        t1 = t;
+    }
+    enter = t0 > enter ? t0 : enter;
+    leave = t1 < leave ? t1 : leave;
+    return enter <= leave;
+}
+
+/**
+ * Get the first time in [0..1] at which bounds moving by motion, and ending at a, overlap b.
+ * @retval  FLT_MAX if they never do.
+ */
+static inline float GetEntryTime(const Renderer::Aabb& a, const ImVec2& motion, const Renderer::Aabb& b)
+{
+    float enter = 0.0f;
+    float leave = 1.0f;
+    if (SweepInterval(a.min.x - motion.x, a.max.x - motion.x, b.min.x, b.max.x, motion.x, enter, leave) == false ||
+        SweepInterval(a.min.y - motion.y, a.max.y - motion.y, b.min.y, b.max.y, motion.y, enter, leave) == false)
+    {
+        return FLT_MAX;
+    }
+    return enter;
+}
+
+void ContinuousCollision::Update(EntityStore& entities, const std::vector<ProxyPair>& pairs, Narrowphase& narrowphase, float dt)
+{
+    m_impacts.clear();
+    m_impactIndices.assign(entities.IndexCount(), NO_IMPACT);
+    for (const ProxyPair& pair : pairs)
+    {
+        const bool isFastA = IsFast(entities, pair.first, dt);
+        const bool isFastB = IsFast(entities, pair.second, dt);
+        if (isFastA == false && isFastB == false)
+        {
+            continue;
+        }
+
+        // Sweep a along the motion relative to b.
+        const ImVec2& a = entities.Position(pair.first);
+        const ImVec2& previousA = entities.PreviousPosition(pair.first);
+        const ImVec2& b = entities.Position(pair.second);
+        const ImVec2& previousB = entities.PreviousPosition(pair.second);
+        const ImVec2 motion = ImVec2((a.x - previousA.x) - (b.x - previousB.x), (a.y - previousA.y) - (b.y - previousB.y));
+        float toi = 0.0f;
+        ImVec2 normal = ImVec2();
+        if (FindTimeOfImpact(narrowphase.GetShape(entities, pair.first), motion,
+                             narrowphase.GetShape(entities, pair.second), toi, normal) == false)
+        {
+            continue;
+        }
+
+        // Stop short of the impact, by IMPACT_SLOP along the relative motion.
+        const float length = sqrtf((motion.x * motion.x) + (motion.y * motion.y));
+        toi = length > 0.0f ? toi - (IMPACT_SLOP / length) : 0.0f;
+        toi = toi > 0.0f ? toi : 0.0f;
+        if (isFastA == true)
+        {
+            AddImpact(pair.first, pair.second, toi, normal);
+        }
+        if (isFastB == true)
+        {
+            AddImpact(pair.second, pair.first, toi, ImVec2(-normal.x, -normal.y));
+        }
+    }
+
+    for (const Impact& impact : m_impacts)
+    {
+        const ImVec2 from = entities.PreviousPosition(impact.entity);
+        const ImVec2 to = entities.Position(impact.entity);
+        entities.Position(impact.entity, ImVec2(from.x + ((to.x - from.x) * impact.time), from.y + ((to.y - from.y) * impact.time)));
+
+        const ImVec2 velocity = entities.Velocity(impact.entity);
+        const float closing = (velocity.x * impact.normal.x) + (velocity.y * impact.normal.y);
+        if (closing > 0.0f)
+        {
+            entities.Velocity(impact.entity, ImVec2(velocity.x - (impact.normal.x * closing), velocity.y - (impact.normal.y * closing)));
+        }
+    }
+}
+
+bool ContinuousCollision::FindTimeOfImpact(const CollisionShape& a, const ImVec2& motion, const CollisionShape& b,
+                                           float& toi, ImVec2& normal)
+{
+    const Array<Renderer::BvhNode>& nodesA = a.GetBvh().Nodes();
+    const Array<Renderer::BvhNode>& nodesB = b.GetBvh().Nodes();
+    if (nodesA.empty() == true || nodesB.empty() == true)
+    {
+        return false;
+    }
+
+    bool isHit = false;
+    toi = 1.0f;
+    m_stack.clear();
+    m_stack.emplace_back(0, 0);
+    while (m_stack.empty() == false)
+    {
+        const std::pair<unsigned int, unsigned int> visit = m_stack.back();
+        m_stack.pop_back();
+        const Renderer::BvhNode& nodeA = nodesA[visit.first];
+        const Renderer::BvhNode& nodeB = nodesB[visit.second];
+        // Nothing in these nodes can be hit before the earliest impact found so far.
+        if (GetEntryTime(nodeA.bounds, motion, nodeB.bounds) > toi)
+        {
+            continue;
+        }
+
+        if (nodeA.IsLeaf() == true && nodeB.IsLeaf() == true)
+        {
+            const TriangleBatch& batchA = a.GetBatch(visit.first);
+            const TriangleBatch& batchB = b.GetBatch(visit.second);
+            for (unsigned int lane = 0; lane < batchA.count; lane++)
+            {
+                // The triangles are placed at the end of the motion, start them at its beginning.
+                const ImVec2 tri[3] = { ImVec2(batchA.x[0][lane] - motion.x, batchA.y[0][lane] - motion.y),
+                                        ImVec2(batchA.x[1][lane] - motion.x, batchA.y[1][lane] - motion.y),
+                                        ImVec2(batchA.x[2][lane] - motion.x, batchA.y[2][lane] - motion.y) };
+                float times[4];
+                ImVec2 normals[4];
+                unsigned int mask = TriangleTest::Sweep(tri, motion, batchB, times, normals);
+                for (unsigned int other = 0; mask != 0; other++, mask >>= 1)
+                {
+                    if ((mask & 1) != 0 && (isHit == false || times[other] < toi))
+                    {
+                        isHit = true;
+                        toi = times[other];
+                        normal = normals[other];
+                    }
+                }
+            }
+        }
+        else if (nodeB.IsLeaf() == true || (nodeA.IsLeaf() == false && GetArea(nodeA.bounds) >= GetArea(nodeB.bounds)))
+        {
+            m_stack.emplace_back(nodeA.first + 1, visit.second);
+            m_stack.emplace_back(nodeA.first, visit.second);
+        }
+        else
+        {
+            m_stack.emplace_back(visit.first, nodeB.first + 1);
+            m_stack.emplace_back(visit.first, nodeB.first);
+        }
+    }
+    return isHit;
+}
+
+bool ContinuousCollision::IsFast(const EntityStore& entities, unsigned int index, float dt) const
+{
+    if (entities.HasFlags(index, ENTITY_MOVEABLE | ENTITY_COLLIDABLE) == false)
+    {
+        return false;
+    }
+    const Renderer::Aabb bounds = entities.GetBounds(index);
+    if (bounds.IsEmpty() == true)
+    {
+        return false;
+    }
+    const float width = bounds.max.x - bounds.min.x;
+    const float height = bounds.max.y - bounds.min.y;
+    const float size = (width < height ? width : height) * m_motionRatio;
+    const ImVec2& velocity = entities.Velocity(index);
+    return ((velocity.x * velocity.x) + (velocity.y * velocity.y)) * dt * dt > size * size;
+}
+
+void ContinuousCollision::AddImpact(unsigned int entity, unsigned int other, float toi, const ImVec2& normal)
+{
+    unsigned int& index = m_impactIndices[entity];
+    if (index == NO_IMPACT)
+    {
+        index = (unsigned int)m_impacts.size();
+        m_impacts.push_back(Impact());
+    }
+    else if (m_impacts[index].time <= toi)
+    {
+        return;
+    }
+    Impact& impact = m_impacts[index];
+    impact.entity = entity;
+    impact.other = other;
+    impact.time = toi;
+    impact.normal = normal;
+}
+}
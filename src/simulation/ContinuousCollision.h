@@ -0,0 +1,92 @@
+#pragma once
+#include "simulation/Broadphase.h"
+#include "simulation/Narrowphase.h"
+#include "simulation/EntityStore.h"
+#include <vector>
+
+namespace Simulation
+{
+/**
+ * The first thing a fast entity hit during a step.
+ */
+struct Impact
+{
+    unsigned int entity = 0;        //!< The fast entity.
+    unsigned int other = 0;         //!< What it hit.
+    float time = 0.0f;              //!< Fraction of the step at which they touched, in [0..1].
+    ImVec2 normal = ImVec2();       //!< Unit normal at the impact, from the entity towards the other.
+};
+
+/**
+ * @class   ContinuousCollision
+ * @brief   Stops fast entities where they first hit something during a step, instead of letting them
+ *          pass through what they would have overlapped between two steps (tunneling).
+ *          An entity is fast when it moves more than a ratio of its own size in one step. For every
+ *          pair with a fast entity, the collision shapes are swept along their relative motion to find
+ *          their time of impact: the hierarchies are walked together with swept bounds, and the
+ *          triangles of the leaves are tested with TriangleTest::Sweep.
+ *          A fast entity that hits something is moved back to where it was at the time of impact, short
+ *          of IMPACT_SLOP, and loses its velocity into what it hit. Slow entities are left to the
+ *          discrete tests of the Narrowphase.
+ */
+class ContinuousCollision
+{
+public:
+    static constexpr float DEFAULT_MOTION_RATIO = 0.5f;     //!< Entities moving more than half their size per step are fast.
+    static constexpr float IMPACT_SLOP = 0.001f;            //!< Distance kept from what a fast entity hits, in world units.
+
+    /**
+     * @brief   Find the impacts of the fast entities during the last step and stop them there.
+     *          Must be called after the entities are stepped and before the discrete tests.
+     * @param   entities: The entities, stepped from their previous position.
+     * @param   pairs: The pairs whose swept bounds overlap, see CollisionWorld::Pairs.
+     * @param   narrowphase: Provides the entities' collision shapes.
+     * @param   dt: The time step, in seconds.
+     */
+    void Update(EntityStore& entities, const std::vector<ProxyPair>& pairs, Narrowphase& narrowphase, float dt);
+
+    /**
+     * @brief   Find when a shape moving by motion first touches another one that stays still.
+     *          The shapes are placed at the end of the motion.
+     * @param   toi: Set to the time of impact, in [0..1], if they touch.
+     * @param   normal: Set to the unit normal at the impact, from a towards b, if they touch.
+     * @retval  True if the shapes touch during the motion.
+     */
+    bool FindTimeOfImpact(const CollisionShape& a, const ImVec2& motion, const CollisionShape& b,
+                          float& toi, ImVec2& normal);
+
+    /**
+     * @brief   Check if an entity moves more than MotionRatio times its size in a step.
+     *          The size is the smallest side of its bounds, so a thin entity is fast sooner.
+     */
+    bool IsFast(const EntityStore& entities, unsigned int index, float dt) const;
+
+    /**
+     * @brief   Get the first impact of every fast entity that hit something during the last Update.
+     */
+    inline const std::vector<Impact>& Impacts() const
+    {
+        return m_impacts;
+    }
+
+    inline void MotionRatio(float ratio)
+    {
+        m_motionRatio = ratio;
+    }
+    inline float MotionRatio() const
+    {
+        return m_motionRatio;
+    }
+
+private:
+    static constexpr unsigned int NO_IMPACT = 0xFFFFFFFF;
+
+    void AddImpact(unsigned int entity, unsigned int other, float toi, const ImVec2& normal);
+
+private:
+    float m_motionRatio = DEFAULT_MOTION_RATIO;
+    std::vector<Impact> m_impacts = std::vector<Impact>();
+    std::vector<unsigned int> m_impactIndices = std::vector<unsigned int>();   //!< For every entity, its impact in m_impacts or NO_IMPACT.
+    std::vector<std::pair<unsigned int, unsigned int>> m_stack = std::vector<std::pair<unsigned int, unsigned int>>(); //!< Scratch, node pairs to visit.
+};
+}
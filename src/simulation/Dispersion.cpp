@@ -0,0 +1,335 @@
+#include "Dispersion.h"
+#include "simulation/BatchFlight.h"
+#include "simulation/Vector2d.h"
+#include "utils/JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+namespace Simulation
+{
+static constexpr size_t FLIGHT_GRAIN = 16;          //!< Flights simulated per job.
+static constexpr size_t BATCH_GRAIN = 64;           //!< Flights simulated per job when batched, enough to keep 8 lanes refilled.
+static constexpr double PI = 3.14159265358979323846;
+
+/**
+ * A counter-based generator (splitmix64): every draw hashes a key and a counter, so keying it
+ * on a flight costs nothing, unlike seeding the state of a Mersenne twister for every flight.
+ * Its normal draws are its own rather than std::normal_distribution's, whose algorithm is up to
+ * the standard library, so a seed gives the same flights whatever the compiler.
+ */
+class FlightRandom
+{
+public:
+    FlightRandom(unsigned long long seed, size_t flight) : m_key(Mix(Mix(seed) + flight))
+    {
+    }
+
+    inline unsigned long long operator()()
+    {
+        m_counter++;
+        return Mix(m_key + (m_counter * GOLDEN_GAMMA));
+    }
+
+    /**
+     * @brief   Draw from the uniform distribution over [0, 1), from the top 53 bits of a draw.
+     */
+    inline double Uniform()
+    {
+        return double((*this)() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /**
+     * @brief   Draw from the standard normal distribution, with Marsaglia's polar method.
+     *          It makes normal draws two by two, the second is kept for the next call.
+     */
+    inline double Normal()
+    {
+        if (m_hasSpare == true)
+        {
+            m_hasSpare = false;
+            return m_spare;
+        }
+        double u = 0.0;
+        double v = 0.0;
+        double s = 0.0;
+        do
+        {
+            u = (2.0 * Uniform()) - 1.0;
+            v = (2.0 * Uniform()) - 1.0;
+            s = (u * u) + (v * v);
+        } while (s >= 1.0 || s == 0.0);
+        const double factor = std::sqrt((-2.0 * std::log(s)) / s);
+        m_spare = v * factor;
+        m_hasSpare = true;
+        return u * factor;
+    }
+
+private:
+    static constexpr unsigned long long GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+    static inline unsigned long long Mix(unsigned long long z)
+    {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+private:
+    unsigned long long m_key = 0;
+    unsigned long long m_counter = 0;
+    double m_spare = 0.0;       //!< The second normal draw of the last pair.
+    bool m_hasSpare = false;
+};
+
+/**
+ * The covariance of landing points, and the squared distance to their center, in standard
+ * deviations, of the ellipse that holds a confidence of them.
+ */
+struct LandingFit
+{
+    Vector2d center = Vector2d();       //!< East, north.
+    double eastEast = 0.0;
+    double northNorth = 0.0;
+    double eastNorth = 0.0;
+    double determinant = 0.0;           //!< Of the covariance, 0 when the landings have no ellipse.
+    double squaredScale = 0.0;
+
+    /**
+     * @brief   Get the squared (Mahalanobis) distance of a landing to the center, in standard deviations.
+     */
+    inline double SquaredDistance(const Vector2d& landing) const
+    {
+        const double east = landing.x - center.x;
+        const double north = landing.y - center.y;
+        return ((northNorth * east * east) - (2.0 * eastNorth * east * north) + (eastEast * north * north)) / determinant;
+    }
+};
+
+static DistributionSummary Summarize(std::vector<double>& values);
+static LandingFit FitLandings(const std::vector<Vector2d>& landings, size_t first, size_t stride, double confidence);
+static LandingEllipse FitEllipse(const std::vector<FlightResult>& flights, double confidence);
+
+DispersionReport RunDispersion(const DispersionParameters& parameters)
+{
+    DispersionReport report;
+    report.flights.resize(parameters.flightCount);
+    std::atomic<size_t> evaluationCount = { 0 };
+
+    const auto start = std::chrono::steady_clock::now();
+    FlightResult* flights = report.flights.data();
+    if (parameters.isBatched == true)
+    {
+        Jobs::ParallelFor(parameters.flightCount, BATCH_GRAIN, [&parameters, &evaluationCount, flights](size_t begin, size_t end)
+                          {
+                              thread_local std::vector<RocketParameters> rockets;
+                              rockets.clear();
+                              for (size_t i = begin; i < end; i++)
+                              {
+                                  rockets.push_back(DrawRocket(parameters, i));
+                              }
+                              evaluationCount += BatchFlight::Simulate(rockets.data(), flights + begin, rockets.size());
+                          });
+    }
+    else
+    {
+        Jobs::ParallelFor(parameters.flightCount, FLIGHT_GRAIN, [&parameters, &evaluationCount, flights](size_t begin, size_t end)
+                          {
+                              thread_local Flight flight;
+                              size_t evaluations = 0;
+                              for (size_t i = begin; i < end; i++)
+                              {
+                                  flights[i] = flight.Simulate(DrawRocket(parameters, i));
+                                  evaluations += flight.EvaluationCount();
+                              }
+                              evaluationCount += evaluations;
+                          });
+    }
+    report.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    report.evaluationCount = evaluationCount;
+
+    std::vector<double> apogees;
+    std::vector<double> flightTimes;
+    for (const FlightResult& flight : report.flights)
+    {
+        report.statusCounts[flight.status]++;
+        if (flight.status == FLIGHT_LANDED)
+        {
+            apogees.push_back(flight.apogee);
+            flightTimes.push_back(flight.flightTime);
+        }
+    }
+    report.apogee = Summarize(apogees);
+    report.flightTime = Summarize(flightTimes);
+    report.landing = FitEllipse(report.flights, parameters.ellipseConfidence);
+    return report;
+}
+
+const char* GetFlightStatusName(FlightStatus_t status)
+{
+    static const char* names[FLIGHT_STATUS_COUNT] = { "Landed", "No liftoff", "Integration failed", "Timeout" };
+    return status < FLIGHT_STATUS_COUNT ? names[status] : "Unknown";
+}
+
+RocketParameters DrawRocket(const DispersionParameters& parameters, size_t flight)
+{
+    // Every flight has its own generator, keyed on its index, so that which thread runs it doesn't matter.
+    FlightRandom generator = FlightRandom(parameters.seed, flight);
+
+    RocketParameters rocket = parameters.nominal;
+    rocket.thrustScale *= 1.0 + (parameters.thrustScale * generator.Normal());
+    rocket.dryMass *= 1.0 + (parameters.mass * generator.Normal());
+    rocket.dragCoefficient *= 1.0 + (parameters.dragCoefficient * generator.Normal());
+    rocket.launchTilt += parameters.launchTilt * generator.Normal();
+    rocket.launchAzimuth += parameters.launchAzimuth * generator.Normal();
+    rocket.windSpeed = std::max(0.0, rocket.windSpeed + (parameters.windSpeed * generator.Normal()));
+    rocket.windDirection += parameters.windDirection * generator.Normal();
+    return rocket;
+}
+
+static DistributionSummary Summarize(std::vector<double>& values)
+{
+    DistributionSummary summary;
+    if (values.empty() == true)
+    {
+        return summary;
+    }
+    std::sort(values.begin(), values.end());
+    auto getPercentile = [&values](double fraction)
+    {
+        const double position = fraction * double(values.size() - 1);
+        const size_t index = std::min(size_t(position), values.size() - 1);
+        const size_t next = std::min(index + 1, values.size() - 1);
+        return values[index] + ((position - double(index)) * (values[next] - values[index]));
+    };
+
+    double sum = 0.0;
+    for (double value : values)
+    {
+        sum += value;
+    }
+    summary.mean = sum / double(values.size());
+    double squares = 0.0;
+    for (double value : values)
+    {
+        squares += (value - summary.mean) * (value - summary.mean);
+    }
+    summary.deviation = values.size() > 1 ? std::sqrt(squares / double(values.size() - 1)) : 0.0;
+    summary.minimum = values.front();
+    summary.maximum = values.back();
+    summary.percentile1 = getPercentile(0.01);
+    summary.median = getPercentile(0.5);
+    summary.percentile99 = getPercentile(0.99);
+    return summary;
+}
+
+/**
+ * @brief   Fit the landings first, first + stride, first + 2 * stride...
+ */
+static LandingFit FitLandings(const std::vector<Vector2d>& landings, size_t first, size_t stride, double confidence)
+{
+    LandingFit fit;
+    size_t count = 0;
+    for (size_t i = first; i < landings.size(); i += stride)
+    {
+        fit.center.x += landings[i].x;
+        fit.center.y += landings[i].y;
+        count++;
+    }
+    if (count < 2)
+    {
+        return fit;
+    }
+    fit.center.x /= double(count);
+    fit.center.y /= double(count);
+
+    for (size_t i = first; i < landings.size(); i += stride)
+    {
+        const double east = landings[i].x - fit.center.x;
+        const double north = landings[i].y - fit.center.y;
+        fit.eastEast += east * east;
+        fit.northNorth += north * north;
+        fit.eastNorth += east * north;
+    }
+    fit.eastEast /= double(count - 1);
+    fit.northNorth /= double(count - 1);
+    fit.eastNorth /= double(count - 1);
+
+    // Landings on a line have no ellipse.
+    const double determinant = (fit.eastEast * fit.northNorth) - (fit.eastNorth * fit.eastNorth);
+    if (determinant <= 0.0)
+    {
+        return fit;
+    }
+    fit.determinant = determinant;
+
+    // The landings aren't normally distributed, so the axes aren't scaled by a quantile of the
+    // chi-squared distribution but by the confidence quantile of the landings' own squared
+    // distances to the center.
+    std::vector<double> distances;
+    distances.reserve(count);
+    for (size_t i = first; i < landings.size(); i += stride)
+    {
+        distances.push_back(fit.SquaredDistance(landings[i]));
+    }
+    const double rank = std::ceil(std::max(0.0, std::min(confidence, 1.0)) * double(count));
+    const size_t quantile = std::min(size_t(std::max(rank, 1.0)) - 1, count - 1);
+    std::nth_element(distances.begin(), distances.begin() + quantile, distances.end());
+    fit.squaredScale = distances[quantile];
+    return fit;
+}
+
+static LandingEllipse FitEllipse(const std::vector<FlightResult>& flights, double confidence)
+{
+    LandingEllipse ellipse;
+    std::vector<Vector2d> landings;
+    for (const FlightResult& flight : flights)
+    {
+        if (flight.status == FLIGHT_LANDED)
+        {
+            landings.push_back(Vector2d(flight.landingEast, flight.landingNorth));
+        }
+    }
+    const LandingFit fit = FitLandings(landings, 0, 1, confidence);
+    if (fit.determinant <= 0.0)
+    {
+        return ellipse;
+    }
+    ellipse.centerEast = fit.center.x;
+    ellipse.centerNorth = fit.center.y;
+
+    // The axes are along the eigenvectors of the covariance.
+    const double scale = std::sqrt(fit.squaredScale);
+    const double halfTrace = 0.5 * (fit.eastEast + fit.northNorth);
+    const double spread = std::sqrt((0.25 * (fit.eastEast - fit.northNorth) * (fit.eastEast - fit.northNorth)) + (fit.eastNorth * fit.eastNorth));
+    ellipse.semiMajorAxis = scale * std::sqrt(halfTrace + spread);
+    ellipse.semiMinorAxis = scale * std::sqrt(std::max(halfTrace - spread, 0.0));
+    const double angleFromEast = 0.5 * std::atan2(2.0 * fit.eastNorth, fit.eastEast - fit.northNorth) * (180.0 / PI);
+    ellipse.orientation = std::fmod(90.0 - angleFromEast + 180.0, 180.0);
+
+    // The ellipse holds the confidence of the landings it was sized on by construction, so it's
+    // checked on landings it never saw: fit on every other landing and count the others, both ways.
+    size_t contained = 0;
+    for (size_t half = 0; half < 2; half++)
+    {
+        const LandingFit halfFit = FitLandings(landings, half, 2, confidence);
+        if (halfFit.determinant <= 0.0)
+        {
+            return ellipse;
+        }
+        for (size_t i = 1 - half; i < landings.size(); i += 2)
+        {
+            contained += halfFit.SquaredDistance(landings[i]) <= halfFit.squaredScale ? 1 : 0;
+        }
+    }
+    // The ellipse of m landings passes through the landing of rank k = ceil(confidence m), and holds
+    // k / (m + 1) of the landings it didn't see on average, a little less than the confidence for few.
+    const double halfCount = double(landings.size() / 2);
+    const double rank = std::max(1.0, std::min(std::ceil(std::max(0.0, std::min(confidence, 1.0)) * halfCount), halfCount));
+    ellipse.expectedFraction = rank / (halfCount + 1.0);
+    ellipse.heldOutCount = landings.size();
+    ellipse.containedFraction = double(contained) / double(landings.size());
+    return ellipse;
+}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "simulation/Flight.h"
+#include <vector>
+
+namespace Simulation
+{
+/**
+ * The nominal rocket of a dispersion and how its parameters are scattered: every flight draws
+ * each parameter from a normal distribution centered on the nominal value.
+ */
+struct DispersionParameters
+{
+    RocketParameters nominal = RocketParameters();
+    size_t flightCount = 10000;
+    unsigned long long seed = 1;            //!< The same seed gives the same flights, whatever the thread count.
+    bool isBatched = true;                  //!< Fly the flights of a job side by side in SIMD lanes with BatchFlight, instead of one by one with Flight.
+
+    // Standard deviations.
+    double thrustScale = 0.03;              //!< Relative, of the thrust.
+    double mass = 0.02;                     //!< Relative, of the dry mass.
+    double dragCoefficient = 0.05;          //!< Relative.
+    double launchTilt = 1.0;                //!< Degrees.
+    double launchAzimuth = 5.0;             //!< Degrees.
+    double windSpeed = 1.5;                 //!< m/s, never below 0.
+    double windDirection = 20.0;            //!< Degrees.
+
+    double ellipseConfidence = 0.99;        //!< Fraction of the landings expected in the landing ellipse.
+};
+
+/**
+ * The spread of a scalar over the landed flights.
+ */
+struct DistributionSummary
+{
+    double mean = 0.0;
+    double deviation = 0.0;
+    double minimum = 0.0;
+    double maximum = 0.0;
+    double percentile1 = 0.0;
+    double median = 0.0;
+    double percentile99 = 0.0;
+};
+
+/**
+ * The ellipse that holds ellipseConfidence of the landings, shaped by their covariance. The landing
+ * points aren't normally distributed, so its size comes from the landings themselves: the
+ * ellipse passes through the landing at the confidence quantile of their distances to the center,
+ * in standard deviations.
+ * That makes it hold the confidence of its own landings whatever their distribution, so how much it
+ * really holds is estimated on landings left out of the fit, see containedFraction.
+ */
+struct LandingEllipse
+{
+    double centerEast = 0.0;                //!< m.
+    double centerNorth = 0.0;               //!< m.
+    double semiMajorAxis = 0.0;             //!< m.
+    double semiMinorAxis = 0.0;             //!< m.
+    double orientation = 0.0;               //!< Direction of the major axis, in degrees clockwise from north.
+    double containedFraction = 0.0;         //!< Fraction of the landings inside the ellipse fit without them: fit on every other landing, count the others, and the other way round.
+    double expectedFraction = 0.0;          //!< Fraction of the landings left out that the ellipses fit on the halves are expected to hold.
+    size_t heldOutCount = 0;                //!< Landings containedFraction was counted on, 0 when there were too few to fit the halves.
+};
+
+struct DispersionReport
+{
+    std::vector<FlightResult> flights = std::vector<FlightResult>();
+    size_t statusCounts[FLIGHT_STATUS_COUNT] = {};
+    DistributionSummary apogee = DistributionSummary();
+    DistributionSummary flightTime = DistributionSummary();
+    LandingEllipse landing = LandingEllipse();
+    size_t evaluationCount = 0;             //!< Derivative evaluations of every flight.
+    double milliseconds = 0.0;
+};
+
+/**
+ * @brief   Simulate every flight of a dispersion, spread over the job system, and summarize them.
+ *          Every worker reuses one Flight, or one batch of rockets, for all the flights it runs.
+ */
+DispersionReport RunDispersion(const DispersionParameters& parameters);
+
+/**
+ * @brief   Draw the rocket of one flight of a dispersion, the same for a seed and flight index.
+ */
+RocketParameters DrawRocket(const DispersionParameters& parameters, size_t flight);
+
+const char* GetFlightStatusName(FlightStatus_t status);
+}
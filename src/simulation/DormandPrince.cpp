@@ -0,0 +1,253 @@
+#include "DormandPrince.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Simulation
+{
+using namespace DormandPrinceTableau;
+
+DormandPrince::DormandPrince(size_t dimension)
+{
+    Dimension(dimension);
+}
+
+void DormandPrince::Dimension(size_t dimension)
+{
+    m_dimension = dimension;
+    m_absolute.resize(dimension, DEFAULT_ABSOLUTE_TOLERANCE);
+    m_relative.resize(dimension, DEFAULT_RELATIVE_TOLERANCE);
+    for (std::vector<double>& stage : m_stages)
+    {
+        stage.resize(dimension);
+    }
+    for (std::vector<double>& coefficients : m_dense)
+    {
+        coefficients.resize(dimension);
+    }
+    m_stage.resize(dimension);
+    m_next.resize(dimension);
+    m_error.resize(dimension);
+}
+
+void DormandPrince::Tolerances(const std::vector<double>& absolute, const std::vector<double>& relative)
+{
+    m_absolute = absolute;
+    m_relative = relative;
+    m_absolute.resize(m_dimension, DEFAULT_ABSOLUTE_TOLERANCE);
+    m_relative.resize(m_dimension, DEFAULT_RELATIVE_TOLERANCE);
+}
+
+void DormandPrince::Tolerances(double absolute, double relative)
+{
+    m_absolute.assign(m_dimension, absolute);
+    m_relative.assign(m_dimension, relative);
+}
+
+IntegrationStatus_t DormandPrince::Integrate(const Derivative& f, double& t, double end, double* y,
+                                             const Observer& observer)
+{
+    if (m_dimension == 0 || t == end)
+    {
+        return INTEGRATION_OK;
+    }
+    const double direction = end > t ? 1.0 : -1.0;
+
+    f(t, y, m_stages[0].data());
+    m_evaluationCount++;
+    double h = m_initialStep > 0.0 ? m_initialStep : EstimateInitialStep(f, t, y, direction);
+    if (m_maxStep > 0.0)
+    {
+        h = std::min(h, m_maxStep);
+    }
+
+    bool isRejected = false;
+    for (size_t step = 0; step < m_maxSteps;)
+    {
+        // The last step ends exactly at end, and is stretched rather than leaving a sliver after it.
+        const double remaining = std::abs(end - t);
+        const bool isLast = h >= remaining * 0.99;
+        if (isLast == true)
+        {
+            h = remaining;
+        }
+
+        const double error = TryStep(f, t, y, direction * h);
+        if (!(error <= 1.0))
+        {
+            // Too large, or not finite: retry smaller.
+            m_rejectedCount++;
+            if (h <= m_minStep)
+            {
+                return std::isfinite(error) == true ? INTEGRATION_STEP_TOO_SMALL : INTEGRATION_NOT_FINITE;
+            }
+            const double scale = std::isfinite(error) == true ? std::max(MIN_SCALE, SAFETY * std::pow(error, -0.2)) : MIN_SCALE;
+            h = std::max(h * scale, m_minStep);
+            isRejected = true;
+            continue;
+        }
+
+        // Interpolation coefficients of the step, before y is replaced.
+        const double signedStep = direction * h;
+        const std::vector<double>& k1 = m_stages[0];
+        const std::vector<double>& k3 = m_stages[2];
+        const std::vector<double>& k4 = m_stages[3];
+        const std::vector<double>& k5 = m_stages[4];
+        const std::vector<double>& k6 = m_stages[5];
+        const std::vector<double>& k7 = m_stages[6];
+        for (size_t i = 0; i < m_dimension; i++)
+        {
+            const double difference = m_next[i] - y[i];
+            const double spline = (signedStep * k1[i]) - difference;
+            m_dense[0][i] = y[i];
+            m_dense[1][i] = difference;
+            m_dense[2][i] = spline;
+            m_dense[3][i] = difference - (signedStep * k7[i]) - spline;
+            m_dense[4][i] = signedStep * ((D1 * k1[i]) + (D3 * k3[i]) + (D4 * k4[i]) + (D5 * k5[i]) + (D6 * k6[i]) + (D7 * k7[i]));
+        }
+        m_stepStart = t;
+        m_stepSize = signedStep;
+
+        t = isLast == true ? end : t + signedStep;
+        std::copy(m_next.begin(), m_next.end(), y);
+        // The derivative at the end of this step starts the next one.
+        m_stages[0].swap(m_stages[6]);
+        m_acceptedCount++;
+        step++;
+
+        if (observer && observer(t, y) == false)
+        {
+            return INTEGRATION_STOPPED;
+        }
+        if (isLast == true)
+        {
+            return INTEGRATION_OK;
+        }
+
+        double scale = error > 0.0 ? std::min(MAX_SCALE, SAFETY * std::pow(error, -0.2)) : MAX_SCALE;
+        if (isRejected == true)
+        {
+            // Right after a rejection, growing again would likely be rejected too.
+            scale = std::min(scale, 1.0);
+        }
+        h *= scale;
+        if (m_maxStep > 0.0)
+        {
+            h = std::min(h, m_maxStep);
+        }
+        isRejected = false;
+    }
+    return INTEGRATION_TOO_MANY_STEPS;
+}
+
+void DormandPrince::Interpolate(double t, double* y) const
+{
+    const double theta = m_stepSize != 0.0 ? (t - m_stepStart) / m_stepSize : 0.0;
+    const double theta1 = 1.0 - theta;
+    for (size_t i = 0; i < m_dimension; i++)
+    {
+        y[i] = m_dense[0][i] +
+            (theta * (m_dense[1][i] + (theta1 * (m_dense[2][i] + (theta * (m_dense[3][i] + (theta1 * m_dense[4][i])))))));
+    }
+}
+
+double DormandPrince::TryStep(const Derivative& f, double t, const double* y, double h)
+{
+    const size_t n = m_dimension;
+    double* stage = m_stage.data();
+    const double* k1 = m_stages[0].data();
+    double* k2 = m_stages[1].data();
+    double* k3 = m_stages[2].data();
+    double* k4 = m_stages[3].data();
+    double* k5 = m_stages[4].data();
+    double* k6 = m_stages[5].data();
+    double* k7 = m_stages[6].data();
+
+    for (size_t i = 0; i < n; i++)
+    {
+        stage[i] = y[i] + (h * A21 * k1[i]);
+    }
+    f(t + (C2 * h), stage, k2);
+    for (size_t i = 0; i < n; i++)
+    {
+        stage[i] = y[i] + (h * ((A31 * k1[i]) + (A32 * k2[i])));
+    }
+    f(t + (C3 * h), stage, k3);
+    for (size_t i = 0; i < n; i++)
+    {
+        stage[i] = y[i] + (h * ((A41 * k1[i]) + (A42 * k2[i]) + (A43 * k3[i])));
+    }
+    f(t + (C4 * h), stage, k4);
+    for (size_t i = 0; i < n; i++)
+    {
+        stage[i] = y[i] + (h * ((A51 * k1[i]) + (A52 * k2[i]) + (A53 * k3[i]) + (A54 * k4[i])));
+    }
+    f(t + (C5 * h), stage, k5);
+    for (size_t i = 0; i < n; i++)
+    {
+        stage[i] = y[i] + (h * ((A61 * k1[i]) + (A62 * k2[i]) + (A63 * k3[i]) + (A64 * k4[i]) + (A65 * k5[i])));
+    }
+    f(t + h, stage, k6);
+    for (size_t i = 0; i < n; i++)
+    {
+        m_next[i] = y[i] + (h * ((A71 * k1[i]) + (A73 * k3[i]) + (A74 * k4[i]) + (A75 * k5[i]) + (A76 * k6[i])));
+    }
+    f(t + h, m_next.data(), k7);
+    m_evaluationCount += 6;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        m_error[i] = h * ((E1 * k1[i]) + (E3 * k3[i]) + (E4 * k4[i]) + (E5 * k5[i]) + (E6 * k6[i]) + (E7 * k7[i]));
+    }
+    return GetErrorNorm(y);
+}
+
+double DormandPrince::GetErrorNorm(const double* y) const
+{
+    // Root mean square of the errors, each relative to its tolerance.
+    double sum = 0.0;
+    for (size_t i = 0; i < m_dimension; i++)
+    {
+        const double scale = m_absolute[i] + (m_relative[i] * std::max(std::abs(y[i]), std::abs(m_next[i])));
+        const double ratio = m_error[i] / scale;
+        sum += ratio * ratio;
+    }
+    return std::sqrt(sum / double(m_dimension));
+}
+
+double DormandPrince::EstimateInitialStep(const Derivative& f, double t, const double* y, double direction)
+{
+    // Hairer, Norsett & Wanner, Solving Ordinary Differential Equations I, II.4.
+    const std::vector<double>& f0 = m_stages[0];
+    double stateNorm = 0.0;
+    double derivativeNorm = 0.0;
+    for (size_t i = 0; i < m_dimension; i++)
+    {
+        const double scale = m_absolute[i] + (m_relative[i] * std::abs(y[i]));
+        stateNorm += (y[i] / scale) * (y[i] / scale);
+        derivativeNorm += (f0[i] / scale) * (f0[i] / scale);
+    }
+    stateNorm = std::sqrt(stateNorm / double(m_dimension));
+    derivativeNorm = std::sqrt(derivativeNorm / double(m_dimension));
+    const double h0 = (stateNorm < 1e-5 || derivativeNorm < 1e-5) ? 1e-6 : 0.01 * (stateNorm / derivativeNorm);
+
+    // An explicit Euler step tells how fast the derivative changes.
+    for (size_t i = 0; i < m_dimension; i++)
+    {
+        m_stage[i] = y[i] + (direction * h0 * f0[i]);
+    }
+    std::vector<double>& f1 = m_stages[1];
+    f(t + (direction * h0), m_stage.data(), f1.data());
+    m_evaluationCount++;
+    double changeNorm = 0.0;
+    for (size_t i = 0; i < m_dimension; i++)
+    {
+        const double scale = m_absolute[i] + (m_relative[i] * std::abs(y[i]));
+        changeNorm += ((f1[i] - f0[i]) / scale) * ((f1[i] - f0[i]) / scale);
+    }
+    changeNorm = std::sqrt(changeNorm / double(m_dimension)) / h0;
+
+    const double largest = std::max(derivativeNorm, changeNorm);
+    const double h1 = largest <= 1e-15 ? std::max(1e-6, h0 * 1e-3) : std::pow(0.01 / largest, 1.0 / 5.0);
+    return std::max(std::min(100.0 * h0, h1), m_minStep);
+}
+}
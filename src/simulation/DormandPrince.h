@@ -0,0 +1,228 @@
+#pragma once
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace Simulation
+{
+typedef enum
+{
+    INTEGRATION_OK = 0,
+    INTEGRATION_STOPPED,            //!< The observer asked to stop before the end.
+    INTEGRATION_STEP_TOO_SMALL,     //!< The tolerances can't be met without going below MinStep.
+    INTEGRATION_TOO_MANY_STEPS,
+    INTEGRATION_NOT_FINITE,         //!< The derivative isn't finite, even with the smallest step.
+} IntegrationStatus_t;
+
+/**
+ * The coefficients of the Dormand-Prince 5(4) pair and of its dense output.
+ */
+namespace DormandPrinceTableau
+{
+static constexpr double C2 = 1.0 / 5.0, C3 = 3.0 / 10.0, C4 = 4.0 / 5.0, C5 = 8.0 / 9.0;
+static constexpr double A21 = 1.0 / 5.0;
+static constexpr double A31 = 3.0 / 40.0, A32 = 9.0 / 40.0;
+static constexpr double A41 = 44.0 / 45.0, A42 = -56.0 / 15.0, A43 = 32.0 / 9.0;
+static constexpr double A51 = 19372.0 / 6561.0, A52 = -25360.0 / 2187.0, A53 = 64448.0 / 6561.0, A54 = -212.0 / 729.0;
+static constexpr double A61 = 9017.0 / 3168.0, A62 = -355.0 / 33.0, A63 = 46732.0 / 5247.0, A64 = 49.0 / 176.0,
+                        A65 = -5103.0 / 18656.0;
+// The 5th order weights, also the last stage, evaluated at the solution.
+static constexpr double A71 = 35.0 / 384.0, A73 = 500.0 / 1113.0, A74 = 125.0 / 192.0, A75 = -2187.0 / 6784.0,
+                        A76 = 11.0 / 84.0;
+// Difference between the 5th and 4th order weights.
+static constexpr double E1 = 71.0 / 57600.0, E3 = -71.0 / 16695.0, E4 = 71.0 / 1920.0, E5 = -17253.0 / 339200.0,
+                        E6 = 22.0 / 525.0, E7 = -1.0 / 40.0;
+// Dense output, from Hairer's DOPRI5.
+static constexpr double D1 = -12715105075.0 / 11282082432.0, D3 = 87487479700.0 / 32700410799.0,
+                        D4 = -10690763975.0 / 1880347072.0, D5 = 701980252875.0 / 199316789632.0,
+                        D6 = -1453857185.0 / 822651844.0, D7 = 69997945.0 / 29380423.0;
+}
+
+/**
+ * @class   DormandPrince
+ * @brief   Integrates a system of ordinary differential equations dy/dt = f(t, y) with the embedded
+ *          Runge-Kutta 5(4) pair of Dormand and Prince, with adaptive step size.
+ *          Every step gives a 5th order solution and a 4th order one. Their difference estimates
+ *          the error of the step, which is compared with a tolerance per component: the step is
+ *          rejected and retried smaller when the error is too large, and the next step grows when
+ *          the error is small. Smooth phases (a coast) are crossed in a few large steps while fast
+ *          transients are resolved with small ones.
+ *          A step costs 6 evaluations of f, the last one of a step being the first of the next.
+ *
+ *          f must be smooth over every call to Integrate: a discontinuity (burnout, staging) is
+ *          handled by integrating up to it, then starting a new call from it.
+ */
+class DormandPrince
+{
+public:
+    /**
+     * @brief   Compute the derivative dydt of the state y at time t.
+     */
+    using Derivative = std::function<void(double t, const double* y, double* dydt)>;
+    /**
+     * @brief   Called after every accepted step, with the state at its end.
+     * @retval  False to stop the integration there.
+     */
+    using Observer = std::function<bool(double t, const double* y)>;
+
+    static constexpr double DEFAULT_ABSOLUTE_TOLERANCE = 1e-6;
+    static constexpr double DEFAULT_RELATIVE_TOLERANCE = 1e-6;
+    static constexpr double SAFETY = 0.9;           //!< Fraction of the step size estimated to meet the tolerances.
+    static constexpr double MIN_SCALE = 0.2;        //!< Most a step shrinks after a rejection.
+    static constexpr double MAX_SCALE = 5.0;        //!< Most a step grows after an acceptance.
+    static constexpr double DEFAULT_MIN_STEP = 1e-12;
+    static constexpr size_t DEFAULT_MAX_STEPS = 1000000;
+
+    explicit DormandPrince(size_t dimension = 0);
+
+    /**
+     * @brief   Integrate y from t to end. end can be before t to integrate backwards.
+     * @param   t: The time of y, set to the time reached.
+     * @param   y: The state at t, set to the state reached. Dimension values.
+     * @param   observer: Optional, called after every accepted step.
+     * @retval  INTEGRATION_OK once end is reached, or where and why the integration stopped.
+     */
+    IntegrationStatus_t Integrate(const Derivative& f, double& t, double end, double* y,
+                                  const Observer& observer = nullptr);
+
+    /**
+     * @brief   Get the state at a time within the last accepted step, without evaluating f.
+     *          The interpolation is 4th order, to find events (apogee, impact) between steps.
+     * @param   t: Between StepStart and StepEnd.
+     * @param   y: Where to write the Dimension values.
+     */
+    void Interpolate(double t, double* y) const;
+    inline double StepStart() const
+    {
+        return m_stepStart;
+    }
+    inline double StepEnd() const
+    {
+        return m_stepStart + m_stepSize;
+    }
+
+    inline size_t Dimension() const
+    {
+        return m_dimension;
+    }
+    void Dimension(size_t dimension);
+
+#pragma region Accessors
+    /**
+     * @brief   Set the tolerance of every component: the error of a step on y[i] is kept below
+     *          absolute[i] + relative[i] * |y[i]|. Components of different units and scales
+     *          (position, velocity, mass) get their own.
+     */
+    void Tolerances(const std::vector<double>& absolute, const std::vector<double>& relative);
+    /**
+     * @brief   Set the same tolerance for every component.
+     */
+    void Tolerances(double absolute, double relative);
+    inline const std::vector<double>& AbsoluteTolerances() const
+    {
+        return m_absolute;
+    }
+    inline const std::vector<double>& RelativeTolerances() const
+    {
+        return m_relative;
+    }
+
+    /**
+     * @brief   Set the size of the first step, 0 to estimate it from f.
+     */
+    inline void InitialStep(double step)
+    {
+        m_initialStep = step;
+    }
+    inline double InitialStep() const
+    {
+        return m_initialStep;
+    }
+    inline void MinStep(double step)
+    {
+        m_minStep = step;
+    }
+    inline double MinStep() const
+    {
+        return m_minStep;
+    }
+    /**
+     * @brief   Set the largest step, 0 for no limit.
+     */
+    inline void MaxStep(double step)
+    {
+        m_maxStep = step;
+    }
+    inline double MaxStep() const
+    {
+        return m_maxStep;
+    }
+    inline void MaxSteps(size_t count)
+    {
+        m_maxSteps = count;
+    }
+    inline size_t MaxSteps() const
+    {
+        return m_maxSteps;
+    }
+#pragma endregion
+
+#pragma region Statistics
+    /**
+     * @brief   Get the number of times f was evaluated, since the statistics were reset.
+     */
+    inline size_t EvaluationCount() const
+    {
+        return m_evaluationCount;
+    }
+    inline size_t AcceptedCount() const
+    {
+        return m_acceptedCount;
+    }
+    inline size_t RejectedCount() const
+    {
+        return m_rejectedCount;
+    }
+    inline void ResetStatistics()
+    {
+        m_evaluationCount = 0;
+        m_acceptedCount = 0;
+        m_rejectedCount = 0;
+    }
+#pragma endregion
+
+private:
+    static constexpr size_t STAGE_COUNT = 7;
+
+    /**
+     * @brief   Take a step of size h from t, with m_stages[0] = f(t, y) already computed.
+     *          The 5th order solution is written to m_next and f at its end to m_stages[6].
+     * @retval  The error of the step, relative to the tolerances: the step is good below 1.
+     */
+    double TryStep(const Derivative& f, double t, const double* y, double h);
+    double EstimateInitialStep(const Derivative& f, double t, const double* y, double direction);
+    double GetErrorNorm(const double* y) const;
+
+private:
+    size_t m_dimension = 0;
+    std::vector<double> m_absolute = std::vector<double>();
+    std::vector<double> m_relative = std::vector<double>();
+    double m_initialStep = 0.0;
+    double m_minStep = DEFAULT_MIN_STEP;
+    double m_maxStep = 0.0;
+    size_t m_maxSteps = DEFAULT_MAX_STEPS;
+
+    std::array<std::vector<double>, STAGE_COUNT> m_stages = std::array<std::vector<double>, STAGE_COUNT>();  //!< f at every stage of a step.
+    std::vector<double> m_stage = std::vector<double>();    //!< Scratch, the state of a stage.
+    std::vector<double> m_next = std::vector<double>();     //!< The state at the end of the step tried.
+    std::vector<double> m_error = std::vector<double>();    //!< Estimated error of the step tried.
+    //! Coefficients of the interpolation over the last accepted step.
+    std::array<std::vector<double>, 5> m_dense = std::array<std::vector<double>, 5>();
+    double m_stepStart = 0.0;
+    double m_stepSize = 0.0;
+
+    size_t m_evaluationCount = 0;
+    size_t m_acceptedCount = 0;
+    size_t m_rejectedCount = 0;
+};
+}
@@ -0,0 +1,247 @@
+#include "EntityStore.h"
+
+namespace Simulation
+{
+CollisionBody CollisionBody::FromMesh(const Renderer::Mesh& mesh)
+{
+    CollisionBody body;
+    body.geometry = mesh.Geometry();
+    body.size = mesh.Size();
+    body.anchor = mesh.Anchor();
+    body.rotation = mesh.Rotation();
+    body.local = Renderer::Transform::FromMesh(ImVec2(), body.size, body.anchor, body.rotation);
+    if (body.geometry != nullptr)
+    {
+        body.localBounds = body.geometry->Bounds().Transformed(body.local);
+    }
+    return body;
+}
+
+EntityHandle EntityStore::Create(EntityFlags flags, const ImVec2& position, const ImVec2& velocity, float mass,
+                                 const Renderer::Mesh& mesh, const Renderer::Mesh& collisionMesh)
+{
+    unsigned int index = 0;
+    if (m_freeIndices.empty() == false)
+    {
+        index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    }
+    else
+    {
+        index = (unsigned int)m_slots.size();
+        m_slots.push_back(Slot());
+    }
+
+    Archetype& archetype = m_archetypes[flags & (ARCHETYPE_COUNT - 1)];
+    Slot& slot = m_slots[index];
+    slot.archetype = archetype.flags;
+    slot.row = (unsigned int)archetype.Size();
+    archetype.indices.push_back(index);
+    archetype.positions.push_back(position);
+    archetype.previousPositions.push_back(position);
+    archetype.velocities.push_back(velocity);
+    archetype.masses.push_back(mass);
+    archetype.bodies.push_back(CollisionBody::FromMesh(collisionMesh));
+    if ((archetype.flags & ENTITY_VISIBLE) != 0)
+    {
+        archetype.visuals.push_back(MakeVisual(mesh));
+    }
+    if (archetype.HasPreciseState() == true)
+    {
+        archetype.precisePositions.push_back(Vector2d(position));
+        archetype.preciseVelocities.push_back(Vector2d(velocity));
+    }
+    m_size++;
+    return EntityHandle { index, slot.generation };
+}
+
+EntityHandle EntityStore::Create(const Renderer::Object& object)
+{
+    EntityFlags flags = 0;
+    flags |= object.IsVisible() == true ? ENTITY_VISIBLE : 0;
+    flags |= object.IsCollidable() == true ? ENTITY_COLLIDABLE : 0;
+    flags |= object.IsMoveable() == true ? ENTITY_MOVEABLE : 0;
+    flags |= object.IsAffectedByPhysics() == true ? ENTITY_AFFECTED_BY_PHYSICS : 0;
+    return Create(flags, object.Position(), object.Velocity(), object.Mass(), object.GetMesh(), object.GetCollisionMesh());
+}
+
+Renderer::Object EntityStore::ToObject(unsigned int index) const
+{
+    const Slot& slot = m_slots[index];
+    const Archetype& archetype = m_archetypes[slot.archetype];
+    const CollisionBody& body = archetype.bodies[slot.row];
+    Renderer::Mesh mesh = Renderer::Mesh();
+    if ((slot.archetype & ENTITY_VISIBLE) != 0 && archetype.visuals[slot.row].mesh != EntityVisual::NO_MESH)
+    {
+        const EntityVisual& visual = archetype.visuals[slot.row];
+        const Renderer::Mesh& shared = m_meshes[visual.mesh];
+        mesh = Renderer::Mesh(shared.Geometry(), visual.size, archetype.positions[slot.row], shared.Anchor());
+        mesh.Rotation(visual.rotation);
+        mesh.Tint(visual.tint);
+        mesh.LodPixelError(shared.LodPixelError());
+    }
+    Renderer::Mesh collisionMesh = Renderer::Mesh();
+    if (body.geometry != nullptr)
+    {
+        collisionMesh = Renderer::Mesh(body.geometry, body.size, archetype.positions[slot.row], body.anchor);
+        collisionMesh.Rotation(body.rotation);
+    }
+    Renderer::Object object = Renderer::Object(mesh, (slot.archetype & ENTITY_VISIBLE) != 0,
+                                               collisionMesh, (slot.archetype & ENTITY_COLLIDABLE) != 0,
+                                               archetype.positions[slot.row], (slot.archetype & ENTITY_MOVEABLE) != 0,
+                                               archetype.velocities[slot.row], (slot.archetype & ENTITY_AFFECTED_BY_PHYSICS) != 0);
+    object.Mass(archetype.masses[slot.row]);
+    return object;
+}
+
+void EntityStore::Destroy(EntityHandle handle)
+{
+    if (IsAlive(handle) == false)
+    {
+        return;
+    }
+    Slot& slot = m_slots[handle.index];
+    RemoveRow(m_archetypes[slot.archetype], slot.row);
+    slot.archetype = NO_ARCHETYPE;
+    slot.generation++;
+    m_freeIndices.push_back(handle.index);
+    m_size--;
+}
+
+void EntityStore::Clear()
+{
+    m_archetypes = MakeArchetypes();
+    m_meshes.clear();
+    m_meshIndices.clear();
+    m_freeIndices.clear();
+    for (unsigned int index = (unsigned int)m_slots.size(); index-- > 0;)
+    {
+        Slot& slot = m_slots[index];
+        if (slot.archetype != NO_ARCHETYPE)
+        {
+            slot.archetype = NO_ARCHETYPE;
+            slot.generation++;
+        }
+        m_freeIndices.push_back(index);
+    }
+    m_size = 0;
+}
+
+void EntityStore::Flags(unsigned int index, EntityFlags flags)
+{
+    Slot& slot = m_slots[index];
+    flags &= ARCHETYPE_COUNT - 1;
+    if (slot.archetype == flags)
+    {
+        return;
+    }
+
+    Archetype& from = m_archetypes[slot.archetype];
+    Archetype& to = m_archetypes[flags];
+    const unsigned int row = slot.row;
+    to.indices.push_back(index);
+    to.positions.push_back(from.positions[row]);
+    to.previousPositions.push_back(from.previousPositions[row]);
+    to.velocities.push_back(from.velocities[row]);
+    to.masses.push_back(from.masses[row]);
+    to.bodies.push_back(std::move(from.bodies[row]));
+    if ((to.flags & ENTITY_VISIBLE) != 0)
+    {
+        to.visuals.push_back((from.flags & ENTITY_VISIBLE) != 0 ? from.visuals[row] : EntityVisual());
+    }
+    if (to.HasPreciseState() == true)
+    {
+        to.precisePositions.push_back(from.HasPreciseState() == true ? from.precisePositions[row] : Vector2d(from.positions[row]));
+        to.preciseVelocities.push_back(from.HasPreciseState() == true ? from.preciseVelocities[row] : Vector2d(from.velocities[row]));
+    }
+    RemoveRow(from, row);
+    slot.archetype = flags;
+    slot.row = (unsigned int)to.Size() - 1;
+}
+
+void EntityStore::RemoveRow(Archetype& archetype, unsigned int row)
+{
+    const unsigned int last = (unsigned int)archetype.Size() - 1;
+    if (row != last)
+    {
+        archetype.indices[row] = archetype.indices[last];
+        archetype.positions[row] = archetype.positions[last];
+        archetype.previousPositions[row] = archetype.previousPositions[last];
+        archetype.velocities[row] = archetype.velocities[last];
+        archetype.masses[row] = archetype.masses[last];
+        archetype.bodies[row] = std::move(archetype.bodies[last]);
+        if ((archetype.flags & ENTITY_VISIBLE) != 0)
+        {
+            archetype.visuals[row] = archetype.visuals[last];
+        }
+        if (archetype.HasPreciseState() == true)
+        {
+            archetype.precisePositions[row] = archetype.precisePositions[last];
+            archetype.preciseVelocities[row] = archetype.preciseVelocities[last];
+        }
+        m_slots[archetype.indices[row]].row = row;
+    }
+    archetype.indices.pop_back();
+    archetype.positions.pop_back();
+    archetype.previousPositions.pop_back();
+    archetype.velocities.pop_back();
+    archetype.masses.pop_back();
+    archetype.bodies.pop_back();
+    if ((archetype.flags & ENTITY_VISIBLE) != 0)
+    {
+        archetype.visuals.pop_back();
+    }
+    if (archetype.HasPreciseState() == true)
+    {
+        archetype.precisePositions.pop_back();
+        archetype.preciseVelocities.pop_back();
+    }
+}
+
+void EntityStore::Visual(unsigned int index, const Renderer::Mesh& mesh)
+{
+    const Slot& slot = m_slots[index];
+    m_archetypes[slot.archetype].visuals[slot.row] = MakeVisual(mesh);
+}
+
+EntityVisual EntityStore::MakeVisual(const Renderer::Mesh& mesh)
+{
+    EntityVisual visual;
+    if (mesh.Geometry() == nullptr)
+    {
+        return visual;
+    }
+    visual.size = mesh.Size();
+    visual.rotation = mesh.Rotation();
+    visual.tint = mesh.Tint();
+
+    auto range = m_meshIndices.equal_range(mesh.Geometry().get());
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        const Renderer::Mesh& shared = m_meshes[it->second];
+        if (shared.Anchor().x == mesh.Anchor().x && shared.Anchor().y == mesh.Anchor().y &&
+            shared.LodPixelError() == mesh.LodPixelError())
+        {
+            visual.mesh = it->second;
+            return visual;
+        }
+    }
+
+    // Built in place, so that the caches keep the capacity reserved for the geometry.
+    visual.mesh = (unsigned int)m_meshes.size();
+    m_meshes.emplace_back(mesh.Geometry(), mesh.Size(), ImVec2(), mesh.Anchor());
+    m_meshes.back().LodPixelError(mesh.LodPixelError());
+    m_meshIndices.emplace(mesh.Geometry().get(), visual.mesh);
+    return visual;
+}
+
+std::array<Archetype, EntityStore::ARCHETYPE_COUNT> EntityStore::MakeArchetypes()
+{
+    std::array<Archetype, ARCHETYPE_COUNT> archetypes;
+    for (unsigned int flags = 0; flags < ARCHETYPE_COUNT; flags++)
+    {
+        archetypes[flags].flags = flags;
+    }
+    return archetypes;
+}
+}
@@ -0,0 +1,414 @@
+#pragma once
+#include "simulation/Vector2d.h"
+#include "utils/rendering/Bvh.h"
+#include "utils/rendering/Meshes.h"
+#include "utils/rendering/Object.h"
+#include "utils/rendering/Transform.h"
+#include "vendor/imgui/imgui.h"
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Simulation
+{
+typedef enum
+{
+    ENTITY_VISIBLE = 1 << 0,
+    ENTITY_COLLIDABLE = 1 << 1,
+    ENTITY_MOVEABLE = 1 << 2,
+    ENTITY_AFFECTED_BY_PHYSICS = 1 << 3,
+} EntityFlags_t;
+
+typedef unsigned int EntityFlags;   //!< A set of EntityFlags_t.
+
+/**
+ * A reference to an entity that stays valid while the entity lives, wherever its data moves.
+ * The index of an entity is reused once it's destroyed, the generation tells the entities apart.
+ */
+struct EntityHandle
+{
+    static constexpr unsigned int INVALID_INDEX = 0xFFFFFFFF;
+
+    unsigned int index = INVALID_INDEX;
+    unsigned int generation = 0;
+
+    inline bool operator==(const EntityHandle& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+    inline bool operator!=(const EntityHandle& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * A collision geometry placed relative to its entity's position: rotated, scaled and anchored, but not translated.
+ * Placing it at a position is a translation, so its bounds are its local bounds moved to the position.
+ */
+struct CollisionBody
+{
+    std::shared_ptr<const Renderer::MeshGeometry> geometry = nullptr;
+    ImVec2 size = ImVec2();
+    ImVec2 anchor = ImVec2();
+    float rotation = 0.0f;
+    Renderer::Transform local = Renderer::Transform();  //!< From mesh coordinates to the entity's position.
+    Renderer::Aabb localBounds = Renderer::Aabb();      //!< Bounds of the geometry, relative to the entity's position.
+
+    /**
+     * @brief   Build the body of a collision mesh, ignoring the mesh's position.
+     */
+    static CollisionBody FromMesh(const Renderer::Mesh& mesh);
+
+    inline Renderer::Transform GetTransform(const ImVec2& position) const
+    {
+        return Renderer::Transform(local.A(), local.B(), local.C(), local.D(), local.Tx() + position.x, local.Ty() + position.y);
+    }
+
+    inline Renderer::Aabb GetBounds(const ImVec2& position) const
+    {
+        if (localBounds.IsEmpty() == true)
+        {
+            return Renderer::Aabb();
+        }
+        return Renderer::Aabb(ImVec2(localBounds.min.x + position.x, localBounds.min.y + position.y),
+                              ImVec2(localBounds.max.x + position.x, localBounds.max.y + position.y));
+    }
+
+    /**
+     * @brief   Get the bounds of the body over a step, moving from previous to position.
+     */
+    inline Renderer::Aabb GetSweptBounds(const ImVec2& position, const ImVec2& previous) const
+    {
+        Renderer::Aabb bounds = GetBounds(position);
+        bounds.Add(GetBounds(previous));
+        return bounds;
+    }
+};
+
+/**
+ * How a visible entity is drawn: an instance of one of the store's meshes, whose geometry is shared
+ * with every entity drawn the same way (see EntityStore::Meshes).
+ */
+struct EntityVisual
+{
+    static constexpr unsigned int NO_MESH = 0xFFFFFFFF;
+
+    unsigned int mesh = NO_MESH;    //!< Index of the mesh in EntityStore::Meshes, NO_MESH to draw nothing.
+    ImVec2 size = ImVec2();         //!< Size in pixels.
+    float rotation = 0.0f;          //!< Rotation in degrees.
+    ImU32 tint = IM_COL32_WHITE;    //!< Multiplied with the color of every triangle.
+};
+
+/**
+ * The entities that have the same flags, stored column by column (structure of arrays).
+ * Row i of every column is the same entity. Systems stream through the columns they need only.
+ */
+struct Archetype
+{
+    EntityFlags flags = 0;
+    std::vector<unsigned int> indices = std::vector<unsigned int>();   //!< Index of the entity of every row.
+    std::vector<ImVec2> positions = std::vector<ImVec2>();
+    std::vector<ImVec2> previousPositions = std::vector<ImVec2>();     //!< Positions at the start of the last step.
+    std::vector<ImVec2> velocities = std::vector<ImVec2>();
+    std::vector<float> masses = std::vector<float>();
+    std::vector<CollisionBody> bodies = std::vector<CollisionBody>();
+    std::vector<EntityVisual> visuals = std::vector<EntityVisual>();    //!< Only filled in visible archetypes.
+    // The state the physics integrates, which positions and velocities are rounded from after every step.
+    // Only filled in the archetypes that are moveable and affected by physics, see HasPreciseState.
+    std::vector<Vector2d> precisePositions = std::vector<Vector2d>();
+    std::vector<Vector2d> preciseVelocities = std::vector<Vector2d>();
+
+    inline bool HasPreciseState() const
+    {
+        return (flags & (ENTITY_MOVEABLE | ENTITY_AFFECTED_BY_PHYSICS)) == (ENTITY_MOVEABLE | ENTITY_AFFECTED_BY_PHYSICS);
+    }
+
+    inline size_t Size() const
+    {
+        return indices.size();
+    }
+};
+
+/**
+ * @class   EntityStore
+ * @brief   The entities of a world, grouped by flags into archetypes whose components are stored in
+ *          contiguous columns, so iterating over 100k entities streams through memory instead of
+ *          chasing an object per entity.
+ *          Entities are referred to by handles, or by their index wherever the handle was checked.
+ *          Destroying an entity moves the last row of its archetype into its place, and changing its
+ *          flags moves it to another archetype, but its index and handle stay the same.
+ */
+class EntityStore
+{
+public:
+    static constexpr unsigned int ARCHETYPE_COUNT = 16;     //!< One for every combination of EntityFlags_t.
+
+    /**
+     * @brief   Create an entity.
+     * @param   mesh: The visible mesh, drawn at the entity's position. Only its geometry, anchor and level of detail
+     *          error are kept, in a mesh shared with the entities drawn the same way, and its size, rotation and tint.
+     * @param   collisionMesh: Its geometry, size, anchor and rotation make the collision body.
+     */
+    EntityHandle Create(EntityFlags flags, const ImVec2& position, const ImVec2& velocity, float mass,
+                        const Renderer::Mesh& mesh, const Renderer::Mesh& collisionMesh);
+    /**
+     * @brief   Create an entity from an object, for the code written before entities.
+     */
+    EntityHandle Create(const Renderer::Object& object);
+    /**
+     * @brief   Rebuild an object from an entity, for the code written before entities.
+     */
+    Renderer::Object ToObject(unsigned int index) const;
+
+    /**
+     * @brief   Destroy an entity. Nothing is done if the handle isn't valid anymore.
+     */
+    void Destroy(EntityHandle handle);
+    /**
+     * @brief   Destroy every entity. Their indices are reused in order, with new generations, so the
+     *          handles of the entities destroyed stay invalid.
+     */
+    void Clear();
+
+    inline bool IsAlive(EntityHandle handle) const
+    {
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation &&
+            m_slots[handle.index].archetype != NO_ARCHETYPE;
+    }
+    inline bool IsAlive(unsigned int index) const
+    {
+        return index < m_slots.size() && m_slots[index].archetype != NO_ARCHETYPE;
+    }
+    inline EntityHandle GetHandle(unsigned int index) const
+    {
+        return EntityHandle { index, m_slots[index].generation };
+    }
+
+    /**
+     * @brief   Get the number of living entities.
+     */
+    inline size_t Size() const
+    {
+        return m_size;
+    }
+    /**
+     * @brief   Get one past the highest entity index, to size arrays indexed by entity.
+     */
+    inline unsigned int IndexCount() const
+    {
+        return (unsigned int)m_slots.size();
+    }
+
+    /**
+     * @brief   Call function(Archetype&) for every non-empty archetype that has all the required flags.
+     *          The columns can be modified but entities can't be created or destroyed meanwhile.
+     */
+    template <typename Function>
+    inline void ForEach(EntityFlags required, Function&& function)
+    {
+        for (Archetype& archetype : m_archetypes)
+        {
+            if ((archetype.flags & required) == required && archetype.indices.empty() == false)
+            {
+                function(archetype);
+            }
+        }
+    }
+    template <typename Function>
+    inline void ForEach(EntityFlags required, Function&& function) const
+    {
+        for (const Archetype& archetype : m_archetypes)
+        {
+            if ((archetype.flags & required) == required && archetype.indices.empty() == false)
+            {
+                function(archetype);
+            }
+        }
+    }
+
+#pragma region Accessors
+    /**
+     * @brief   Change the flags of an entity, which moves it to another archetype.
+     *          An entity that becomes visible draws nothing until it is given a mesh, see Visual.
+     */
+    void Flags(unsigned int index, EntityFlags flags);
+    inline EntityFlags Flags(unsigned int index) const
+    {
+        return m_slots[index].archetype;
+    }
+    inline bool HasFlags(unsigned int index, EntityFlags flags) const
+    {
+        return (m_slots[index].archetype & flags) == flags;
+    }
+
+    inline const ImVec2& Position(unsigned int index) const
+    {
+        const Slot& slot = m_slots[index];
+        return m_archetypes[slot.archetype].positions[slot.row];
+    }
+    /**
+     * @brief   Place an entity. It's moved there at once, without sweeping the way from its previous position.
+     */
+    inline void Position(unsigned int index, const ImVec2& position)
+    {
+        const Slot& slot = m_slots[index];
+        Archetype& archetype = m_archetypes[slot.archetype];
+        archetype.positions[slot.row] = position;
+        archetype.previousPositions[slot.row] = position;
+        if (archetype.HasPreciseState() == true)
+        {
+            archetype.precisePositions[slot.row] = Vector2d(position);
+        }
+    }
+    inline const ImVec2& PreviousPosition(unsigned int index) const
+    {
+        const Slot& slot = m_slots[index];
+        return m_archetypes[slot.archetype].previousPositions[slot.row];
+    }
+
+    inline const ImVec2& Velocity(unsigned int index) const
+    {
+        const Slot& slot = m_slots[index];
+        return m_archetypes[slot.archetype].velocities[slot.row];
+    }
+    inline void Velocity(unsigned int index, const ImVec2& velocity)
+    {
+        const Slot& slot = m_slots[index];
+        Archetype& archetype = m_archetypes[slot.archetype];
+        archetype.velocities[slot.row] = velocity;
+        if (archetype.HasPreciseState() == true)
+        {
+            archetype.preciseVelocities[slot.row] = Vector2d(velocity);
+        }
+    }
+
+    /**
+     * @brief   Get the position in double precision, the one the physics integrates for the entities that have it
+     *          (see Archetype::HasPreciseState), else the position.
+     */
+    inline Vector2d PrecisePosition(unsigned int index) const
+    {
+        const Slot& slot = m_slots[index];
+        const Archetype& archetype = m_archetypes[slot.archetype];
+        return archetype.HasPreciseState() == true ? archetype.precisePositions[slot.row] : Vector2d(archetype.positions[slot.row]);
+    }
+    /**
+     * @brief   Place an entity at a position in double precision, kept by the entities that have it.
+     *          Like Position, it's moved there at once.
+     */
+    inline void PrecisePosition(unsigned int index, const Vector2d& position)
+    {
+        Position(index, position.ToImVec2());
+        const Slot& slot = m_slots[index];
+        Archetype& archetype = m_archetypes[slot.archetype];
+        if (archetype.HasPreciseState() == true)
+        {
+            archetype.precisePositions[slot.row] = position;
+        }
+    }
+    inline Vector2d PreciseVelocity(unsigned int index) const
+    {
+        const Slot& slot = m_slots[index];
+        const Archetype& archetype = m_archetypes[slot.archetype];
+        return archetype.HasPreciseState() == true ? archetype.preciseVelocities[slot.row] : Vector2d(archetype.velocities[slot.row]);
+    }
+    inline void PreciseVelocity(unsigned int index, const Vector2d& velocity)
+    {
+        Velocity(index, velocity.ToImVec2());
+        const Slot& slot = m_slots[index];
+        Archetype& archetype = m_archetypes[slot.archetype];
+        if (archetype.HasPreciseState() == true)
+        {
+            archetype.preciseVelocities[slot.row] = velocity;
+        }
+    }
+
+    inline float Mass(unsigned int index) const
+    {
+        const Slot& slot = m_slots[index];
+        return m_archetypes[slot.archetype].masses[slot.row];
+    }
+    inline void Mass(unsigned int index, float mass)
+    {
+        const Slot& slot = m_slots[index];
+        m_archetypes[slot.archetype].masses[slot.row] = mass;
+    }
+
+    inline const CollisionBody& GetBody(unsigned int index) const
+    {
+        const Slot& slot = m_slots[index];
+        return m_archetypes[slot.archetype].bodies[slot.row];
+    }
+    /**
+     * @brief   Get how a visible entity is drawn.
+     */
+    inline const EntityVisual& Visual(unsigned int index) const
+    {
+        const Slot& slot = m_slots[index];
+        return m_archetypes[slot.archetype].visuals[slot.row];
+    }
+    /**
+     * @brief   Draw a visible entity as the mesh, see Create.
+     */
+    void Visual(unsigned int index, const Renderer::Mesh& mesh);
+
+    /**
+     * @brief   Get the meshes the visible entities are instances of, one per geometry, anchor and level of detail error.
+     *          Only used by the render thread, to draw the entities through Renderer::Mesh::DrawInstances.
+     *          The meshes are kept until Clear.
+     */
+    inline std::vector<Renderer::Mesh>& Meshes()
+    {
+        return m_meshes;
+    }
+#pragma endregion
+
+    /**
+     * @brief   Get the bounds of an entity's collision body at its position, in world coordinates.
+     */
+    inline Renderer::Aabb GetBounds(unsigned int index) const
+    {
+        return GetBody(index).GetBounds(Position(index));
+    }
+    /**
+     * @brief   Get the transform of an entity's collision body at its position, from mesh to world coordinates.
+     */
+    inline Renderer::Transform GetCollisionTransform(unsigned int index) const
+    {
+        return GetBody(index).GetTransform(Position(index));
+    }
+
+private:
+    static constexpr unsigned int NO_ARCHETYPE = 0xFFFFFFFF;
+
+    struct Slot
+    {
+        unsigned int archetype = NO_ARCHETYPE;  //!< Also the flags of the entity, NO_ARCHETYPE once it's destroyed.
+        unsigned int row = 0;
+        unsigned int generation = 0;
+    };
+
+    /**
+     * @brief   Remove a row by moving the archetype's last row into its place.
+     */
+    void RemoveRow(Archetype& archetype, unsigned int row);
+
+    /**
+     * @brief   Find the shared mesh drawn like the mesh, adding it if there is none yet.
+     */
+    EntityVisual MakeVisual(const Renderer::Mesh& mesh);
+
+private:
+    std::array<Archetype, ARCHETYPE_COUNT> m_archetypes = MakeArchetypes();
+    std::vector<Slot> m_slots = std::vector<Slot>();
+    std::vector<unsigned int> m_freeIndices = std::vector<unsigned int>();
+    size_t m_size = 0;
+    std::vector<Renderer::Mesh> m_meshes = std::vector<Renderer::Mesh>();
+    std::unordered_multimap<const Renderer::MeshGeometry*, unsigned int> m_meshIndices =
+        std::unordered_multimap<const Renderer::MeshGeometry*, unsigned int>();     //!< Meshes by geometry.
+
+    static std::array<Archetype, ARCHETYPE_COUNT> MakeArchetypes();
+};
+}
@@ -0,0 +1,316 @@
+#include "Flight.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Simulation
+{
+static constexpr double PI = 3.14159265358979323846;
+
+Flight::Flight()
+{
+    m_integrator.Tolerances({ POSITION_TOLERANCE, POSITION_TOLERANCE, POSITION_TOLERANCE, VELOCITY_TOLERANCE,
+                              VELOCITY_TOLERANCE, VELOCITY_TOLERANCE, MASS_TOLERANCE },
+                            std::vector<double>(STATE_SIZE, RELATIVE_TOLERANCE));
+}
+
+FlightResult Flight::Simulate(const RocketParameters& rocket)
+{
+    FlightResult result;
+    m_integrator.ResetStatistics();
+
+    const double tilt = rocket.launchTilt * (PI / 180.0);
+    const double azimuth = rocket.launchAzimuth * (PI / 180.0);
+    const double windDirection = rocket.windDirection * (PI / 180.0);
+    m_railDirection[0] = std::sin(tilt) * std::sin(azimuth);
+    m_railDirection[1] = std::sin(tilt) * std::cos(azimuth);
+    m_railDirection[2] = std::cos(tilt);
+    m_railLengthSquared = rocket.railLength * rocket.railLength;
+    // The wind blows toward the opposite of where it comes from.
+    m_windEast = -rocket.windSpeed * std::sin(windDirection);
+    m_windNorth = -rocket.windSpeed * std::cos(windDirection);
+    m_motor = rocket.motor;
+    m_thrust = rocket.thrust * rocket.thrustScale;
+    m_thrustScale = rocket.thrustScale;
+    m_massFlow = rocket.burnTime > 0.0 ? rocket.propellantMass / rocket.burnTime : 0.0;
+    m_dragArea = rocket.dragCoefficient * PI * 0.25 * rocket.diameter * rocket.diameter;
+    m_airDensity = Atmosphere::GetTable(AIR_DENSITY, rocket.atmosphere);
+
+    std::fill(std::begin(m_state), std::end(m_state), 0.0);
+    m_phase = PHASE_BOOST;
+    if (GetLiftoff(rocket, m_time, m_state[MASS]) == false)
+    {
+        result.status = FLIGHT_NO_LIFTOFF;
+        return result;
+    }
+    const double burnTime = GetBurnTime(rocket);
+
+    m_isOnRail = true;
+    IntegrationStatus_t status = INTEGRATION_OK;
+    while (status == INTEGRATION_OK)
+    {
+        const double end = m_phase == PHASE_BOOST ? GetBoostEnd(rocket, m_time) : rocket.maxFlightTime;
+        const Event_t event = m_isOnRail == true ? EVENT_RAIL_EXIT : (m_phase == PHASE_COAST ? EVENT_APOGEE : EVENT_LANDING);
+        const bool isEvent = IntegratePhase(end, event, result, status);
+        if (status != INTEGRATION_OK)
+        {
+            result.status = FLIGHT_INTEGRATION_FAILED;
+            break;
+        }
+
+        if (isEvent == false)
+        {
+            if (m_phase == PHASE_BOOST && m_time < std::min(burnTime, rocket.maxFlightTime))
+            {
+                // A bend of the thrust curve, the boost goes on.
+                continue;
+            }
+            if (m_phase != PHASE_BOOST || m_time >= rocket.maxFlightTime)
+            {
+                result.status = FLIGHT_TIMEOUT;
+                break;
+            }
+            // Burnout, the coast starts with exactly the dry mass. The boost may already have
+            // ended going down, past its apogee.
+            m_phase = PHASE_COAST;
+            m_state[MASS] = GetBurnoutMass(rocket);
+            if (m_isOnRail == false && m_state[VERTICAL_SPEED] <= 0.0)
+            {
+                m_phase = PHASE_DESCENT;
+                m_dragArea = rocket.parachuteDragArea > 0.0 ? rocket.parachuteDragArea : m_dragArea;
+            }
+        }
+        else if (event == EVENT_RAIL_EXIT && m_state[ALTITUDE] > 0.0)
+        {
+            m_isOnRail = false;
+            if (m_phase == PHASE_COAST && m_state[VERTICAL_SPEED] <= 0.0)
+            {
+                m_phase = PHASE_DESCENT;
+                m_dragArea = rocket.parachuteDragArea > 0.0 ? rocket.parachuteDragArea : m_dragArea;
+            }
+        }
+        else if (event == EVENT_RAIL_EXIT)
+        {
+            // Slid back down to the foot of the rail, it never flew.
+            result.status = FLIGHT_NO_LIFTOFF;
+            break;
+        }
+        else if (event == EVENT_APOGEE)
+        {
+            // The parachute opens.
+            result.apogee = m_state[ALTITUDE];
+            result.apogeeTime = m_time;
+            m_phase = PHASE_DESCENT;
+            m_dragArea = rocket.parachuteDragArea > 0.0 ? rocket.parachuteDragArea : m_dragArea;
+        }
+        else
+        {
+            result.status = FLIGHT_LANDED;
+            result.landingEast = m_state[0];
+            result.landingNorth = m_state[1];
+            result.flightTime = m_time;
+            break;
+        }
+    }
+    return result;
+}
+
+void Flight::Derivative(double t, const double* y, double* dydt) const
+{
+    const double airVelocity[3] = { y[3] - m_windEast, y[4] - m_windNorth, y[5] };
+    const double airSpeed = std::sqrt((airVelocity[0] * airVelocity[0]) + (airVelocity[1] * airVelocity[1]) +
+                                      (airVelocity[2] * airVelocity[2]));
+    const double mass = y[MASS];
+    const double drag = (0.5 * Atmosphere::Interpolate(m_airDensity, y[ALTITUDE]) * m_dragArea * airSpeed) / mass;
+    double thrust = 0.0;
+    double massFlow = 0.0;
+    if (m_phase == PHASE_BOOST)
+    {
+        thrust = (m_motor != nullptr ? m_thrustScale * m_motor->GetThrust(t) : m_thrust) / mass;
+        massFlow = m_motor != nullptr ? m_motor->GetMassFlow(t) : m_massFlow;
+    }
+
+    // Off the rail, the rocket weathercocks and thrusts along its velocity through the air.
+    double direction[3] = { m_railDirection[0], m_railDirection[1], m_railDirection[2] };
+    if (m_isOnRail == false && airSpeed > 0.0)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            direction[i] = airVelocity[i] / airSpeed;
+        }
+    }
+    double acceleration[3];
+    for (int i = 0; i < 3; i++)
+    {
+        acceleration[i] = (thrust * direction[i]) - (drag * airVelocity[i]);
+    }
+    acceleration[2] -= GRAVITY;
+
+    if (m_isOnRail == true)
+    {
+        // The rail takes everything across it.
+        const double along = (acceleration[0] * m_railDirection[0]) + (acceleration[1] * m_railDirection[1]) +
+            (acceleration[2] * m_railDirection[2]);
+        for (int i = 0; i < 3; i++)
+        {
+            acceleration[i] = along * m_railDirection[i];
+        }
+    }
+
+    dydt[0] = y[3];
+    dydt[1] = y[4];
+    dydt[2] = y[5];
+    dydt[3] = acceleration[0];
+    dydt[4] = acceleration[1];
+    dydt[5] = acceleration[2];
+    dydt[MASS] = -massFlow;
+}
+
+double Flight::GetEventValue(Event_t event, const double* y) const
+{
+    switch (event)
+    {
+        case EVENT_RAIL_EXIT:
+            // Whichever comes first, the top of the rail or its foot.
+            return std::min(m_railLengthSquared - ((y[0] * y[0]) + (y[1] * y[1]) + (y[2] * y[2])), y[ALTITUDE]);
+        case EVENT_APOGEE:
+            return y[VERTICAL_SPEED];
+        default:
+            return y[ALTITUDE];
+    }
+}
+
+bool Flight::IntegratePhase(double end, Event_t event, FlightResult& result, IntegrationStatus_t& status)
+{
+    bool isEventFound = false;
+    // Where the event value is known to be below 0.
+    double eventEnd = m_time;
+    double verticalSpeed = m_state[VERTICAL_SPEED];
+    status = m_integrator.Integrate([this](double t, const double* y, double* dydt) { Derivative(t, y, dydt); },
+                                    m_time, end, m_state, [&](double t, const double* y)
+                                    {
+                                        const double speed = std::sqrt((y[3] * y[3]) + (y[4] * y[4]) + (y[5] * y[5]));
+                                        result.maxSpeed = std::max(result.maxSpeed, speed);
+                                        if (y[ALTITUDE] > result.apogee)
+                                        {
+                                            result.apogee = y[ALTITUDE];
+                                            result.apogeeTime = t;
+                                        }
+                                        isEventFound = GetEventValue(event, y) < 0.0;
+                                        eventEnd = t;
+                                        if (isEventFound == false && event == EVENT_RAIL_EXIT && verticalSpeed > 0.0 && y[VERTICAL_SPEED] <= 0.0)
+                                        {
+                                            // Topped out on the rail during the step, maybe past the top of the rail and back below it.
+                                            eventEnd = FindRailTop(m_integrator.StepStart(), t);
+                                            double top[STATE_SIZE];
+                                            m_integrator.Interpolate(eventEnd, top);
+                                            isEventFound = GetEventValue(event, top) < 0.0;
+                                        }
+                                        verticalSpeed = y[VERTICAL_SPEED];
+                                        return isEventFound == false;
+                                    });
+    if (isEventFound == false)
+    {
+        return false;
+    }
+
+    // Bisect the last step for where the event value crosses 0.
+    double low = m_integrator.StepStart();
+    double high = eventEnd;
+    double y[STATE_SIZE];
+    while (high - low > EVENT_TOLERANCE)
+    {
+        const double middle = 0.5 * (low + high);
+        m_integrator.Interpolate(middle, y);
+        if (GetEventValue(event, y) < 0.0)
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle;
+        }
+    }
+    m_time = high;
+    m_integrator.Interpolate(high, m_state);
+    status = INTEGRATION_OK;
+    return true;
+}
+
+double Flight::FindRailTop(double low, double high) const
+{
+    double y[STATE_SIZE];
+    while (high - low > EVENT_TOLERANCE)
+    {
+        const double middle = 0.5 * (low + high);
+        m_integrator.Interpolate(middle, y);
+        if (y[VERTICAL_SPEED] <= 0.0)
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle;
+        }
+    }
+    return high;
+}
+
+double GetBurnoutMass(const RocketParameters& rocket)
+{
+    return rocket.motor != nullptr ? rocket.dryMass + (rocket.motor->TotalMass() - rocket.motor->PropellantMass()) : rocket.dryMass;
+}
+
+double GetBurnTime(const RocketParameters& rocket)
+{
+    return rocket.motor != nullptr ? rocket.motor->BurnTime() : rocket.burnTime;
+}
+
+double GetBoostEnd(const RocketParameters& rocket, double time)
+{
+    const double burnTime = rocket.motor != nullptr ? rocket.motor->GetNextBend(time) : rocket.burnTime;
+    return std::min(burnTime, rocket.maxFlightTime);
+}
+
+bool GetLiftoff(const RocketParameters& rocket, double& time, double& mass)
+{
+    const double weight = Flight::GRAVITY * std::cos(rocket.launchTilt * (PI / 180.0));
+    time = 0.0;
+    if (rocket.motor == nullptr)
+    {
+        mass = rocket.dryMass + rocket.propellantMass;
+        return rocket.burnTime > 0.0 && rocket.thrust * rocket.thrustScale > mass * weight;
+    }
+
+    // Walk the samples of the curve to the first that lifts, then bisect the interval before it.
+    const Motor& motor = *rocket.motor;
+    const double burnoutMass = GetBurnoutMass(rocket);
+    auto isLifting = [&](double t)
+    {
+        return rocket.thrustScale * motor.GetThrust(t) > (burnoutMass + motor.GetPropellantMass(t)) * weight;
+    };
+    const double step = motor.BurnTime() / double(Motor::SAMPLE_COUNT);
+    for (size_t i = 0; i <= Motor::SAMPLE_COUNT; i++)
+    {
+        if (isLifting(double(i) * step) == true)
+        {
+            double low = i > 0 ? double(i - 1) * step : 0.0;
+            time = double(i) * step;
+            while (time - low > Flight::EVENT_TOLERANCE)
+            {
+                const double middle = 0.5 * (low + time);
+                if (isLifting(middle) == true)
+                {
+                    time = middle;
+                }
+                else
+                {
+                    low = middle;
+                }
+            }
+            mass = burnoutMass + motor.GetPropellantMass(time);
+            return true;
+        }
+    }
+    return false;
+}
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include "simulation/Atmosphere.h"
+#include "simulation/DormandPrince.h"
+#include "simulation/Motor.h"
+
+namespace Simulation
+{
+/**
+ * A single stage rocket and its launch conditions.
+ * Axes are east, north and up, in meters, from the foot of the launch rail.
+ */
+struct RocketParameters
+{
+    double dryMass = 1.2;               //!< kg, without the motor when there is one.
+    double propellantMass = 0.3;        //!< kg, burnt at a constant rate.
+    double thrust = 120.0;              //!< Average thrust, in N.
+    double burnTime = 2.5;              //!< s.
+    const Motor* motor = nullptr;       //!< Borrowed from the MotorLibrary, replaces the 3 above when set.
+    double thrustScale = 1.0;           //!< Multiplies the thrust, without changing the burn time nor the propellant.
+    double diameter = 0.066;            //!< m, the reference area of the drag.
+    double dragCoefficient = 0.45;
+    double parachuteDragArea = 0.0;     //!< Drag coefficient times area of the parachute opened at apogee, in m^2, 0 for none.
+    double launchTilt = 5.0;            //!< Angle of the rail from vertical, in degrees.
+    double launchAzimuth = 0.0;         //!< Direction the rail leans to, in degrees clockwise from north.
+    double railLength = 1.5;            //!< m.
+    double windSpeed = 0.0;             //!< m/s, the same at every altitude.
+    double windDirection = 0.0;         //!< Direction the wind blows from, in degrees clockwise from north.
+    AtmosphereModel_t atmosphere = ATMOSPHERE_STANDARD;
+    double maxFlightTime = 600.0;       //!< Flights still in the air after this long time out, in s.
+};
+
+typedef enum
+{
+    FLIGHT_LANDED = 0,
+    FLIGHT_NO_LIFTOFF,                  //!< The thrust can't lift the rocket off the rail, or it slides back down to its foot.
+    FLIGHT_INTEGRATION_FAILED,          //!< The integrator couldn't meet its tolerances, or the state isn't finite.
+    FLIGHT_TIMEOUT,                     //!< Still in the air after maxFlightTime.
+    FLIGHT_STATUS_COUNT,
+} FlightStatus_t;
+
+/**
+ * @brief   Get the mass of a rocket once burnt out, with the empty case of its motor.
+ */
+double GetBurnoutMass(const RocketParameters& rocket);
+
+/**
+ * @brief   Get the duration of the thrust of a rocket, from ignition.
+ */
+double GetBurnTime(const RocketParameters& rocket);
+
+/**
+ * @brief   Get the end of the boost phase that starts at a time: the next bend of the thrust
+ *          curve of the motor, the burnout, or the timeout.
+ */
+double GetBoostEnd(const RocketParameters& rocket, double time);
+
+/**
+ * @brief   Get when the thrust of a rocket first overcomes its weight along the rail, it sits on
+ *          the launcher until then, and its mass at that time.
+ * @retval  False if it never does.
+ */
+bool GetLiftoff(const RocketParameters& rocket, double& time, double& mass);
+
+struct FlightResult
+{
+    FlightStatus_t status = FLIGHT_LANDED;
+    double apogee = 0.0;                //!< Highest altitude, in m.
+    double apogeeTime = 0.0;            //!< s.
+    double landingEast = 0.0;           //!< m.
+    double landingNorth = 0.0;          //!< m.
+    double flightTime = 0.0;            //!< Time of the landing from ignition, in s.
+    double maxSpeed = 0.0;              //!< Highest speed relative to the ground seen at the end of a step, in m/s.
+};
+
+/**
+ * @class   Flight
+ * @brief   Simulates the flight of a point mass rocket: boost along the rail then along the wind
+ *          relative velocity, ballistic coast to apogee, then descent under the parachute, if any,
+ *          until it hits the ground.
+ *          Every phase is integrated with an adaptive DormandPrince. The events that change the
+ *          derivative (rail exit, bends of the thrust curve, burnout, apogee) end a phase, the
+ *          events are located within their step with its dense output.
+ *          A Flight keeps its integrator and scratch buffers from one simulation to the next, a
+ *          batch of flights reuses one per thread.
+ */
+class Flight
+{
+public:
+    static constexpr size_t STATE_SIZE = 7;     //!< Position, velocity and mass.
+    static constexpr size_t ALTITUDE = 2;       //!< Component of the state.
+    static constexpr size_t VERTICAL_SPEED = 5;
+    static constexpr size_t MASS = 6;
+    static constexpr double GRAVITY = 9.80665;  //!< m/s^2.
+    // Absolute tolerances of the integration: positions to the millimeter, velocities to 0.1 mm/s,
+    // the mass to the milligram, or 1 ppm.
+    static constexpr double POSITION_TOLERANCE = 1e-3;
+    static constexpr double VELOCITY_TOLERANCE = 1e-4;
+    static constexpr double MASS_TOLERANCE = 1e-6;
+    static constexpr double RELATIVE_TOLERANCE = 1e-6;
+    static constexpr double EVENT_TOLERANCE = 1e-6;     //!< Precision of the time of apogee and landing, in s.
+
+    Flight();
+
+    /**
+     * @brief   Simulate a flight from liftoff to landing.
+     */
+    FlightResult Simulate(const RocketParameters& rocket);
+
+    /**
+     * @brief   Get the number of derivative evaluations of the last simulation.
+     */
+    inline size_t EvaluationCount() const
+    {
+        return m_integrator.EvaluationCount();
+    }
+
+private:
+    typedef enum
+    {
+        PHASE_BOOST = 0,
+        PHASE_COAST,
+        PHASE_DESCENT,
+    } Phase_t;
+
+    typedef enum
+    {
+        EVENT_RAIL_EXIT = 0,            //!< Leaving the rail, or sliding back down to its foot.
+        EVENT_APOGEE,
+        EVENT_LANDING,
+    } Event_t;
+
+    void Derivative(double t, const double* y, double* dydt) const;
+    /**
+     * @brief   Get a value that crosses 0 downwards when the event happens.
+     */
+    double GetEventValue(Event_t event, const double* y) const;
+    /**
+     * @brief   Integrate from m_time until the event or end, with the derivative smooth in between.
+     * @retval  True if the event was found, m_time and m_state are then moved to it.
+     */
+    bool IntegratePhase(double end, Event_t event, FlightResult& result, IntegrationStatus_t& status);
+    /**
+     * @brief   Bisect the last step, between low and high, for where the vertical speed crosses 0.
+     */
+    double FindRailTop(double low, double high) const;
+
+private:
+    DormandPrince m_integrator = DormandPrince(STATE_SIZE);
+    double m_state[STATE_SIZE] = {};
+    double m_time = 0.0;
+    Phase_t m_phase = PHASE_BOOST;
+    bool m_isOnRail = true;
+
+    // Of the rocket simulated, in SI units.
+    const Motor* m_motor = nullptr;
+    double m_thrust = 0.0;              //!< Of the rocket without a motor.
+    double m_thrustScale = 1.0;
+    double m_massFlow = 0.0;
+    double m_dragArea = 0.0;            //!< Drag coefficient times reference area, of the rocket or the parachute.
+    const double* m_airDensity = nullptr;   //!< The density nodes of the atmosphere.
+    double m_railDirection[3] = {};
+    double m_railLengthSquared = 0.0;
+    double m_windEast = 0.0;
+    double m_windNorth = 0.0;
+};
+}
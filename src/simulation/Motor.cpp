@@ -0,0 +1,416 @@
+#include "Motor.h"
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+namespace Simulation
+{
+static constexpr double BEND_THRESHOLD = 1e-6;      //!< Change of the thrust between samples, relative to the max, that makes a bend.
+
+static bool ParseNumber(const std::string& text, double& value);
+static bool IsValidMotor(const std::vector<ThrustPoint>& curve, double propellantMass, double totalMass);
+static size_t FindElement(const std::string& text, const std::string& name, size_t start, size_t end);
+static bool GetAttribute(const std::string& tag, const std::string& name, std::string& value);
+static bool IsSameName(const std::string& a, const std::string& b);
+
+Motor::Motor(const std::string& name, const std::string& manufacturer, double diameter, double length,
+             double propellantMass, double totalMass, std::vector<ThrustPoint> curve)
+    : m_name(name), m_manufacturer(manufacturer), m_diameter(diameter), m_length(length),
+      m_propellantMass(propellantMass), m_totalMass(totalMass)
+{
+    if (curve.empty() == true || curve.front().time > 0.0)
+    {
+        curve.insert(curve.begin(), ThrustPoint());
+    }
+    m_burnTime = curve.back().time;
+    m_step = m_burnTime / double(SAMPLE_COUNT);
+    m_inverseStep = m_step > 0.0 ? 1.0 / m_step : 0.0;
+
+    // The curve is linear between its points, sample it on the grid walking both at once.
+    m_thrust.resize(SAMPLE_COUNT + 1);
+    size_t point = 0;
+    for (size_t i = 0; i <= SAMPLE_COUNT; i++)
+    {
+        const double time = i == SAMPLE_COUNT ? m_burnTime : double(i) * m_step;
+        while (point + 2 < curve.size() && curve[point + 1].time <= time)
+        {
+            point++;
+        }
+        const ThrustPoint& start = curve[point];
+        const ThrustPoint& end = curve[std::min(point + 1, curve.size() - 1)];
+        const double span = end.time - start.time;
+        m_thrust[i] = span > 0.0 ? start.thrust + (((time - start.time) / span) * (end.thrust - start.thrust)) : end.thrust;
+    }
+    m_maxThrust = *std::max_element(m_thrust.begin(), m_thrust.end());
+    // Samples on a straight part of the curve aren't bends, even with rounding.
+    for (size_t i = 1; i < SAMPLE_COUNT; i++)
+    {
+        if (std::abs(m_thrust[i + 1] - (2.0 * m_thrust[i]) + m_thrust[i - 1]) > BEND_THRESHOLD * m_maxThrust)
+        {
+            m_bends.push_back(double(i) * m_step);
+        }
+    }
+
+    m_impulse.resize(SAMPLE_COUNT + 1);
+    m_impulse[0] = 0.0;
+    for (size_t i = 1; i <= SAMPLE_COUNT; i++)
+    {
+        m_impulse[i] = m_impulse[i - 1] + (0.5 * m_step * (m_thrust[i - 1] + m_thrust[i]));
+    }
+    m_massPerImpulse = m_impulse.back() > 0.0 ? m_propellantMass / m_impulse.back() : 0.0;
+    m_propellant.resize(SAMPLE_COUNT + 1);
+    for (size_t i = 0; i <= SAMPLE_COUNT; i++)
+    {
+        m_propellant[i] = m_propellantMass - (m_massPerImpulse * m_impulse[i]);
+    }
+    m_propellant.back() = 0.0;
+}
+
+MotorFileStatus_t ParseEngMotors(const std::string& text, std::vector<Motor>& motors)
+{
+    const size_t firstMotor = motors.size();
+    std::istringstream input(text);
+    std::string line;
+
+    bool isInMotor = false;
+    std::vector<std::string> header;
+    std::vector<ThrustPoint> curve;
+    // Add the motor read so far, if any.
+    auto finish = [&]()
+    {
+        if (isInMotor == false)
+        {
+            return true;
+        }
+        isInMotor = false;
+        double diameter = 0.0;
+        double length = 0.0;
+        double propellantMass = 0.0;
+        double totalMass = 0.0;
+        if (ParseNumber(header[1], diameter) == false || ParseNumber(header[2], length) == false ||
+            ParseNumber(header[4], propellantMass) == false || ParseNumber(header[5], totalMass) == false ||
+            IsValidMotor(curve, propellantMass, totalMass) == false)
+        {
+            return false;
+        }
+        std::string manufacturer = header[6];
+        for (size_t i = 7; i < header.size(); i++)
+        {
+            manufacturer += " " + header[i];
+        }
+        motors.emplace_back(header[0], manufacturer, diameter / 1000.0, length / 1000.0, propellantMass, totalMass, curve);
+        return true;
+    };
+
+    while (std::getline(input, line))
+    {
+        std::istringstream fields(line.substr(0, line.find(';')));
+        std::vector<std::string> tokens;
+        std::string token;
+        while (fields >> token)
+        {
+            tokens.push_back(token);
+        }
+
+        if (tokens.empty() == true)
+        {
+            continue;
+        }
+        else if (tokens.size() == 2 && isInMotor == true)
+        {
+            ThrustPoint point;
+            if (ParseNumber(tokens[0], point.time) == false || ParseNumber(tokens[1], point.thrust) == false)
+            {
+                return MOTOR_FILE_INVALID;
+            }
+            curve.push_back(point);
+        }
+        else if (tokens.size() >= 7)
+        {
+            // Name, diameter, length, delays, propellant mass, total mass, manufacturer.
+            if (finish() == false)
+            {
+                return MOTOR_FILE_INVALID;
+            }
+            header = tokens;
+            curve.clear();
+            isInMotor = true;
+        }
+        else
+        {
+            return MOTOR_FILE_INVALID;
+        }
+    }
+
+    if (finish() == false || motors.size() == firstMotor)
+    {
+        return MOTOR_FILE_INVALID;
+    }
+    return MOTOR_FILE_OK;
+}
+
+MotorFileStatus_t ParseRseMotors(const std::string& text, std::vector<Motor>& motors)
+{
+    const size_t firstMotor = motors.size();
+    size_t position = 0;
+    while ((position = FindElement(text, "engine", position, text.size())) != std::string::npos)
+    {
+        const size_t tagEnd = text.find('>', position);
+        const size_t engineEnd = text.find("</engine>", position);
+        if (tagEnd == std::string::npos || engineEnd == std::string::npos)
+        {
+            return MOTOR_FILE_INVALID;
+        }
+        const std::string tag = text.substr(position, tagEnd - position);
+
+        std::string name;
+        std::string manufacturer;
+        std::string value;
+        double diameter = 0.0;
+        double length = 0.0;
+        double propellantMass = 0.0;
+        double totalMass = 0.0;
+        if (GetAttribute(tag, "code", name) == false ||
+            GetAttribute(tag, "propWt", value) == false || ParseNumber(value, propellantMass) == false ||
+            GetAttribute(tag, "initWt", value) == false || ParseNumber(value, totalMass) == false)
+        {
+            return MOTOR_FILE_INVALID;
+        }
+        GetAttribute(tag, "mfg", manufacturer);
+        if (GetAttribute(tag, "dia", value) == true && ParseNumber(value, diameter) == false)
+        {
+            return MOTOR_FILE_INVALID;
+        }
+        if (GetAttribute(tag, "len", value) == true && ParseNumber(value, length) == false)
+        {
+            return MOTOR_FILE_INVALID;
+        }
+
+        std::vector<ThrustPoint> curve;
+        size_t data = tagEnd;
+        while ((data = FindElement(text, "eng-data", data, engineEnd)) != std::string::npos)
+        {
+            const size_t dataEnd = text.find('>', data);
+            const std::string dataTag = text.substr(data, dataEnd - data);
+            ThrustPoint point;
+            std::string time;
+            std::string thrust;
+            if (GetAttribute(dataTag, "t", time) == false || ParseNumber(time, point.time) == false ||
+                GetAttribute(dataTag, "f", thrust) == false || ParseNumber(thrust, point.thrust) == false)
+            {
+                return MOTOR_FILE_INVALID;
+            }
+            curve.push_back(point);
+            data = dataEnd;
+        }
+
+        // RockSim weighs in grams.
+        propellantMass /= 1000.0;
+        totalMass /= 1000.0;
+        if (IsValidMotor(curve, propellantMass, totalMass) == false)
+        {
+            return MOTOR_FILE_INVALID;
+        }
+        motors.emplace_back(name, manufacturer, diameter / 1000.0, length / 1000.0, propellantMass, totalMass, curve);
+        position = engineEnd;
+    }
+
+    return motors.size() > firstMotor ? MOTOR_FILE_OK : MOTOR_FILE_INVALID;
+}
+
+MotorFileStatus_t ReadMotorFile(const std::string& path, std::vector<Motor>& motors)
+{
+    std::string extension = path.size() >= 4 ? path.substr(path.size() - 4) : "";
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+    if (extension != ".eng" && extension != ".rse")
+    {
+        return MOTOR_FILE_UNKNOWN_FORMAT;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (file.is_open() == false)
+    {
+        return MOTOR_FILE_UNREADABLE;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+
+    return extension == ".eng" ? ParseEngMotors(text.str(), motors) : ParseRseMotors(text.str(), motors);
+}
+
+const char* GetMotorFileStatusName(MotorFileStatus_t status)
+{
+    static const char* names[] = { "OK", "Unreadable", "Unknown format", "Invalid" };
+    return status <= MOTOR_FILE_INVALID ? names[status] : "Unknown";
+}
+
+namespace MotorLibrary
+{
+struct Library
+{
+    std::mutex mutex;
+    // Each motor has its own allocation, so that loading more never moves the ones borrowed.
+    std::vector<std::unique_ptr<const Motor>> motors;
+};
+
+static Library& GetLibrary()
+{
+    static Library library;
+    return library;
+}
+
+MotorFileStatus_t Load(const std::string& path, std::vector<const Motor*>* loaded)
+{
+    std::vector<Motor> motors;
+    const MotorFileStatus_t status = ReadMotorFile(path, motors);
+    if (status != MOTOR_FILE_OK)
+    {
+        return status;
+    }
+
+    Library& library = GetLibrary();
+    std::lock_guard<std::mutex> lock(library.mutex);
+    for (Motor& motor : motors)
+    {
+        auto existing = std::find_if(library.motors.begin(), library.motors.end(), [&motor](const std::unique_ptr<const Motor>& other)
+                                     {
+                                         return IsSameName(other->Name(), motor.Name()) == true &&
+                                             IsSameName(other->Manufacturer(), motor.Manufacturer()) == true;
+                                     });
+        if (existing == library.motors.end())
+        {
+            library.motors.push_back(std::make_unique<const Motor>(std::move(motor)));
+            existing = library.motors.end() - 1;
+        }
+        if (loaded != nullptr)
+        {
+            loaded->push_back(existing->get());
+        }
+    }
+    return MOTOR_FILE_OK;
+}
+
+const Motor* Find(const std::string& name, const std::string& manufacturer)
+{
+    Library& library = GetLibrary();
+    std::lock_guard<std::mutex> lock(library.mutex);
+    for (const std::unique_ptr<const Motor>& motor : library.motors)
+    {
+        if (IsSameName(motor->Name(), name) == true &&
+            (manufacturer.empty() == true || IsSameName(motor->Manufacturer(), manufacturer) == true))
+        {
+            return motor.get();
+        }
+    }
+    return nullptr;
+}
+
+std::vector<const Motor*> GetMotors()
+{
+    Library& library = GetLibrary();
+    std::lock_guard<std::mutex> lock(library.mutex);
+    std::vector<const Motor*> motors;
+    for (const std::unique_ptr<const Motor>& motor : library.motors)
+    {
+        motors.push_back(motor.get());
+    }
+    return motors;
+}
+}
+
+static bool ParseNumber(const std::string& text, double& value)
+{
+    std::istringstream stream(text);
+    stream >> value;
+    return stream.fail() == false && (stream >> std::ws).eof() == true && std::isfinite(value) == true;
+}
+
+/**
+ * @brief   Check that a curve goes forward in time and pushes, and that the masses make sense.
+ */
+static bool IsValidMotor(const std::vector<ThrustPoint>& curve, double propellantMass, double totalMass)
+{
+    if (curve.empty() == true || curve.back().time <= 0.0 || propellantMass <= 0.0 || totalMass < propellantMass)
+    {
+        return false;
+    }
+    double impulse = 0.0;
+    for (size_t i = 0; i < curve.size(); i++)
+    {
+        if (curve[i].time < 0.0 || curve[i].thrust < 0.0 || (i > 0 && curve[i].time < curve[i - 1].time))
+        {
+            return false;
+        }
+        impulse += curve[i].thrust;
+    }
+    return impulse > 0.0;
+}
+
+/**
+ * @brief   Find the next opening tag of an XML element, between start and end.
+ * @retval  The position of its '<', npos if there is none.
+ */
+static size_t FindElement(const std::string& text, const std::string& name, size_t start, size_t end)
+{
+    const std::string opening = "<" + name;
+    for (size_t position = text.find(opening, start); position < end; position = text.find(opening, position + 1))
+    {
+        const size_t next = position + opening.size();
+        if (next < text.size() && (std::isspace((unsigned char)text[next]) != 0 || text[next] == '/' || text[next] == '>'))
+        {
+            return position;
+        }
+    }
+    return std::string::npos;
+}
+
+/**
+ * @brief   Get the value of an attribute in the text of an XML tag, quoted with " or '.
+ * @retval  False if the tag doesn't have it.
+ */
+static bool GetAttribute(const std::string& tag, const std::string& name, std::string& value)
+{
+    for (size_t position = tag.find(name); position != std::string::npos; position = tag.find(name, position + 1))
+    {
+        if (position == 0 || std::isspace((unsigned char)tag[position - 1]) == 0)
+        {
+            continue;
+        }
+        size_t next = position + name.size();
+        while (next < tag.size() && std::isspace((unsigned char)tag[next]) != 0)
+        {
+            next++;
+        }
+        if (next >= tag.size() || tag[next] != '=')
+        {
+            continue;
+        }
+        next++;
+        while (next < tag.size() && std::isspace((unsigned char)tag[next]) != 0)
+        {
+            next++;
+        }
+        if (next >= tag.size() || (tag[next] != '"' && tag[next] != '\''))
+        {
+            return false;
+        }
+        const size_t close = tag.find(tag[next], next + 1);
+        if (close == std::string::npos)
+        {
+            return false;
+        }
+        value = tag.substr(next + 1, close - next - 1);
+        return true;
+    }
+    return false;
+}
+
+static bool IsSameName(const std::string& a, const std::string& b)
+{
+    return a.size() == b.size() &&
+        std::equal(a.begin(), a.end(), b.begin(), [](unsigned char x, unsigned char y) { return std::tolower(x) == std::tolower(y); });
+}
+}
@@ -0,0 +1,245 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Simulation
+{
+typedef enum
+{
+    MOTOR_FILE_OK = 0,
+    MOTOR_FILE_UNREADABLE,              //!< The file can't be opened.
+    MOTOR_FILE_UNKNOWN_FORMAT,          //!< Neither .eng nor .rse.
+    MOTOR_FILE_INVALID,                 //!< A motor is malformed, or the file has none.
+} MotorFileStatus_t;
+
+struct ThrustPoint
+{
+    double time = 0.0;                  //!< s from ignition.
+    double thrust = 0.0;                //!< N.
+};
+
+/**
+ * @class   Motor
+ * @brief   A solid rocket motor, with its thrust curve resampled on SAMPLE_COUNT equal intervals
+ *          of its burn. The thrust, the impulse delivered and the propellant left at a time are
+ *          then read from their tables at an index computed from the time, without searching
+ *          the curve.
+ *          The propellant burns in proportion to the impulse delivered, like in RASP.
+ *          A Motor never changes once built: the simulations of every thread read it at once.
+ *          Lengths are in m, masses in kg, times in s from ignition, thrusts in N and impulses in N s,
+ *          the masses being of the propellant, or of the loaded motor, case included.
+ */
+class Motor
+{
+public:
+    static constexpr size_t SAMPLE_COUNT = 1024;
+
+    /**
+     * @param   curve: The points of the thrust curve, by increasing time, linear in between.
+     *          It starts from 0 thrust at ignition, and ends at the burnout, the time of its last point.
+     */
+    Motor(const std::string& name, const std::string& manufacturer, double diameter, double length,
+          double propellantMass, double totalMass, std::vector<ThrustPoint> curve);
+
+    inline const std::string& Name() const
+    {
+        return m_name;
+    }
+    inline const std::string& Manufacturer() const
+    {
+        return m_manufacturer;
+    }
+    inline double Diameter() const
+    {
+        return m_diameter;
+    }
+    inline double Length() const
+    {
+        return m_length;
+    }
+    inline double PropellantMass() const
+    {
+        return m_propellantMass;
+    }
+    inline double TotalMass() const
+    {
+        return m_totalMass;
+    }
+    inline double BurnTime() const
+    {
+        return m_burnTime;
+    }
+    inline double TotalImpulse() const
+    {
+        return m_impulse.back();
+    }
+    inline double AverageThrust() const
+    {
+        return TotalImpulse() / m_burnTime;
+    }
+    inline double MaxThrust() const
+    {
+        return m_maxThrust;
+    }
+    /**
+     * @brief   Get the times of the samples where the slope of the thrust changes. A flight isn't
+     *          smooth there, its integration should stop on them rather than step across.
+     */
+    inline const std::vector<double>& Bends() const
+    {
+        return m_bends;
+    }
+
+    /**
+     * @brief   Get the first bend after a time, or the burnout if there is none.
+     */
+    inline double GetNextBend(double time) const
+    {
+        auto bend = std::upper_bound(m_bends.begin(), m_bends.end(), time);
+        return bend != m_bends.end() ? *bend : m_burnTime;
+    }
+
+    /**
+     * @brief   Get the thrust at a time, held at its ends outside of the burn.
+     */
+    inline double GetThrust(double time) const
+    {
+        size_t index;
+        const double fraction = GetSample(time, index);
+        return m_thrust[index] + (fraction * (m_thrust[index + 1] - m_thrust[index]));
+    }
+
+    /**
+     * @brief   Get the impulse delivered from ignition to a time.
+     */
+    inline double GetImpulse(double time) const
+    {
+        size_t index;
+        const double fraction = GetSample(time, index);
+        return m_impulse[index] + GetPartialImpulse(index, fraction);
+    }
+
+    /**
+     * @brief   Get the mass of propellant left at a time.
+     */
+    inline double GetPropellantMass(double time) const
+    {
+        size_t index;
+        const double fraction = GetSample(time, index);
+        return m_propellant[index] - (m_massPerImpulse * GetPartialImpulse(index, fraction));
+    }
+
+    /**
+     * @brief   Get the rate the propellant burns at a time, in kg/s.
+     */
+    inline double GetMassFlow(double time) const
+    {
+        return m_massPerImpulse * GetThrust(time);
+    }
+
+    /**
+     * @brief   Get the SAMPLE_COUNT + 1 samples of the thrust, for the code reading them like GetThrust
+     *          without calling it, e.g. many motors at once.
+     */
+    inline const std::vector<double>& ThrustSamples() const
+    {
+        return m_thrust;
+    }
+    /**
+     * @brief   Get the samples per second of the burn.
+     */
+    inline double InverseStep() const
+    {
+        return m_inverseStep;
+    }
+    /**
+     * @brief   Get the mass of propellant burnt per impulse delivered, in kg/(N s).
+     */
+    inline double MassPerImpulse() const
+    {
+        return m_massPerImpulse;
+    }
+
+private:
+    /**
+     * @brief   Get the interval of the samples that holds a time, clamped to the burn.
+     * @retval  The fraction of the interval before the time.
+     */
+    inline double GetSample(double time, size_t& index) const
+    {
+        const double position = std::max(0.0, std::min(time * m_inverseStep, double(SAMPLE_COUNT)));
+        index = std::min(size_t(position), SAMPLE_COUNT - 1);
+        return position - double(index);
+    }
+    inline double GetPartialImpulse(size_t index, double fraction) const
+    {
+        return fraction * m_step * (m_thrust[index] + (0.5 * fraction * (m_thrust[index + 1] - m_thrust[index])));
+    }
+
+private:
+    std::string m_name = "";
+    std::string m_manufacturer = "";
+    double m_diameter = 0.0;
+    double m_length = 0.0;
+    double m_propellantMass = 0.0;
+    double m_totalMass = 0.0;
+    double m_burnTime = 0.0;
+    double m_maxThrust = 0.0;
+    double m_step = 0.0;                //!< s between samples.
+    double m_inverseStep = 0.0;
+    double m_massPerImpulse = 0.0;      //!< kg of propellant burnt per N s.
+
+    // SAMPLE_COUNT + 1 samples, from ignition to burnout.
+    std::vector<double> m_thrust = std::vector<double>();
+    std::vector<double> m_impulse = std::vector<double>();      //!< Delivered since ignition.
+    std::vector<double> m_propellant = std::vector<double>();   //!< Left.
+    std::vector<double> m_bends = std::vector<double>();
+};
+
+/**
+ * @brief   Read the motors of a RASP .eng file: a header line per motor (name, diameter and
+ *          length in mm, delays, propellant and total mass in kg, manufacturer), then a line
+ *          per point of its curve (time in s, thrust in N). Comments start with ';'.
+ */
+MotorFileStatus_t ParseEngMotors(const std::string& text, std::vector<Motor>& motors);
+
+/**
+ * @brief   Read the motors of a RockSim .rse file: an engine element per motor, its attributes
+ *          code, mfg, dia and len in mm, propWt and initWt in g, and an eng-data element per point
+ *          of its curve, with attributes t in s and f in N.
+ */
+MotorFileStatus_t ParseRseMotors(const std::string& text, std::vector<Motor>& motors);
+
+/**
+ * @brief   Read the motors of a .eng or .rse file, by its extension.
+ */
+MotorFileStatus_t ReadMotorFile(const std::string& path, std::vector<Motor>& motors);
+
+const char* GetMotorFileStatusName(MotorFileStatus_t status);
+
+/**
+ * The motors loaded by the process, shared by every thread.
+ * A motor is parsed and resampled once, then every simulation borrows it. Motors are never
+ * removed nor changed, so a borrowed motor stays valid until the process exits, and can be
+ * read without locking. Loading takes a lock, and may run along simulations.
+ */
+namespace MotorLibrary
+{
+/**
+ * @brief   Load the motors of a .eng or .rse file. A motor already in the library, of the same
+ *          manufacturer and name, is kept instead of the one of the file.
+ * @param   loaded: If not null, filled with the motors of the file, in its order.
+ */
+MotorFileStatus_t Load(const std::string& path, std::vector<const Motor*>* loaded = nullptr);
+
+/**
+ * @brief   Find a motor by name, and manufacturer if not empty, case insensitive.
+ * @retval  The first motor loaded that matches, nullptr if none.
+ */
+const Motor* Find(const std::string& name, const std::string& manufacturer = "");
+
+std::vector<const Motor*> GetMotors();
+}
+}
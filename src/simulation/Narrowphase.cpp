@@ -0,0 +1,203 @@
+#include "Narrowphase.h"
+#include "utils/JobSystem.h"
+
+namespace Simulation
+{
+static inline float GetArea(const Renderer::Aabb& bounds)
+{
+    return (bounds.max.x - bounds.min.x) * (bounds.max.y - bounds.min.y);
+}
+
+void Narrowphase::Update(const EntityStore& entities, const std::vector<ProxyPair>& pairs)
+{
+    m_manifolds.clear();
+    m_contacts.clear();
+    m_shapes.resize(entities.IndexCount());
+
+    // Shapes are built in order, then the entities of the pairs are placed in parallel, once each.
+    m_isPlacing.assign(entities.IndexCount(), false);
+    m_placing.clear();
+    for (const ProxyPair& pair : pairs)
+    {
+        for (unsigned int index : { pair.first, pair.second })
+        {
+            if (m_isPlacing[index] == false)
+            {
+                m_isPlacing[index] = true;
+                m_placing.push_back(index);
+                PrepareShape(entities, index);
+            }
+        }
+    }
+    Jobs::ParallelFor(m_placing.size(), PLACE_GRAIN, [&](size_t begin, size_t end)
+                      {
+                          for (size_t i = begin; i < end; i++)
+                          {
+                              m_shapes[m_placing[i]].SetTransform(entities.GetCollisionTransform(m_placing[i]));
+                          }
+                      });
+
+    // Every range of pairs is tested into its own contacts, joined afterwards in the order of the pairs.
+    const size_t chunkCount = (pairs.size() + PAIR_GRAIN - 1) / PAIR_GRAIN;
+    if (m_chunks.size() < chunkCount)
+    {
+        m_chunks.resize(chunkCount);
+    }
+    Jobs::ParallelFor(pairs.size(), PAIR_GRAIN, [&](size_t begin, size_t end)
+                      {
+                          PairChunk& chunk = m_chunks[begin / PAIR_GRAIN];
+                          chunk.contacts.clear();
+                          chunk.manifolds.clear();
+                          for (size_t i = begin; i < end; i++)
+                          {
+                              const ProxyPair& pair = pairs[i];
+                              const size_t first = chunk.contacts.size();
+                              if (Collide(m_shapes[pair.first], m_shapes[pair.second], chunk.contacts, chunk.stack) == 0)
+                              {
+                                  continue;
+                              }
+
+                              ContactManifold manifold;
+                              manifold.entityA = pair.first;
+                              manifold.entityB = pair.second;
+                              manifold.firstContact = first;
+                              manifold.contactCount = chunk.contacts.size() - first;
+                              for (size_t c = first; c < chunk.contacts.size(); c++)
+                              {
+                                  manifold.depth = chunk.contacts[c].depth > manifold.depth ? chunk.contacts[c].depth : manifold.depth;
+                              }
+                              chunk.manifolds.push_back(manifold);
+                          }
+                      });
+
+    for (size_t c = 0; c < chunkCount; c++)
+    {
+        const PairChunk& chunk = m_chunks[c];
+        const size_t offset = m_contacts.size();
+        m_contacts.insert(m_contacts.end(), chunk.contacts.begin(), chunk.contacts.end());
+        for (ContactManifold manifold : chunk.manifolds)
+        {
+            manifold.firstContact += offset;
+            m_manifolds.push_back(manifold);
+        }
+    }
+}
+
+size_t Narrowphase::Collide(const CollisionShape& a, const CollisionShape& b, std::vector<Contact>& out)
+{
+    return Collide(a, b, out, m_stack);
+}
+
+size_t Narrowphase::Collide(const CollisionShape& a, const CollisionShape& b, std::vector<Contact>& out,
+                            std::vector<std::pair<unsigned int, unsigned int>>& stack) const
+{
+    const Array<Renderer::BvhNode>& nodesA = a.GetBvh().Nodes();
+    const Array<Renderer::BvhNode>& nodesB = b.GetBvh().Nodes();
+    const size_t first = out.size();
+    if (nodesA.empty() == true || nodesB.empty() == true)
+    {
+        return 0;
+    }
+
+    stack.clear();
+    stack.emplace_back(0, 0);
+    while (stack.empty() == false)
+    {
+        const std::pair<unsigned int, unsigned int> visit = stack.back();
+        stack.pop_back();
+        const Renderer::BvhNode& nodeA = nodesA[visit.first];
+        const Renderer::BvhNode& nodeB = nodesB[visit.second];
+        if (nodeA.bounds.Overlaps(nodeB.bounds) == false)
+        {
+            continue;
+        }
+
+        if (nodeA.IsLeaf() == true && nodeB.IsLeaf() == true)
+        {
+            TestLeaves(a, visit.first, b, visit.second, out);
+        }
+        else if (nodeB.IsLeaf() == true || (nodeA.IsLeaf() == false && GetArea(nodeA.bounds) >= GetArea(nodeB.bounds)))
+        {
+            // Descend the larger node first, it prunes the most.
+            stack.emplace_back(nodeA.first + 1, visit.second);
+            stack.emplace_back(nodeA.first, visit.second);
+        }
+        else
+        {
+            stack.emplace_back(visit.first, nodeB.first + 1);
+            stack.emplace_back(visit.first, nodeB.first);
+        }
+    }
+    return out.size() - first;
+}
+
+const CollisionShape& Narrowphase::GetShape(const EntityStore& entities, unsigned int index)
+{
+    CollisionShape& shape = PrepareShape(entities, index);
+    shape.SetTransform(entities.GetCollisionTransform(index));
+    return shape;
+}
+
+CollisionShape& Narrowphase::PrepareShape(const EntityStore& entities, unsigned int index)
+{
+    if (index >= m_shapes.size())
+    {
+        m_shapes.resize(size_t(index) + 1);
+    }
+    const std::shared_ptr<const Renderer::MeshGeometry>& geometry = entities.GetBody(index).geometry;
+    CollisionShape& shape = m_shapes[index];
+    if (shape.Geometry() != geometry)
+    {
+        auto it = m_prototypes.find(geometry.get());
+        if (it == m_prototypes.end() || it->second.Geometry() != geometry)
+        {
+            // The prototype keeps its geometry alive, so a geometry's address can't be reused while it's cached.
+            it = m_prototypes.insert_or_assign(geometry.get(), CollisionShape(geometry)).first;
+        }
+        shape = it->second;
+    }
+    return shape;
+}
+
+void Narrowphase::TestLeaves(const CollisionShape& a, unsigned int leafA, const CollisionShape& b, unsigned int leafB,
+                             std::vector<Contact>& out) const
+{
+    const TriangleBatch& batchA = a.GetBatch(leafA);
+    const TriangleBatch& batchB = b.GetBatch(leafB);
+    for (unsigned int lane = 0; lane < batchA.count; lane++)
+    {
+        const ImVec2 tri[3] = { ImVec2(batchA.x[0][lane], batchA.y[0][lane]),
+                                ImVec2(batchA.x[1][lane], batchA.y[1][lane]),
+                                ImVec2(batchA.x[2][lane], batchA.y[2][lane]) };
+        float depth[4];
+        ImVec2 normal[4];
+        unsigned int mask = TriangleTest::Overlap(tri, batchB, depth, normal);
+        for (unsigned int other = 0; mask != 0; other++, mask >>= 1)
+        {
+            if ((mask & 1) == 0)
+            {
+                continue;
+            }
+            // The vertex of B deepest inside A, moved halfway out.
+            const ImVec2& n = normal[other];
+            ImVec2 deepest = ImVec2(batchB.x[0][other], batchB.y[0][other]);
+            for (int v = 1; v < 3; v++)
+            {
+                const ImVec2 p = ImVec2(batchB.x[v][other], batchB.y[v][other]);
+                if ((p.x * n.x) + (p.y * n.y) < (deepest.x * n.x) + (deepest.y * n.y))
+                {
+                    deepest = p;
+                }
+            }
+
+            Contact contact;
+            contact.normal = n;
+            contact.depth = depth[other];
+            contact.point = ImVec2(deepest.x + (n.x * depth[other] * 0.5f), deepest.y + (n.y * depth[other] * 0.5f));
+            contact.triangleA = batchA.triangle[lane];
+            contact.triangleB = batchB.triangle[other];
+            out.push_back(contact);
+        }
+    }
+}
+}
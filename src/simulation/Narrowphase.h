@@ -0,0 +1,112 @@
+#pragma once
+#include "simulation/Broadphase.h"
+#include "simulation/CollisionShape.h"
+#include "simulation/EntityStore.h"
+#include <unordered_map>
+#include <vector>
+
+namespace Simulation
+{
+/**
+ * A point where two triangles overlap.
+ */
+struct Contact
+{
+    ImVec2 point = ImVec2();        //!< Midway through the overlap, in world coordinates.
+    ImVec2 normal = ImVec2();       //!< Unit axis along which the triangles separate fastest, from A towards B.
+    float depth = 0.0f;             //!< How far B must move along the normal to stop overlapping A.
+    unsigned int triangleA = 0;     //!< Index of the triangle in A's collision geometry.
+    unsigned int triangleB = 0;
+};
+
+/**
+ * The contacts between two entities, a range of Narrowphase::Contacts.
+ */
+struct ContactManifold
+{
+    unsigned int entityA = 0;
+    unsigned int entityB = 0;
+    size_t firstContact = 0;
+    size_t contactCount = 0;
+    float depth = 0.0f;             //!< Deepest penetration of the contacts.
+};
+
+/**
+ * @class   Narrowphase
+ * @brief   Exact collision tests between the collision meshes of the pairs found by the broadphase.
+ *          Each entity gets a CollisionShape, built once per geometry and shared between the entities
+ *          using it, then refitted whenever the entity moves. Both hierarchies are walked together,
+ *          and only the leaves whose bounds overlap have their triangles tested, 1 against 4 with
+ *          TriangleTest.
+ *          The shapes are placed, and the pairs tested, in parallel on the job system.
+ */
+class Narrowphase
+{
+public:
+    static constexpr size_t PLACE_GRAIN = 64;   //!< Shapes placed per job.
+    static constexpr size_t PAIR_GRAIN = 64;    //!< Pairs tested per job.
+
+    /**
+     * @brief   Find the contacts of every pair of entities.
+     * @param   entities: The entities, with the pairs' indices.
+     * @param   pairs: The pairs whose bounds overlap, see CollisionWorld::Pairs.
+     */
+    void Update(const EntityStore& entities, const std::vector<ProxyPair>& pairs);
+
+    /**
+     * @brief   Find the contacts between two placed shapes.
+     * @param   out: Where the contacts are appended.
+     * @retval  The number of contacts found.
+     */
+    size_t Collide(const CollisionShape& a, const CollisionShape& b, std::vector<Contact>& out);
+
+    /**
+     * @brief   Get the pairs of entities in contact after the last Update, in the order of the pairs.
+     */
+    inline const std::vector<ContactManifold>& Manifolds() const
+    {
+        return m_manifolds;
+    }
+    inline const std::vector<Contact>& Contacts() const
+    {
+        return m_contacts;
+    }
+
+    /**
+     * @brief   Get the shape of an entity, placed at its current position.
+     */
+    const CollisionShape& GetShape(const EntityStore& entities, unsigned int index);
+
+private:
+    /**
+     * @brief   The contacts found by a job, over a range of pairs.
+     */
+    struct PairChunk
+    {
+        std::vector<Contact> contacts = std::vector<Contact>();
+        std::vector<ContactManifold> manifolds = std::vector<ContactManifold>();
+        std::vector<std::pair<unsigned int, unsigned int>> stack = std::vector<std::pair<unsigned int, unsigned int>>();
+    };
+
+    /**
+     * @brief   Give an entity the shape of its geometry, without placing it.
+     */
+    CollisionShape& PrepareShape(const EntityStore& entities, unsigned int index);
+    size_t Collide(const CollisionShape& a, const CollisionShape& b, std::vector<Contact>& out,
+                   std::vector<std::pair<unsigned int, unsigned int>>& stack) const;
+    void TestLeaves(const CollisionShape& a, unsigned int leafA, const CollisionShape& b, unsigned int leafB,
+                    std::vector<Contact>& out) const;
+
+private:
+    std::vector<CollisionShape> m_shapes = std::vector<CollisionShape>();   //!< Shape of every entity, by index.
+    //! First shape built for every geometry, copied for the other entities using it.
+    std::unordered_map<const Renderer::MeshGeometry*, CollisionShape> m_prototypes =
+        std::unordered_map<const Renderer::MeshGeometry*, CollisionShape>();
+    std::vector<ContactManifold> m_manifolds = std::vector<ContactManifold>();
+    std::vector<Contact> m_contacts = std::vector<Contact>();
+    std::vector<std::pair<unsigned int, unsigned int>> m_stack = std::vector<std::pair<unsigned int, unsigned int>>(); //!< Scratch, node pairs to visit.
+    std::vector<PairChunk> m_chunks = std::vector<PairChunk>();         //!< Scratch of every job testing pairs.
+    std::vector<unsigned int> m_placing = std::vector<unsigned int>();  //!< Entities of the pairs, to place.
+    std::vector<bool> m_isPlacing = std::vector<bool>();                //!< For every entity, if it's in m_placing.
+};
+}
@@ -0,0 +1,62 @@
+#include "PhysicsThread.h"
+#include <chrono>
+
+namespace Simulation
+{
+PhysicsThread::~PhysicsThread()
+{
+    Stop();
+}
+
+void PhysicsThread::Start()
+{
+    if (IsRunning() == true)
+    {
+        return;
+    }
+    m_quit = false;
+    m_thread = std::thread(&PhysicsThread::ThreadMain, this);
+}
+
+void PhysicsThread::Stop()
+{
+    if (IsRunning() == false)
+    {
+        return;
+    }
+    m_quit = true;
+    m_thread.join();
+}
+
+void PhysicsThread::Advance(double elapsed)
+{
+    if (m_world.Advance(elapsed) > 0)
+    {
+        Publish();
+    }
+}
+
+void PhysicsThread::Publish()
+{
+    m_world.WriteSnapshot(m_snapshots.Back());
+    m_snapshots.Publish();
+}
+
+void PhysicsThread::ThreadMain()
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::duration timestep = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(m_world.Timestep()));
+
+    Clock::time_point last = Clock::now();
+    while (m_quit == false)
+    {
+        const Clock::time_point now = Clock::now();
+        Advance(std::chrono::duration<double>(now - last).count());
+        last = now;
+
+        // A coarse system timer can oversleep a few steps, the accumulator catches up on the next batch.
+        std::this_thread::sleep_until(now + timestep);
+    }
+}
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "simulation/TripleBuffer.h"
+#include "simulation/World.h"
+#include <atomic>
+#include <thread>
+
+namespace Simulation
+{
+/**
+ * @class   PhysicsThread
+ * @brief   Steps a World on its own thread at its fixed time step, in real time, independently
+ *          of the render loop: neither vsync nor slow UI frames change the rate of the physics
+ *          nor the resulting motion.
+ *          After each batch of steps, a snapshot of the world is published through a triple
+ *          buffer that the render thread reads with Latest, without ever locking or waiting.
+ *
+ *          While the thread is stopped, the world belongs to the caller again: it can be edited
+ *          through GetWorld, or advanced on the caller's thread with Advance (e.g. on virtual time
+ *          for a headless export).
+ */
+class PhysicsThread
+{
+public:
+    PhysicsThread() = default;
+    explicit PhysicsThread(World world) : m_world(std::move(world))
+    {
+        Publish();
+    }
+    ~PhysicsThread();
+    PhysicsThread(const PhysicsThread&) = delete;
+    PhysicsThread& operator=(const PhysicsThread&) = delete;
+
+    /**
+     * @brief   Start stepping the world in real time on the physics thread.
+     */
+    void Start();
+    /**
+     * @brief   Stop the physics thread and wait for it to finish its current batch of steps.
+     */
+    void Stop();
+    inline bool IsRunning() const
+    {
+        return m_thread.joinable();
+    }
+
+    /**
+     * @brief   Advance the world on the caller's thread and publish its snapshot. Only while stopped.
+     * @param   elapsed: The time elapsed, in seconds, see World::Advance.
+     */
+    void Advance(double elapsed);
+
+    /**
+     * @brief   Publish the snapshot of the world, after editing it. Only while stopped.
+     */
+    void Publish();
+
+    /**
+     * @brief   Get the latest snapshot of the world. Only from a single (render) thread.
+     *          The snapshot stays valid and unchanged until the next call.
+     */
+    inline const WorldSnapshot& Latest()
+    {
+        m_snapshots.Acquire();
+        return m_snapshots.Front();
+    }
+
+    /**
+     * @brief   Get the entities, to draw them from a single (render) thread, even while running:
+     *          the physics thread never adds, removes nor moves rows, and never touches the visuals
+     *          nor the shared meshes. Only the indices, visuals and meshes may be used while running,
+     *          the positions come from Latest.
+     */
+    inline EntityStore& DrawnEntities()
+    {
+        return m_world.Entities();
+    }
+
+    /**
+     * @brief   Get the world. Only while stopped.
+     */
+    inline World& GetWorld()
+    {
+        return m_world;
+    }
+
+private:
+    void ThreadMain();
+
+private:
+    World m_world = World();
+    TripleBuffer<WorldSnapshot> m_snapshots;
+    std::thread m_thread;
+    std::atomic<bool> m_quit = { false };
+};
+}
@@ -0,0 +1,242 @@
+#include "SweepAndPrune.h"
+#include <algorithm>
+
+namespace Simulation
+{
+void SweepAndPrune::AddProxy(unsigned int id, const Renderer::Aabb& bounds)
+{
+    // The id may still have endpoints from its removal.
+    Compact();
+    if (id >= m_proxies.size())
+    {
+        m_proxies.resize(id + 1);
+    }
+    Proxy& proxy = m_proxies[id];
+    proxy.bounds = bounds;
+    proxy.isActive = true;
+
+    // Append the endpoints at the end of the axes and sort them into place,
+    // which finds the overlaps of the new proxy like any other move.
+    for (int axis = 0; axis < 2; axis++)
+    {
+        std::vector<Endpoint>& endpoints = m_axes[axis];
+        endpoints.push_back(Endpoint { GetMin(bounds, axis), id << 1 });
+        endpoints.push_back(Endpoint { GetMax(bounds, axis), (id << 1) | 1 });
+        proxy.min[axis] = (unsigned int)endpoints.size() - 2;
+        proxy.max[axis] = (unsigned int)endpoints.size() - 1;
+        SortDown(axis, proxy.min[axis], Renderer::Aabb());
+        SortDown(axis, proxy.max[axis], Renderer::Aabb());
+    }
+}
+
+void SweepAndPrune::MoveProxy(unsigned int id, const Renderer::Aabb& bounds)
+{
+    Proxy& proxy = m_proxies[id];
+    const Renderer::Aabb previous = proxy.bounds;
+    proxy.bounds = bounds;
+
+    for (int axis = 0; axis < 2; axis++)
+    {
+        std::vector<Endpoint>& endpoints = m_axes[axis];
+        const float min = GetMin(bounds, axis);
+        const float max = GetMax(bounds, axis);
+        endpoints[proxy.min[axis]].value = min;
+        endpoints[proxy.max[axis]].value = max;
+
+        // Grow first, then shrink, so that the min never passes its own max.
+        if (min < GetMin(previous, axis))
+        {
+            SortDown(axis, proxy.min[axis], previous);
+        }
+        if (max > GetMax(previous, axis))
+        {
+            SortUp(axis, proxy.max[axis], previous);
+        }
+        if (min > GetMin(previous, axis))
+        {
+            SortUp(axis, proxy.min[axis], previous);
+        }
+        if (max < GetMax(previous, axis))
+        {
+            SortDown(axis, proxy.max[axis], previous);
+        }
+    }
+}
+
+void SweepAndPrune::RemoveProxy(unsigned int id)
+{
+    m_proxies[id].isActive = false;
+    m_hasRemovedProxies = true;
+}
+
+void SweepAndPrune::UpdatePairs(std::vector<ProxyPair>& added, std::vector<ProxyPair>& removed)
+{
+    Compact();
+    added.clear();
+    removed.clear();
+    for (const std::pair<const uint64_t, bool>& change : m_changed)
+    {
+        const bool overlaps = m_pairs.count(change.first) != 0;
+        if (overlaps == true && change.second == false)
+        {
+            added.push_back(GetKeyPair(change.first));
+        }
+        else if (overlaps == false && change.second == true)
+        {
+            removed.push_back(GetKeyPair(change.first));
+        }
+    }
+    m_changed.clear();
+    std::sort(added.begin(), added.end());
+    std::sort(removed.begin(), removed.end());
+}
+
+void SweepAndPrune::GetPairs(std::vector<ProxyPair>& out) const
+{
+    out.clear();
+    out.reserve(m_pairs.size());
+    for (uint64_t key : m_pairs)
+    {
+        out.push_back(GetKeyPair(key));
+    }
+    std::sort(out.begin(), out.end());
+}
+
+void SweepAndPrune::Compact()
+{
+    if (m_hasRemovedProxies == false)
+    {
+        return;
+    }
+    m_hasRemovedProxies = false;
+
+    for (int axis = 0; axis < 2; axis++)
+    {
+        std::vector<Endpoint>& endpoints = m_axes[axis];
+        endpoints.erase(std::remove_if(endpoints.begin(), endpoints.end(), [this](const Endpoint& endpoint)
+                                       {
+                                           return m_proxies[endpoint.Proxy()].isActive == false;
+                                       }), endpoints.end());
+        for (unsigned int i = 0; i < endpoints.size(); i++)
+        {
+            SetEndpointIndex(axis, endpoints[i], i);
+        }
+    }
+
+    for (std::unordered_set<uint64_t>::iterator it = m_pairs.begin(); it != m_pairs.end();)
+    {
+        const ProxyPair pair = GetKeyPair(*it);
+        if (m_proxies[pair.first].isActive == false || m_proxies[pair.second].isActive == false)
+        {
+            m_changed.emplace(*it, true);
+            it = m_pairs.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+/**
+ * A pair can only exist if the boxes overlapped before the move, which is checked first to avoid
+ * looking up the pairs on every swap. Pairs added earlier in the same move overlap on both axes,
+ * so they never get a removal from a later swap.
+ */
+void SweepAndPrune::SortDown(int axis, unsigned int index, const Renderer::Aabb& previous)
+{
+    std::vector<Endpoint>& endpoints = m_axes[axis];
+    const Endpoint moving = endpoints[index];
+    const Proxy& proxy = m_proxies[moving.Proxy()];
+    while (index > 0 && IsBefore(moving, endpoints[index - 1]) == true)
+    {
+        const Endpoint& other = endpoints[index - 1];
+        const Proxy& otherProxy = m_proxies[other.Proxy()];
+        if (moving.IsMax() != other.IsMax() && otherProxy.isActive == true)
+        {
+            if (moving.IsMax() == false)
+            {
+                // A min passing a max downwards: the intervals start overlapping on this axis.
+                if (proxy.bounds.Overlaps(otherProxy.bounds) == true)
+                {
+                    AddPair(moving.Proxy(), other.Proxy());
+                }
+            }
+            else if (previous.Overlaps(otherProxy.bounds) == true)
+            {
+                // A max passing a min downwards: the intervals stop overlapping.
+                RemovePair(moving.Proxy(), other.Proxy());
+            }
+        }
+        endpoints[index] = other;
+        SetEndpointIndex(axis, other, index);
+        index--;
+    }
+    endpoints[index] = moving;
+    SetEndpointIndex(axis, moving, index);
+}
+
+void SweepAndPrune::SortUp(int axis, unsigned int index, const Renderer::Aabb& previous)
+{
+    std::vector<Endpoint>& endpoints = m_axes[axis];
+    const Endpoint moving = endpoints[index];
+    const Proxy& proxy = m_proxies[moving.Proxy()];
+    while (index + 1 < endpoints.size() && IsBefore(endpoints[index + 1], moving) == true)
+    {
+        const Endpoint& other = endpoints[index + 1];
+        const Proxy& otherProxy = m_proxies[other.Proxy()];
+        if (moving.IsMax() != other.IsMax() && otherProxy.isActive == true)
+        {
+            if (moving.IsMax() == true)
+            {
+                // A max passing a min upwards: the intervals start overlapping on this axis.
+                if (proxy.bounds.Overlaps(otherProxy.bounds) == true)
+                {
+                    AddPair(moving.Proxy(), other.Proxy());
+                }
+            }
+            else if (previous.Overlaps(otherProxy.bounds) == true)
+            {
+                // A min passing a max upwards: the intervals stop overlapping.
+                RemovePair(moving.Proxy(), other.Proxy());
+            }
+        }
+        endpoints[index] = other;
+        SetEndpointIndex(axis, other, index);
+        index++;
+    }
+    endpoints[index] = moving;
+    SetEndpointIndex(axis, moving, index);
+}
+
+void SweepAndPrune::SetEndpointIndex(int axis, const Endpoint& endpoint, unsigned int index)
+{
+    Proxy& proxy = m_proxies[endpoint.Proxy()];
+    if (endpoint.IsMax() == true)
+    {
+        proxy.max[axis] = index;
+    }
+    else
+    {
+        proxy.min[axis] = index;
+    }
+}
+
+void SweepAndPrune::AddPair(unsigned int a, unsigned int b)
+{
+    const uint64_t key = GetPairKey(MakeProxyPair(a, b));
+    if (m_pairs.insert(key).second == true)
+    {
+        m_changed.emplace(key, false);
+    }
+}
+
+void SweepAndPrune::RemovePair(unsigned int a, unsigned int b)
+{
+    const uint64_t key = GetPairKey(MakeProxyPair(a, b));
+    if (m_pairs.erase(key) != 0)
+    {
+        m_changed.emplace(key, true);
+    }
+}
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "simulation/Broadphase.h"
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Simulation
+{
+/**
+ * @class   SweepAndPrune
+ * @brief   Incremental sweep-and-prune broadphase.
+ *          The bounds of the proxies are kept as sorted lists of interval endpoints on both axes.
+ *          Moving a proxy only sorts its own endpoints into place with insertion sort, and a pair
+ *          can only start or stop overlapping when a min endpoint passes a max endpoint,
+ *          so the pairs are updated from those swaps alone.
+ *          When objects move a little from one step to the next, which is the common case, a
+ *          frame costs about O(n + changes). Fits best when objects are spread out and coherent;
+ *          objects teleporting across the world cost O(n) each.
+ *          Removed proxies are only taken out of the axes by the next UpdatePairs (or AddProxy),
+ *          all at once.
+ */
+class SweepAndPrune : public Broadphase
+{
+public:
+    void AddProxy(unsigned int id, const Renderer::Aabb& bounds) override;
+    void MoveProxy(unsigned int id, const Renderer::Aabb& bounds) override;
+    void RemoveProxy(unsigned int id) override;
+    void UpdatePairs(std::vector<ProxyPair>& added, std::vector<ProxyPair>& removed) override;
+    void GetPairs(std::vector<ProxyPair>& out) const override;
+
+private:
+    struct Endpoint
+    {
+        float value;
+        unsigned int data;      //!< Proxy id << 1, | 1 for a max endpoint.
+
+        inline unsigned int Proxy() const
+        {
+            return data >> 1;
+        }
+        inline bool IsMax() const
+        {
+            return (data & 1) != 0;
+        }
+    };
+
+    struct Proxy
+    {
+        Renderer::Aabb bounds;
+        unsigned int min[2] = { 0, 0 };     //!< Index of the min endpoint in each axis.
+        unsigned int max[2] = { 0, 0 };     //!< Index of the max endpoint in each axis.
+        bool isActive = false;
+    };
+
+    static inline float GetMin(const Renderer::Aabb& bounds, int axis)
+    {
+        return axis == 0 ? bounds.min.x : bounds.min.y;
+    }
+    static inline float GetMax(const Renderer::Aabb& bounds, int axis)
+    {
+        return axis == 0 ? bounds.max.x : bounds.max.y;
+    }
+    /**
+     * @brief   Whether endpoint a sorts before b. On equal values mins come first, so that touching intervals overlap.
+     */
+    static inline bool IsBefore(const Endpoint& a, const Endpoint& b)
+    {
+        return a.value < b.value || (a.value == b.value && a.IsMax() == false && b.IsMax() == true);
+    }
+
+    void SortDown(int axis, unsigned int index, const Renderer::Aabb& previous);
+    void SortUp(int axis, unsigned int index, const Renderer::Aabb& previous);
+    void Compact();
+    void SetEndpointIndex(int axis, const Endpoint& endpoint, unsigned int index);
+    void AddPair(unsigned int a, unsigned int b);
+    void RemovePair(unsigned int a, unsigned int b);
+
+private:
+    std::vector<Proxy> m_proxies = std::vector<Proxy>();
+    std::vector<Endpoint> m_axes[2] = { std::vector<Endpoint>(), std::vector<Endpoint>() };
+    bool m_hasRemovedProxies = false;   //!< Whether the axes still hold endpoints of removed proxies.
+    std::unordered_set<uint64_t> m_pairs = std::unordered_set<uint64_t>();
+    //! Pairs that changed during the frame, with whether they overlapped at the start of the frame.
+    std::unordered_map<uint64_t, bool> m_changed = std::unordered_map<uint64_t, bool>();
+};
+}
@@ -0,0 +1,241 @@
+#include "Symplectic.h"
+#include "simulation/DormandPrince.h"
+#include "simulation/Vector2d.h"
+#include "simulation/World.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace Simulation
+{
+static SymplecticScheme MakeYoshida4();
+
+// The orbit of the benchmark, in km and seconds.
+static constexpr double EARTH_MU = 398600.4418;     //!< km^3/s^2.
+static constexpr double SEMI_MAJOR_AXIS = 8000.0;
+static constexpr double ECCENTRICITY = 0.3;
+static constexpr double PI = 3.14159265358979323846;
+
+static Vector2d GetKeplerPosition(double t);
+static double GetEnergy(const Vector2d& position, const Vector2d& velocity);
+static Vector2d GetGravity(const Vector2d& position);
+
+const SymplecticScheme& GetSymplecticScheme(IntegratorType_t type)
+{
+    static const SymplecticScheme schemes[INTEGRATOR_COUNT] = {
+        SymplecticScheme { 2, { 0.0, 1.0 }, { 1.0, 0.0 } },
+        SymplecticScheme { 2, { 0.0, 1.0 }, { 0.5, 0.5 } },
+        MakeYoshida4(),
+    };
+    return schemes[type < INTEGRATOR_COUNT ? type : INTEGRATOR_SEMI_IMPLICIT_EULER];
+}
+
+const char* GetIntegratorName(IntegratorType_t type)
+{
+    static const char* names[INTEGRATOR_COUNT] = { "Semi-implicit Euler", "Velocity Verlet", "Yoshida 4" };
+    return type < INTEGRATOR_COUNT ? names[type] : "Unknown";
+}
+
+std::vector<OrbitBenchmarkResult> BenchmarkOrbit(double orbits)
+{
+    const double period = 2.0 * PI * std::sqrt((SEMI_MAJOR_AXIS * SEMI_MAJOR_AXIS * SEMI_MAJOR_AXIS) / EARTH_MU);
+    const double duration = orbits * period;
+    // Starts at periapsis.
+    const Vector2d startPosition = Vector2d(SEMI_MAJOR_AXIS * (1.0 - ECCENTRICITY), 0.0);
+    const Vector2d startVelocity = Vector2d(0.0, std::sqrt((EARTH_MU * (1.0 + ECCENTRICITY)) / (SEMI_MAJOR_AXIS * (1.0 - ECCENTRICITY))));
+    const double startEnergy = GetEnergy(startPosition, startVelocity);
+    const Vector2d exact = GetKeplerPosition(duration);
+
+    std::vector<OrbitBenchmarkResult> results;
+    auto finish = [&](OrbitBenchmarkResult& result, const Vector2d& position, const Vector2d& velocity,
+                      std::chrono::steady_clock::time_point start)
+    {
+        result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        result.finalEnergyError = std::abs((GetEnergy(position, velocity) - startEnergy) / startEnergy);
+        result.positionError = std::hypot(position.x - exact.x, position.y - exact.y);
+        results.push_back(result);
+    };
+
+    for (int type = 0; type < INTEGRATOR_COUNT; type++)
+    {
+        const SymplecticScheme& scheme = GetSymplecticScheme(IntegratorType_t(type));
+        unsigned int kickCount = 0;
+        for (unsigned int stage = 0; stage < scheme.stageCount; stage++)
+        {
+            kickCount += scheme.kick[stage] != 0.0 ? 1 : 0;
+        }
+        for (double step : { 120.0, 60.0, 30.0, 10.0 })
+        {
+            OrbitBenchmarkResult result;
+            result.method = GetIntegratorName(IntegratorType_t(type));
+            result.isThroughWorld = true;
+            result.step = step;
+            const size_t stepCount = size_t(std::ceil(duration / step));
+            World world = World(duration / double(stepCount));
+            world.Gravity(ImVec2());
+            world.GravityCenter(ImVec2());
+            world.GravitationalParameter(EARTH_MU);
+            world.Integrator(IntegratorType_t(type));
+            EntityStore& entities = world.Entities();
+            const unsigned int body = entities.Create(ENTITY_MOVEABLE | ENTITY_AFFECTED_BY_PHYSICS, ImVec2(), ImVec2(),
+                                                      1.0f, Renderer::Mesh(), Renderer::Mesh()).index;
+            entities.PrecisePosition(body, startPosition);
+            entities.PreciseVelocity(body, startVelocity);
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < stepCount; i++)
+            {
+                world.Step();
+                const double error = std::abs((GetEnergy(entities.PrecisePosition(body), entities.PreciseVelocity(body)) - startEnergy) / startEnergy);
+                result.maxEnergyError = std::max(result.maxEnergyError, error);
+            }
+            result.evaluations = stepCount * kickCount;
+            finish(result, entities.PrecisePosition(body), entities.PreciseVelocity(body), start);
+        }
+        for (double step : { 120.0, 60.0, 30.0, 10.0 })
+        {
+            OrbitBenchmarkResult result;
+            result.method = GetIntegratorName(IntegratorType_t(type));
+            result.step = step;
+            Vector2d position = startPosition;
+            Vector2d velocity = startVelocity;
+            const auto start = std::chrono::steady_clock::now();
+            const size_t stepCount = size_t(std::ceil(duration / step));
+            const double dt = duration / double(stepCount);
+            for (size_t i = 0; i < stepCount; i++)
+            {
+                SymplecticStep(scheme, &position, &velocity, 1, dt, [&result](const Vector2d& p)
+                               {
+                                   result.evaluations++;
+                                   return GetGravity(p);
+                               });
+                const double error = std::abs((GetEnergy(position, velocity) - startEnergy) / startEnergy);
+                result.maxEnergyError = std::max(result.maxEnergyError, error);
+            }
+            finish(result, position, velocity, start);
+        }
+    }
+
+    // Non-symplectic references, on the state { x, y, vx, vy }.
+    auto derivative = [](double, const double* y, double* dydt)
+    {
+        const Vector2d a = GetGravity(Vector2d(y[0], y[1]));
+        dydt[0] = y[2];
+        dydt[1] = y[3];
+        dydt[2] = a.x;
+        dydt[3] = a.y;
+    };
+    for (double step : { 60.0, 30.0, 10.0, 3.0 })
+    {
+        OrbitBenchmarkResult result;
+        result.method = "RK4";
+        result.step = step;
+        double y[4] = { startPosition.x, startPosition.y, startVelocity.x, startVelocity.y };
+        double k[4][4];
+        double stage[4];
+        const auto start = std::chrono::steady_clock::now();
+        const size_t stepCount = size_t(std::ceil(duration / step));
+        const double h = duration / double(stepCount);
+        for (size_t i = 0; i < stepCount; i++)
+        {
+            derivative(0.0, y, k[0]);
+            for (int j = 0; j < 4; j++)
+            {
+                stage[j] = y[j] + (0.5 * h * k[0][j]);
+            }
+            derivative(0.0, stage, k[1]);
+            for (int j = 0; j < 4; j++)
+            {
+                stage[j] = y[j] + (0.5 * h * k[1][j]);
+            }
+            derivative(0.0, stage, k[2]);
+            for (int j = 0; j < 4; j++)
+            {
+                stage[j] = y[j] + (h * k[2][j]);
+            }
+            derivative(0.0, stage, k[3]);
+            for (int j = 0; j < 4; j++)
+            {
+                y[j] += (h / 6.0) * (k[0][j] + (2.0 * k[1][j]) + (2.0 * k[2][j]) + k[3][j]);
+            }
+            result.evaluations += 4;
+            const double error = std::abs((GetEnergy(Vector2d(y[0], y[1]), Vector2d(y[2], y[3])) - startEnergy) / startEnergy);
+            result.maxEnergyError = std::max(result.maxEnergyError, error);
+        }
+        finish(result, Vector2d(y[0], y[1]), Vector2d(y[2], y[3]), start);
+    }
+
+    for (double tolerance : { 1e-6, 1e-9, 1e-12 })
+    {
+        OrbitBenchmarkResult result;
+        result.method = "Dormand-Prince";
+        result.tolerance = tolerance;
+        DormandPrince integrator(4);
+        // Positions in km, velocities in km/s.
+        integrator.Tolerances({ tolerance * 1e3, tolerance * 1e3, tolerance, tolerance }, { tolerance, tolerance, tolerance, tolerance });
+        double y[4] = { startPosition.x, startPosition.y, startVelocity.x, startVelocity.y };
+        double t = 0.0;
+        const auto start = std::chrono::steady_clock::now();
+        integrator.Integrate(derivative, t, duration, y, [&](double, const double* state)
+                             {
+                                 const double error = std::abs((GetEnergy(Vector2d(state[0], state[1]), Vector2d(state[2], state[3])) - startEnergy) / startEnergy);
+                                 result.maxEnergyError = std::max(result.maxEnergyError, error);
+                                 return true;
+                             });
+        result.evaluations = integrator.EvaluationCount();
+        finish(result, Vector2d(y[0], y[1]), Vector2d(y[2], y[3]), start);
+    }
+
+    return results;
+}
+
+static SymplecticScheme MakeYoshida4()
+{
+    // Yoshida, Construction of higher order symplectic integrators (1990).
+    const double cubeRoot2 = std::cbrt(2.0);
+    const double w1 = 1.0 / (2.0 - cubeRoot2);
+    const double w0 = -cubeRoot2 / (2.0 - cubeRoot2);
+    SymplecticScheme scheme;
+    scheme.stageCount = 4;
+    scheme.drift[0] = w1 / 2.0;
+    scheme.drift[1] = (w0 + w1) / 2.0;
+    scheme.drift[2] = (w0 + w1) / 2.0;
+    scheme.drift[3] = w1 / 2.0;
+    scheme.kick[0] = w1;
+    scheme.kick[1] = w0;
+    scheme.kick[2] = w1;
+    scheme.kick[3] = 0.0;
+    return scheme;
+}
+
+static Vector2d GetKeplerPosition(double t)
+{
+    // Solve Kepler's equation E - e sin(E) = M with Newton's method.
+    const double meanMotion = std::sqrt(EARTH_MU / (SEMI_MAJOR_AXIS * SEMI_MAJOR_AXIS * SEMI_MAJOR_AXIS));
+    const double meanAnomaly = std::fmod(meanMotion * t, 2.0 * PI);
+    double eccentricAnomaly = meanAnomaly;
+    for (int i = 0; i < 50; i++)
+    {
+        const double delta = (eccentricAnomaly - (ECCENTRICITY * std::sin(eccentricAnomaly)) - meanAnomaly) /
+            (1.0 - (ECCENTRICITY * std::cos(eccentricAnomaly)));
+        eccentricAnomaly -= delta;
+        if (std::abs(delta) < 1e-15)
+        {
+            break;
+        }
+    }
+    return Vector2d(SEMI_MAJOR_AXIS * (std::cos(eccentricAnomaly) - ECCENTRICITY),
+                    SEMI_MAJOR_AXIS * std::sqrt(1.0 - (ECCENTRICITY * ECCENTRICITY)) * std::sin(eccentricAnomaly));
+}
+
+static double GetEnergy(const Vector2d& position, const Vector2d& velocity)
+{
+    return (0.5 * ((velocity.x * velocity.x) + (velocity.y * velocity.y))) - (EARTH_MU / std::hypot(position.x, position.y));
+}
+
+static Vector2d GetGravity(const Vector2d& position)
+{
+    const double r2 = (position.x * position.x) + (position.y * position.y);
+    const double scale = -EARTH_MU / (r2 * std::sqrt(r2));
+    return Vector2d(position.x * scale, position.y * scale);
+}
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ * Symplectic integration of motion under a position-dependent acceleration (gravity).
+ * A step alternates drifts, moving the positions with the velocities, and kicks, changing the
+ * velocities with the acceleration at the positions. Such splittings preserve the geometry of
+ * the motion: the energy error stays bounded over any number of orbits instead of growing,
+ * so long coasts can take far larger steps than a non-symplectic scheme would need.
+ * Only up to the round-off of the state, which is why World integrates in double precision.
+ */
+namespace Simulation
+{
+typedef enum
+{
+    INTEGRATOR_SEMI_IMPLICIT_EULER = 0,     //!< 1st order, kick then drift. 1 acceleration per step.
+    INTEGRATOR_VELOCITY_VERLET,             //!< 2nd order, half kick, drift, half kick. 2 accelerations per step.
+    INTEGRATOR_YOSHIDA4,                    //!< 4th order, Yoshida's composition of Verlet. 3 accelerations per step.
+    INTEGRATOR_COUNT,
+} IntegratorType_t;
+
+/**
+ * The stages of a step: every stage drifts by drift * dt, then kicks by kick * dt.
+ */
+struct SymplecticScheme
+{
+    static constexpr unsigned int MAX_STAGES = 4;
+
+    unsigned int stageCount = 0;
+    double drift[MAX_STAGES] = {};
+    double kick[MAX_STAGES] = {};
+};
+
+const SymplecticScheme& GetSymplecticScheme(IntegratorType_t type);
+const char* GetIntegratorName(IntegratorType_t type);
+
+/**
+ * @brief   Step count bodies that don't interact, stage by stage.
+ * @param   positions: Vectors with x and y members.
+ * @param   acceleration: Called as acceleration(position), returns the acceleration there.
+ */
+template <typename Vec, typename Acceleration>
+inline void SymplecticStep(const SymplecticScheme& scheme, Vec* positions, Vec* velocities, size_t count,
+                           double dt, Acceleration&& acceleration)
+{
+    using Scalar = decltype(Vec::x);
+    for (unsigned int stage = 0; stage < scheme.stageCount; stage++)
+    {
+        if (scheme.drift[stage] != 0.0)
+        {
+            const Scalar h = Scalar(scheme.drift[stage] * dt);
+            for (size_t i = 0; i < count; i++)
+            {
+                positions[i].x += velocities[i].x * h;
+                positions[i].y += velocities[i].y * h;
+            }
+        }
+        if (scheme.kick[stage] != 0.0)
+        {
+            const Scalar h = Scalar(scheme.kick[stage] * dt);
+            for (size_t i = 0; i < count; i++)
+            {
+                const Vec a = acceleration(positions[i]);
+                velocities[i].x += a.x * h;
+                velocities[i].y += a.y * h;
+            }
+        }
+    }
+}
+
+struct OrbitBenchmarkResult
+{
+    const char* method = "";
+    bool isThroughWorld = false;    //!< Run through World::Step, on an entity of a world.
+    double step = 0.0;              //!< Fixed step, in seconds, 0 for the adaptive method.
+    double tolerance = 0.0;         //!< Tolerance of the adaptive method.
+    size_t evaluations = 0;         //!< Accelerations computed.
+    double maxEnergyError = 0.0;    //!< Largest relative error of the orbital energy during the run.
+    double finalEnergyError = 0.0;  //!< Relative error of the orbital energy at the end.
+    double positionError = 0.0;     //!< Distance to the exact position at the end, in km.
+    double milliseconds = 0.0;
+};
+
+/**
+ * @brief   Propagate an eccentric Earth orbit (a = 8000 km, e = 0.3) with every symplectic
+ *          scheme, fixed-step RK4 and the adaptive DormandPrince, and compare them with the
+ *          exact Kepler solution.
+ *          The symplectic schemes run twice: through World::Step, on a single entity of the
+ *          world like any other, then directly on a state of their own.
+ * @param   orbits: Number of revolutions to propagate, about 2 hours each.
+ */
+std::vector<OrbitBenchmarkResult> BenchmarkOrbit(double orbits);
+}
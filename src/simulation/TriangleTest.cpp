@@ -0,0 +1,253 @@
+#include "TriangleTest.h"
+#include <float.h>
+#include <math.h>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRIANGLE_TEST_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Simulation::TriangleTest
+{
+#ifdef TRIANGLE_TEST_SSE2
+/**
+ * Project both triangles on one axis per lane and keep the smallest overlap.
+ * A lane whose axis has no length keeps its best overlap unchanged.
+ */
+static inline void TestAxis(__m128 nx, __m128 ny, const __m128 ax[3], const __m128 ay[3],
+                            const __m128 bx[3], const __m128 by[3],
+                            __m128& best, __m128& bestX, __m128& bestY)
+{
+    const __m128 lengthSquared = _mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny));
+    const __m128 isValid = _mm_cmpgt_ps(lengthSquared, _mm_setzero_ps());
+    const __m128 invLength = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSquared)), isValid);
+    nx = _mm_mul_ps(nx, invLength);
+    ny = _mm_mul_ps(ny, invLength);
+
+    __m128 minA = _mm_set1_ps(FLT_MAX);
+    __m128 maxA = _mm_set1_ps(-FLT_MAX);
+    __m128 minB = minA;
+    __m128 maxB = maxA;
+    for (int v = 0; v < 3; v++)
+    {
+        const __m128 pa = _mm_add_ps(_mm_mul_ps(ax[v], nx), _mm_mul_ps(ay[v], ny));
+        const __m128 pb = _mm_add_ps(_mm_mul_ps(bx[v], nx), _mm_mul_ps(by[v], ny));
+        minA = _mm_min_ps(minA, pa);
+        maxA = _mm_max_ps(maxA, pa);
+        minB = _mm_min_ps(minB, pb);
+        maxB = _mm_max_ps(maxB, pb);
+    }
+    __m128 overlap = _mm_min_ps(_mm_sub_ps(maxA, minB), _mm_sub_ps(maxB, minA));
+    overlap = _mm_or_ps(_mm_and_ps(isValid, overlap), _mm_andnot_ps(isValid, _mm_set1_ps(FLT_MAX)));
+
+    const __m128 isBetter = _mm_cmplt_ps(overlap, best);
+    best = _mm_or_ps(_mm_and_ps(isBetter, overlap), _mm_andnot_ps(isBetter, best));
+    bestX = _mm_or_ps(_mm_and_ps(isBetter, nx), _mm_andnot_ps(isBetter, bestX));
+    bestY = _mm_or_ps(_mm_and_ps(isBetter, ny), _mm_andnot_ps(isBetter, bestY));
+}
+
+static int FindOverlaps(const ImVec2 tri[3], const TriangleBatch& batch, float depth[4], ImVec2 normal[4])
+{
+    __m128 ax[3], ay[3], bx[3], by[3];
+    for (int v = 0; v < 3; v++)
+    {
+        ax[v] = _mm_set1_ps(tri[v].x);
+        ay[v] = _mm_set1_ps(tri[v].y);
+        bx[v] = _mm_load_ps(batch.x[v]);
+        by[v] = _mm_load_ps(batch.y[v]);
+    }
+
+    __m128 best = _mm_set1_ps(FLT_MAX);
+    __m128 bestX = _mm_setzero_ps();
+    __m128 bestY = _mm_setzero_ps();
+    for (int e = 0; e < 3; e++)
+    {
+        const int next = e == 2 ? 0 : e + 1;
+        // The normal of an edge (dx, dy) is (-dy, dx), its direction doesn't matter for the projection.
+        TestAxis(_mm_sub_ps(ay[e], ay[next]), _mm_sub_ps(ax[next], ax[e]), ax, ay, bx, by, best, bestX, bestY);
+        TestAxis(_mm_sub_ps(by[e], by[next]), _mm_sub_ps(bx[next], bx[e]), ax, ay, bx, by, best, bestX, bestY);
+    }
+
+    const int laneMask = (1 << batch.count) - 1;
+    const int mask = _mm_movemask_ps(_mm_cmpge_ps(best, _mm_setzero_ps())) & laneMask;
+    alignas(16) float outX[4];
+    alignas(16) float outY[4];
+    _mm_store_ps(depth, best);
+    _mm_store_ps(outX, bestX);
+    _mm_store_ps(outY, bestY);
+    for (int lane = 0; lane < 4; lane++)
+    {
+        normal[lane] = ImVec2(outX[lane], outY[lane]);
+    }
+    return mask;
+}
+#else
+static int FindOverlaps(const ImVec2 tri[3], const TriangleBatch& batch, float depth[4], ImVec2 normal[4])
+{
+    int mask = 0;
+    for (unsigned int lane = 0; lane < batch.count; lane++)
+    {
+        const ImVec2 b[3] = { ImVec2(batch.x[0][lane], batch.y[0][lane]), ImVec2(batch.x[1][lane], batch.y[1][lane]),
+                              ImVec2(batch.x[2][lane], batch.y[2][lane]) };
+        float best = FLT_MAX;
+        ImVec2 bestAxis = ImVec2();
+        for (int axis = 0; axis < 6; axis++)
+        {
+            const ImVec2* t = axis < 3 ? tri : b;
+            const int e = axis % 3;
+            const int next = e == 2 ? 0 : e + 1;
+            ImVec2 n = ImVec2(t[e].y - t[next].y, t[next].x - t[e].x);
+            const float lengthSquared = (n.x * n.x) + (n.y * n.y);
+            if (lengthSquared <= 0.0f)
+            {
+                continue;
+            }
+            const float invLength = 1.0f / sqrtf(lengthSquared);
+            n = ImVec2(n.x * invLength, n.y * invLength);
+            float minA = FLT_MAX, maxA = -FLT_MAX, minB = FLT_MAX, maxB = -FLT_MAX;
+            for (int v = 0; v < 3; v++)
+            {
+                const float pa = (tri[v].x * n.x) + (tri[v].y * n.y);
+                const float pb = (b[v].x * n.x) + (b[v].y * n.y);
+                minA = pa < minA ? pa : minA;
+                maxA = pa > maxA ? pa : maxA;
+                minB = pb < minB ? pb : minB;
+                maxB = pb > maxB ? pb : maxB;
+            }
+            const float overlap = (maxA - minB) < (maxB - minA) ? (maxA - minB) : (maxB - minA);
+            if (overlap < best)
+            {
+                best = overlap;
+                bestAxis = n;
+            }
+        }
+        depth[lane] = best;
+        normal[lane] = bestAxis;
+        if (best >= 0.0f)
+        {
+            mask |= 1 << lane;
+        }
+    }
+    return mask;
+}
+#endif
+
+unsigned int Overlap(const ImVec2 tri[3], const TriangleBatch& batch, float depth[4], ImVec2 normal[4])
+{
+    const int mask = FindOverlaps(tri, batch, depth, normal);
+
+    // Orient the normals from tri towards the other triangle.
+    const ImVec2 center = ImVec2((tri[0].x + tri[1].x + tri[2].x) / 3.0f, (tri[0].y + tri[1].y + tri[2].y) / 3.0f);
+    for (int lane = 0; lane < 4; lane++)
+    {
+        if ((mask & (1 << lane)) == 0)
+        {
+            continue;
+        }
+        const float dx = ((batch.x[0][lane] + batch.x[1][lane] + batch.x[2][lane]) / 3.0f) - center.x;
+        const float dy = ((batch.y[0][lane] + batch.y[1][lane] + batch.y[2][lane]) / 3.0f) - center.y;
+        if ((dx * normal[lane].x) + (dy * normal[lane].y) < 0.0f)
+        {
+            normal[lane] = ImVec2(-normal[lane].x, -normal[lane].y);
+        }
+    }
+    return (unsigned int)mask;
+}
+
+unsigned int Sweep(const ImVec2 tri[3], const ImVec2& motion, const TriangleBatch& batch, float toi[4], ImVec2 normal[4])
+{
+    unsigned int mask = 0;
+    for (unsigned int lane = 0; lane < batch.count; lane++)
+    {
+        const ImVec2 b[3] = { ImVec2(batch.x[0][lane], batch.y[0][lane]), ImVec2(batch.x[1][lane], batch.y[1][lane]),
+                              ImVec2(batch.x[2][lane], batch.y[2][lane]) };
+        // The projections overlap during [enter, exit] on every axis at once.
+        float enter = -FLT_MAX;
+        float exit = FLT_MAX;
+        ImVec2 enterAxis = ImVec2();
+        float leastDepth = FLT_MAX;         // Used when the triangles already overlap at the start.
+        ImVec2 leastAxis = ImVec2();
+        bool isMissed = false;
+        for (int axis = 0; axis < 6 && isMissed == false; axis++)
+        {
+            const ImVec2* t = axis < 3 ? tri : b;
+            const int e = axis % 3;
+            const int next = e == 2 ? 0 : e + 1;
+            ImVec2 n = ImVec2(t[e].y - t[next].y, t[next].x - t[e].x);
+            const float lengthSquared = (n.x * n.x) + (n.y * n.y);
+            if (lengthSquared <= 0.0f)
+            {
+                continue;
+            }
+            const float invLength = 1.0f / sqrtf(lengthSquared);
+            n = ImVec2(n.x * invLength, n.y * invLength);
+            float minA = FLT_MAX, maxA = -FLT_MAX, minB = FLT_MAX, maxB = -FLT_MAX;
+            for (int v = 0; v < 3; v++)
+            {
+                const float pa = (tri[v].x * n.x) + (tri[v].y * n.y);
+                const float pb = (b[v].x * n.x) + (b[v].y * n.y);
+                minA = pa < minA ? pa : minA;
+                maxA = pa > maxA ? pa : maxA;
+                minB = pb < minB ? pb : minB;
+                maxB = pb > maxB ? pb : maxB;
+            }
+
+            const float speed = (motion.x * n.x) + (motion.y * n.y);
+            float axisEnter = -FLT_MAX;
+            float axisExit = FLT_MAX;
+            ImVec2 towardsB = n;
+            if (maxA < minB)
+            {
+                isMissed = speed <= 0.0f;
+                axisEnter = (minB - maxA) / speed;
+                axisExit = (maxB - minA) / speed;
+            }
+            else if (minA > maxB)
+            {
+                isMissed = speed >= 0.0f;
+                axisEnter = (maxB - minA) / speed;
+                axisExit = (minB - maxA) / speed;
+                towardsB = ImVec2(-n.x, -n.y);
+            }
+            else
+            {
+                if (speed != 0.0f)
+                {
+                    axisExit = speed > 0.0f ? (maxB - minA) / speed : (minB - maxA) / speed;
+                }
+                const float depth = (maxA - minB) < (maxB - minA) ? (maxA - minB) : (maxB - minA);
+                if (depth < leastDepth)
+                {
+                    leastDepth = depth;
+                    leastAxis = (maxA - minB) < (maxB - minA) ? n : ImVec2(-n.x, -n.y);
+                }
+            }
+            if (axisEnter > enter)
+            {
+                enter = axisEnter;
+                enterAxis = towardsB;
+            }
+            exit = axisExit < exit ? axisExit : exit;
+        }
+        if (isMissed == true || enter > exit || enter > 1.0f)
+        {
+            continue;
+        }
+
+        if (enter == -FLT_MAX)
+        {
+            // Already overlapping: only a motion going deeper is stopped, at once.
+            if ((motion.x * leastAxis.x) + (motion.y * leastAxis.y) <= 0.0f)
+            {
+                continue;
+            }
+            enter = 0.0f;
+            enterAxis = leastAxis;
+        }
+        toi[lane] = enter;
+        normal[lane] = enterAxis;
+        mask |= 1u << lane;
+    }
+    return mask;
+}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "vendor/imgui/imgui.h"
+
+namespace Simulation
+{
+/**
+ * Up to 4 triangles stored lane by lane (structure of arrays), to be tested at once.
+ * Unused lanes repeat the last triangle.
+ */
+struct TriangleBatch
+{
+    alignas(16) float x[3][4];      //!< x[v][lane] is the x coordinate of vertex v of the lane's triangle.
+    alignas(16) float y[3][4];
+    unsigned int triangle[4];       //!< Index of each lane's triangle in its geometry.
+    unsigned int count;             //!< Number of lanes used.
+};
+
+/**
+ * Separating axis tests between 2D triangles, one triangle against a batch of 4 at a time,
+ * with SSE2 when the target has it.
+ */
+namespace TriangleTest
+{
+/**
+ * @brief   Test a triangle against the triangles of a batch.
+ *          The axes tested are the edge normals of both triangles. For the lanes that overlap,
+ *          the penetration depth is the smallest overlap of the projections, along that axis.
+ *          Touching triangles overlap with a depth of 0. Degenerate edges are not used as axes.
+ * @param   tri: The triangle.
+ * @param   batch: The triangles to test it against.
+ * @param   depth: Filled with the penetration depth of every overlapping lane.
+ * @param   normal: Filled with the unit separation axis of every overlapping lane,
+ *          pointing from tri towards the lane's triangle.
+ * @retval  A mask with bit i set if the triangle in lane i overlaps tri.
+ */
+unsigned int Overlap(const ImVec2 tri[3], const TriangleBatch& batch, float depth[4], ImVec2 normal[4]);
+
+/**
+ * @brief   Find when a moving triangle first touches the triangles of a batch (swept separating axis test).
+ *          The triangle moves linearly by motion over the time [0..1], the batch stays still.
+ *          A triangle that already overlaps a lane at the start hits it at time 0 if the motion goes
+ *          deeper along their axis of least penetration, and misses it otherwise.
+ *          Only used for fast objects, so the lanes are tested one by one.
+ * @param   toi: Filled with the time of impact of every lane hit, in [0..1].
+ * @param   normal: Filled with the unit separation axis of every lane hit at its time of impact,
+ *          pointing from tri towards the lane's triangle.
+ * @retval  A mask with bit i set if the triangle in lane i is hit.
+ */
+unsigned int Sweep(const ImVec2 tri[3], const ImVec2& motion, const TriangleBatch& batch, float toi[4], ImVec2 normal[4]);
+}
+}
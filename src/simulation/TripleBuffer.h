@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+
+namespace Simulation
+{
+/**
+ * @class   TripleBuffer
+ * @brief   Hands values from one writer thread to one reader thread without locks.
+ *          The writer fills the back buffer and publishes it, the reader picks up the latest
+ *          published buffer. Neither ever waits for the other: the third buffer sits in the
+ *          middle, holding the latest published value until the reader takes it or the writer
+ *          replaces it. Values the reader never picked up are dropped.
+ *          The buffers are reused, so a T holding vectors keeps their storage.
+ */
+template<class T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * @brief   Writer side. Get the buffer to fill, it holds whatever was published two times ago.
+     */
+    inline T& Back()
+    {
+        return m_buffers[m_back];
+    }
+
+    /**
+     * @brief   Writer side. Publish the back buffer as the latest value and get a new back buffer.
+     */
+    inline void Publish()
+    {
+        unsigned int previous = m_middle.exchange(m_back | NEW_DATA, std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+
+    /**
+     * @brief   Reader side. Take the latest published value, if any was published since the last call.
+     * @retval  True if Front changed.
+     */
+    inline bool Acquire()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & NEW_DATA) == 0)
+        {
+            return false;
+        }
+        unsigned int previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief   Reader side. Get the value taken by the last Acquire, it doesn't change until the next one.
+     */
+    inline const T& Front() const
+    {
+        return m_buffers[m_front];
+    }
+
+private:
+    static constexpr unsigned int INDEX_MASK = 3;
+    static constexpr unsigned int NEW_DATA = 4;     //!< Set in m_middle when the writer published it.
+
+    T m_buffers[3] = {};
+    // Each side only touches its own index, keep them on separate cache lines.
+    alignas(64) std::atomic<unsigned int> m_middle = { 1 };
+    alignas(64) unsigned int m_back = 0;
+    alignas(64) unsigned int m_front = 2;
+};
+}
@@ -0,0 +1,124 @@
+#include "UniformGrid.h"
+#include <algorithm>
+#include <iterator>
+
+namespace Simulation
+{
+void UniformGrid::AddProxy(unsigned int id, const Renderer::Aabb& bounds)
+{
+    if (id >= m_proxies.size())
+    {
+        m_proxies.resize(id + 1);
+    }
+    m_proxies[id].bounds = bounds;
+    m_proxies[id].isActive = true;
+}
+
+void UniformGrid::MoveProxy(unsigned int id, const Renderer::Aabb& bounds)
+{
+    m_proxies[id].bounds = bounds;
+}
+
+void UniformGrid::RemoveProxy(unsigned int id)
+{
+    m_proxies[id].isActive = false;
+}
+
+void UniformGrid::UpdatePairs(std::vector<ProxyPair>& added, std::vector<ProxyPair>& removed)
+{
+    FindPairs(m_newPairs);
+
+    added.clear();
+    removed.clear();
+    std::set_difference(m_newPairs.begin(), m_newPairs.end(), m_pairs.begin(), m_pairs.end(), std::back_inserter(added));
+    std::set_difference(m_pairs.begin(), m_pairs.end(), m_newPairs.begin(), m_newPairs.end(), std::back_inserter(removed));
+    m_pairs.swap(m_newPairs);
+}
+
+void UniformGrid::GetPairs(std::vector<ProxyPair>& out) const
+{
+    out = m_pairs;
+}
+
+void UniformGrid::FindPairs(std::vector<ProxyPair>& out)
+{
+    out.clear();
+    m_entries.clear();
+    m_large.clear();
+    for (unsigned int id = 0; id < m_proxies.size(); id++)
+    {
+        const Proxy& proxy = m_proxies[id];
+        if (proxy.isActive == false)
+        {
+            continue;
+        }
+        const int minX = GetCell(proxy.bounds.min.x);
+        const int minY = GetCell(proxy.bounds.min.y);
+        const int maxX = GetCell(proxy.bounds.max.x);
+        const int maxY = GetCell(proxy.bounds.max.y);
+        if (uint64_t(maxX - minX + 1) * uint64_t(maxY - minY + 1) > MAX_CELLS_PER_PROXY)
+        {
+            m_large.push_back(id);
+            continue;
+        }
+        for (int y = minY; y <= maxY; y++)
+        {
+            for (int x = minX; x <= maxX; x++)
+            {
+                m_entries.push_back(CellEntry { GetCellKey(x, y), id });
+            }
+        }
+    }
+    std::sort(m_entries.begin(), m_entries.end());
+
+    // Test the proxies sharing each cell.
+    for (size_t first = 0; first < m_entries.size();)
+    {
+        size_t end = first + 1;
+        while (end < m_entries.size() && m_entries[end].cell == m_entries[first].cell)
+        {
+            end++;
+        }
+        for (size_t i = first; i < end; i++)
+        {
+            const Renderer::Aabb& a = m_proxies[m_entries[i].proxy].bounds;
+            for (size_t j = i + 1; j < end; j++)
+            {
+                const Renderer::Aabb& b = m_proxies[m_entries[j].proxy].bounds;
+                if (a.Overlaps(b) == false)
+                {
+                    continue;
+                }
+                // Only the cell holding the min corner of the overlap reports the pair.
+                const float cornerX = a.min.x > b.min.x ? a.min.x : b.min.x;
+                const float cornerY = a.min.y > b.min.y ? a.min.y : b.min.y;
+                if (GetCellKey(GetCell(cornerX), GetCell(cornerY)) == m_entries[first].cell)
+                {
+                    out.push_back(MakeProxyPair(m_entries[i].proxy, m_entries[j].proxy));
+                }
+            }
+        }
+        first = end;
+    }
+
+    // Large proxies are tested against everything, once per pair.
+    for (unsigned int large : m_large)
+    {
+        const Renderer::Aabb& a = m_proxies[large].bounds;
+        for (unsigned int id = 0; id < m_proxies.size(); id++)
+        {
+            const Proxy& other = m_proxies[id];
+            const bool isLarge = std::binary_search(m_large.begin(), m_large.end(), id);
+            if (other.isActive == false || id == large || (isLarge == true && id < large))
+            {
+                continue;
+            }
+            if (a.Overlaps(other.bounds) == true)
+            {
+                out.push_back(MakeProxyPair(large, id));
+            }
+        }
+    }
+    std::sort(out.begin(), out.end());
+}
+}
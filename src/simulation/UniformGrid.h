@@ -0,0 +1,81 @@
+#pragma once
+#include "simulation/Broadphase.h"
+#include <math.h>
+
+namespace Simulation
+{
+/**
+ * @class   UniformGrid
+ * @brief   Uniform grid broadphase.
+ *          Every frame the proxies are binned into square cells (a sparse grid, stored as a sorted
+ *          list of (cell, proxy) entries), and only the proxies sharing a cell are tested.
+ *          A pair is only reported by the cell holding the corner of the two boxes' overlap, so
+ *          pairs spanning several cells are found once without deduplication. The pairs are then
+ *          compared with the previous frame's to report what changed.
+ *          The cost doesn't depend on how much the objects moved, which makes it the better fit
+ *          for many fragments of similar sizes flying apart. Proxies covering more than
+ *          MAX_CELLS_PER_PROXY cells are tested against every other proxy instead.
+ */
+class UniformGrid : public Broadphase
+{
+public:
+    static constexpr float DEFAULT_CELL_SIZE = 64.0f;
+    static constexpr unsigned int MAX_CELLS_PER_PROXY = 64;
+
+    /**
+     * @param   cellSize: Size of the cells in world units, best about the size of the typical object.
+     */
+    explicit UniformGrid(float cellSize = DEFAULT_CELL_SIZE) : m_cellSize(cellSize), m_invCellSize(1.0f / cellSize)
+    {
+    }
+
+    void AddProxy(unsigned int id, const Renderer::Aabb& bounds) override;
+    void MoveProxy(unsigned int id, const Renderer::Aabb& bounds) override;
+    void RemoveProxy(unsigned int id) override;
+    void UpdatePairs(std::vector<ProxyPair>& added, std::vector<ProxyPair>& removed) override;
+    void GetPairs(std::vector<ProxyPair>& out) const override;
+
+    inline float CellSize() const
+    {
+        return m_cellSize;
+    }
+
+private:
+    struct Proxy
+    {
+        Renderer::Aabb bounds;
+        bool isActive = false;
+    };
+
+    struct CellEntry
+    {
+        uint64_t cell;
+        unsigned int proxy;
+
+        inline bool operator<(const CellEntry& other) const
+        {
+            return cell < other.cell || (cell == other.cell && proxy < other.proxy);
+        }
+    };
+
+    inline int GetCell(float coordinate) const
+    {
+        return int(floorf(coordinate * m_invCellSize));
+    }
+    static inline uint64_t GetCellKey(int x, int y)
+    {
+        return (uint64_t(uint32_t(x)) << 32) | uint32_t(y);
+    }
+
+    void FindPairs(std::vector<ProxyPair>& out);
+
+private:
+    float m_cellSize = DEFAULT_CELL_SIZE;
+    float m_invCellSize = 1.0f / DEFAULT_CELL_SIZE;
+    std::vector<Proxy> m_proxies = std::vector<Proxy>();
+    std::vector<CellEntry> m_entries = std::vector<CellEntry>();   //!< Scratch, proxies binned by cell.
+    std::vector<unsigned int> m_large = std::vector<unsigned int>();  //!< Scratch, proxies covering too many cells.
+    std::vector<ProxyPair> m_pairs = std::vector<ProxyPair>();      //!< Pairs of the last frame, sorted.
+    std::vector<ProxyPair> m_newPairs = std::vector<ProxyPair>();   //!< Scratch, pairs of the current frame.
+};
+}
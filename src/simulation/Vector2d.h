@@ -0,0 +1,27 @@
+#pragma once
+#include "vendor/imgui/imgui.h"
+
+namespace Simulation
+{
+/**
+ * A 2D vector in double precision, for the state that single precision would let drift.
+ */
+struct Vector2d
+{
+    double x = 0.0;
+    double y = 0.0;
+
+    Vector2d() = default;
+    Vector2d(double x_, double y_) : x(x_), y(y_)
+    {
+    }
+    explicit Vector2d(const ImVec2& v) : x(v.x), y(v.y)
+    {
+    }
+
+    inline ImVec2 ToImVec2() const
+    {
+        return ImVec2(float(x), float(y));
+    }
+};
+}
@@ -0,0 +1,102 @@
+#include "World.h"
+#include "utils/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Simulation
+{
+unsigned int World::Advance(double elapsed)
+{
+    if (elapsed > MAX_ADVANCE)
+    {
+        m_droppedTime += elapsed - MAX_ADVANCE;
+        elapsed = MAX_ADVANCE;
+    }
+    m_accumulator += elapsed;
+
+    unsigned int steps = 0;
+    while (m_accumulator >= m_timestep)
+    {
+        Step();
+        m_accumulator -= m_timestep;
+        steps++;
+    }
+    return steps;
+}
+
+void World::Step()
+{
+    // The integrator runs over the columns of the moving archetypes, split in ranges of rows run as jobs.
+    const float dt = float(m_timestep);
+    const double timestep = m_timestep;
+    const SymplecticScheme& scheme = GetSymplecticScheme(m_integrator);
+    const Vector2d gravity = Vector2d(m_gravity);
+    const Vector2d center = Vector2d(m_gravityCenter);
+    const double mu = m_gravitationalParameter;
+    m_entities.ForEach(ENTITY_MOVEABLE, [&](Archetype& archetype)
+                       {
+                           ImVec2* positions = archetype.positions.data();
+                           ImVec2* previousPositions = archetype.previousPositions.data();
+                           ImVec2* velocities = archetype.velocities.data();
+                           Vector2d* precisePositions = archetype.precisePositions.data();
+                           Vector2d* preciseVelocities = archetype.preciseVelocities.data();
+                           const bool isAffectedByPhysics = archetype.HasPreciseState();
+                           Jobs::ParallelFor(archetype.Size(), STEP_GRAIN, [=, &scheme](size_t begin, size_t end)
+                                             {
+                                                 std::copy(positions + begin, positions + end, previousPositions + begin);
+                                                 if (isAffectedByPhysics == false)
+                                                 {
+                                                     for (size_t i = begin; i < end; i++)
+                                                     {
+                                                         positions[i].x += velocities[i].x * dt;
+                                                         positions[i].y += velocities[i].y * dt;
+                                                     }
+                                                     return;
+                                                 }
+                                                 // Integrated in double precision, the float columns only get the rounded result.
+                                                 if (mu == 0.0)
+                                                 {
+                                                     SymplecticStep(scheme, precisePositions + begin, preciseVelocities + begin, end - begin, timestep,
+                                                                    [gravity](const Vector2d&) { return gravity; });
+                                                 }
+                                                 else
+                                                 {
+                                                     SymplecticStep(scheme, precisePositions + begin, preciseVelocities + begin, end - begin, timestep,
+                                                                    [gravity, center, mu](const Vector2d& position)
+                                                                    {
+                                                                        const double x = position.x - center.x;
+                                                                        const double y = position.y - center.y;
+                                                                        const double r2 = (x * x) + (y * y);
+                                                                        const double scale = -mu / (r2 * std::sqrt(r2));
+                                                                        return Vector2d(gravity.x + (x * scale), gravity.y + (y * scale));
+                                                                    });
+                                                 }
+                                                 for (size_t i = begin; i < end; i++)
+                                                 {
+                                                     positions[i] = precisePositions[i].ToImVec2();
+                                                     velocities[i] = preciseVelocities[i].ToImVec2();
+                                                 }
+                                             });
+                       });
+    m_collisions.Update(m_entities);
+    m_continuous.Update(m_entities, m_collisions.Pairs(), m_narrowphase, dt);
+    m_narrowphase.Update(m_entities, m_collisions.Pairs());
+    m_stepCount++;
+}
+
+void World::WriteSnapshot(WorldSnapshot& snapshot) const
+{
+    snapshot.time = Time();
+    snapshot.step = m_stepCount;
+    snapshot.bodies.assign(m_entities.IndexCount(), BodyState());
+    m_entities.ForEach(0, [&](const Archetype& archetype)
+                       {
+                           for (size_t row = 0; row < archetype.Size(); row++)
+                           {
+                               BodyState& body = snapshot.bodies[archetype.indices[row]];
+                               body.position = archetype.positions[row];
+                               body.velocity = archetype.velocities[row];
+                           }
+                       });
+}
+}
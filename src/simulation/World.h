@@ -0,0 +1,216 @@
+#pragma once
+#include "simulation/CollisionWorld.h"
+#include "simulation/ContinuousCollision.h"
+#include "simulation/EntityStore.h"
+#include "simulation/Narrowphase.h"
+#include "simulation/Symplectic.h"
+#include "vendor/imgui/imgui.h"
+#include <vector>
+
+namespace Simulation
+{
+/**
+ * The state of a body at the end of a physics step, as seen by the render thread.
+ */
+struct BodyState
+{
+    ImVec2 position = ImVec2();
+    ImVec2 velocity = ImVec2();
+};
+
+/**
+ * An immutable copy of the world at the end of a physics step.
+ * Bodies are indexed by entity index, the bodies of unused indices are left at their defaults.
+ */
+struct WorldSnapshot
+{
+    double time = 0.0;          //!< Simulated time, in seconds.
+    unsigned long long step = 0;
+    std::vector<BodyState> bodies = std::vector<BodyState>();
+};
+
+/**
+ * @class   World
+ * @brief   The simulated entities, stepped with a fixed time step.
+ *          Elapsed time, real or virtual, is fed to Advance and accumulated until it adds up to
+ *          whole steps, so the motion only depends on the time step and never on how often or
+ *          how irregularly Advance is called.
+ *          Every step streams through the columns of the entity store: the moving archetypes are
+ *          integrated, then the collision world is updated with the bounds the entities swept, the fast
+ *          entities are stopped where they first hit something, and the collision meshes of the pairs
+ *          whose bounds overlap are tested for contacts.
+ *          The entities affected by physics fall with a uniform gravity, plus the pull of a central
+ *          body when it has a gravitational parameter. The integrator and the time step can be
+ *          changed between steps, e.g. a symplectic scheme with larger steps for a long coast.
+ *          The entities affected by physics are integrated in double precision (see Archetype::HasPreciseState),
+ *          their float positions and velocities are only rounded from it after every step: in single
+ *          precision the round-off would drift where the schemes alone don't, on the orbit of
+ *          BenchmarkOrbit by about 1e-4 of the energy whatever the step.
+ */
+class World
+{
+public:
+    static constexpr double DEFAULT_TIMESTEP = 0.001;           //!< 1 kHz.
+    static constexpr double MAX_ADVANCE = 0.25;                 //!< Most time caught up by a single Advance, in seconds.
+    static constexpr size_t STEP_GRAIN = 4096;                  //!< Entities integrated per job.
+
+    World() = default;
+    /**
+     * @param   timestep: The fixed time step, in seconds.
+     */
+    explicit World(double timestep) : m_timestep(timestep)
+    {
+    }
+
+    /**
+     * @brief   Accumulate elapsed time and run every whole step it adds up to.
+     *          When more than MAX_ADVANCE is owed, the extra time is dropped rather than
+     *          trying to catch up forever with a world that steps slower than real time.
+     * @param   elapsed: The time elapsed since the last call, in seconds.
+     * @retval  The number of steps run.
+     */
+    unsigned int Advance(double elapsed);
+
+    /**
+     * @brief   Run a single step.
+     */
+    void Step();
+
+    /**
+     * @brief   Copy the state of every entity into a snapshot, reusing its storage.
+     */
+    void WriteSnapshot(WorldSnapshot& snapshot) const;
+
+    /**
+     * @brief   Add an object to the world, as an entity.
+     */
+    inline EntityHandle AddObject(const Renderer::Object& object)
+    {
+        return m_entities.Create(object);
+    }
+    inline EntityStore& Entities()
+    {
+        return m_entities;
+    }
+    inline const EntityStore& Entities() const
+    {
+        return m_entities;
+    }
+
+    inline CollisionWorld& Collisions()
+    {
+        return m_collisions;
+    }
+    inline const CollisionWorld& Collisions() const
+    {
+        return m_collisions;
+    }
+
+    /**
+     * @brief   Get the contacts between the entities after the last step.
+     */
+    inline const Narrowphase& Contacts() const
+    {
+        return m_narrowphase;
+    }
+
+    /**
+     * @brief   Get the impacts of the fast entities during the last step.
+     */
+    inline const ContinuousCollision& Impacts() const
+    {
+        return m_continuous;
+    }
+    inline ContinuousCollision& Impacts()
+    {
+        return m_continuous;
+    }
+
+    inline double Timestep() const
+    {
+        return m_timestep;
+    }
+    /**
+     * @brief   Change the time step, from the next step on.
+     */
+    inline void Timestep(double timestep)
+    {
+        m_timestepStartTime = Time();
+        m_timestepStartStep = m_stepCount;
+        m_timestep = timestep;
+    }
+    inline double Time() const
+    {
+        return m_timestepStartTime + (double(m_stepCount - m_timestepStartStep) * m_timestep);
+    }
+    inline unsigned long long StepCount() const
+    {
+        return m_stepCount;
+    }
+    /**
+     * @brief   Get the total time dropped by Advance because the world fell behind, in seconds.
+     */
+    inline double DroppedTime() const
+    {
+        return m_droppedTime;
+    }
+
+    inline void Gravity(const ImVec2& gravity)
+    {
+        m_gravity = gravity;
+    }
+    inline const ImVec2& Gravity() const
+    {
+        return m_gravity;
+    }
+
+    /**
+     * @brief   Set the position of the central body, in world units.
+     */
+    inline void GravityCenter(const ImVec2& center)
+    {
+        m_gravityCenter = center;
+    }
+    inline const ImVec2& GravityCenter() const
+    {
+        return m_gravityCenter;
+    }
+    /**
+     * @brief   Set the gravitational parameter of the central body, in world units cubed per
+     *          second squared, 0 for none.
+     */
+    inline void GravitationalParameter(double mu)
+    {
+        m_gravitationalParameter = mu;
+    }
+    inline double GravitationalParameter() const
+    {
+        return m_gravitationalParameter;
+    }
+
+    inline void Integrator(IntegratorType_t integrator)
+    {
+        m_integrator = integrator;
+    }
+    inline IntegratorType_t Integrator() const
+    {
+        return m_integrator;
+    }
+
+private:
+    EntityStore m_entities = EntityStore();
+    CollisionWorld m_collisions = CollisionWorld();
+    ContinuousCollision m_continuous = ContinuousCollision();
+    Narrowphase m_narrowphase = Narrowphase();
+    ImVec2 m_gravity = ImVec2(0.0f, 9.81f);     //!< World units per second squared, y points down like the screen.
+    ImVec2 m_gravityCenter = ImVec2();
+    double m_gravitationalParameter = 0.0;
+    IntegratorType_t m_integrator = INTEGRATOR_SEMI_IMPLICIT_EULER;
+    double m_timestep = DEFAULT_TIMESTEP;
+    double m_timestepStartTime = 0.0;           //!< Time when the time step was last changed.
+    unsigned long long m_timestepStartStep = 0; //!< Step count when the time step was last changed.
+    double m_accumulator = 0.0;                 //!< Elapsed time not stepped yet.
+    double m_droppedTime = 0.0;
+    unsigned long long m_stepCount = 0;
+};
+}
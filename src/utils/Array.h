@@ -0,0 +1,85 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+/**
+ * @class   Array
+ * @brief   Read-only contiguous array that either owns its elements or views memory owned by something else,
+ *          like a memory-mapped file. The owner is kept alive as long as an Array refers to it.
+ *          Copying an Array shares the elements instead of copying them.
+ *          The accessors follow the standard containers' names so an Array can replace a const std::vector.
+ */
+template<typename T>
+class Array
+{
+public:
+    Array() = default;
+
+    /**
+     * @brief   Take ownership of the elements of a vector.
+     */
+    Array(std::vector<T>&& elements) : m_vector(std::make_shared<std::vector<T>>(std::move(elements)))
+    {
+        m_data = m_vector->data();
+        m_size = m_vector->size();
+    }
+    Array(const std::vector<T>& elements) : Array(std::vector<T>(elements))
+    {
+    }
+
+    /**
+     * @brief   View elements owned by something else.
+     * @param   data: The first element.
+     * @param   size: The number of elements.
+     * @param   owner: What holds the memory. It is released when the last Array referring to it is destroyed.
+     */
+    Array(const T* data, size_t size, std::shared_ptr<const void> owner) :
+        m_data(data), m_size(size), m_owner(std::move(owner))
+    {
+    }
+
+    inline const T* data() const
+    {
+        return m_data;
+    }
+    inline size_t size() const
+    {
+        return m_size;
+    }
+    inline bool empty() const
+    {
+        return m_size == 0;
+    }
+    inline const T& operator[](size_t i) const
+    {
+        return m_data[i];
+    }
+    inline const T* begin() const
+    {
+        return m_data;
+    }
+    inline const T* end() const
+    {
+        return m_data + m_size;
+    }
+
+    /**
+     * @brief   Get writable elements. They are copied first if they are viewed or shared with another Array.
+     */
+    inline T* MutableData()
+    {
+        if (m_vector == nullptr || m_vector.use_count() > 1)
+        {
+            m_vector = std::make_shared<std::vector<T>>(begin(), end());
+            m_data = m_vector->data();
+            m_owner = nullptr;
+        }
+        return m_vector->data();
+    }
+
+private:
+    const T* m_data = nullptr;
+    size_t m_size = 0;
+    std::shared_ptr<const void> m_owner = nullptr;      //!< Keeps the viewed memory alive.
+    std::shared_ptr<std::vector<T>> m_vector = nullptr; //!< The elements, when they are owned.
+};
@@ -0,0 +1,473 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Jobs
+{
+struct Job
+{
+    std::function<void()> function;
+    std::atomic<int> references = 1;
+    std::atomic<int> unfinished = 1;            //!< The job itself, and its children still running.
+    std::atomic<int> pendingDependencies = 0;   //!< Dependencies not finished yet, the job is queued once it's 0.
+    Job* parent = nullptr;                      //!< Finishes once this job and its siblings did, holds a reference.
+
+    std::mutex mutex;                           //!< Guards the continuations and isFinished.
+    std::vector<Job*> continuations;            //!< Jobs depending on this one, each holding a reference.
+    bool isFinished = false;
+};
+
+static inline void AddReference(Job* job)
+{
+    job->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+static inline void Release(Job* job)
+{
+    if (job->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete job;
+    }
+}
+
+/**
+ * A fixed-size work-stealing deque (Chase-Lev). The owner pushes and pops at the bottom,
+ * the other threads steal from the top.
+ */
+class WorkQueue
+{
+public:
+    static constexpr int64_t CAPACITY = 4096;
+
+    /**
+     * @retval  False if the queue is full.
+     */
+    bool Push(Job* job)
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_acquire);
+        if (bottom - top >= CAPACITY)
+        {
+            return false;
+        }
+        m_jobs[bottom & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    Job* Pop()
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_seq_cst);
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = m_jobs[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            // Last job, race the thieves for it.
+            if (m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed) == false)
+            {
+                job = nullptr;
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    Job* Steal()
+    {
+        int64_t top = m_top.load(std::memory_order_seq_cst);
+        const int64_t bottom = m_bottom.load(std::memory_order_seq_cst);
+        if (top >= bottom)
+        {
+            return nullptr;
+        }
+        Job* job = m_jobs[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed) == false)
+        {
+            return nullptr;
+        }
+        return job;
+    }
+
+private:
+    alignas(64) std::atomic<int64_t> m_top = 0;
+    alignas(64) std::atomic<int64_t> m_bottom = 0;
+    std::atomic<Job*> m_jobs[CAPACITY] = {};
+};
+
+static constexpr int NOT_A_WORKER = -1;
+static thread_local int t_workerIndex = NOT_A_WORKER;
+static thread_local uint32_t t_random = 0;
+
+static std::vector<std::unique_ptr<WorkQueue>> s_queues;
+static std::vector<std::thread> s_workers;
+static std::atomic<bool> s_isRunning = false;
+static std::mutex s_sharedMutex;                    //!< Guards s_shared.
+static std::deque<Job*> s_shared;                   //!< Jobs submitted by the threads that aren't workers.
+static std::atomic<int> s_queuedCount = 0;          //!< Jobs in any queue.
+static std::mutex s_sleepMutex;
+static std::condition_variable s_wake;
+static int s_sleepingCount = 0;                     //!< Guarded by s_sleepMutex.
+static bool s_quit = false;                         //!< Guarded by s_sleepMutex.
+
+static void Execute(Job* job);
+
+static void Schedule(Job* job)
+{
+    AddReference(job);      // Held by the queue.
+    if (s_isRunning.load(std::memory_order_acquire) == false)
+    {
+        Execute(job);
+        return;
+    }
+
+    // Counted before it's queued, so the count is never below the jobs there are to take.
+    s_queuedCount.fetch_add(1, std::memory_order_seq_cst);
+    if (t_workerIndex != NOT_A_WORKER)
+    {
+        if (s_queues[t_workerIndex]->Push(job) == false)
+        {
+            // The deque is full, the job is run now instead of growing it.
+            s_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+            Execute(job);
+            return;
+        }
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(s_sharedMutex);
+        s_shared.push_back(job);
+    }
+
+    std::lock_guard<std::mutex> lock(s_sleepMutex);
+    if (s_sleepingCount > 0)
+    {
+        s_wake.notify_one();
+    }
+}
+
+static void Finish(Job* job)
+{
+    if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+
+    std::vector<Job*> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->isFinished = true;
+        continuations.swap(job->continuations);
+    }
+    for (Job* continuation : continuations)
+    {
+        if (continuation->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            Schedule(continuation);
+        }
+        Release(continuation);
+    }
+    if (job->parent != nullptr)
+    {
+        Finish(job->parent);
+        Release(job->parent);
+    }
+}
+
+static void Execute(Job* job)
+{
+    if (job->function)
+    {
+        job->function();
+    }
+    Finish(job);
+    Release(job);
+}
+
+/**
+ * @brief   Take a job from the thread's own deque, the shared queue, or another worker's deque.
+ */
+static Job* FindJob()
+{
+    if (s_queuedCount.load(std::memory_order_relaxed) <= 0)
+    {
+        return nullptr;
+    }
+
+    Job* job = nullptr;
+    if (t_workerIndex != NOT_A_WORKER)
+    {
+        job = s_queues[t_workerIndex]->Pop();
+    }
+    if (job == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(s_sharedMutex);
+        if (s_shared.empty() == false)
+        {
+            job = s_shared.front();
+            s_shared.pop_front();
+        }
+    }
+    const size_t count = s_queues.size();
+    if (job == nullptr && count > 0)
+    {
+        // Start from a random victim so the thieves spread out (xorshift).
+        t_random = t_random != 0 ? t_random : (uint32_t)(std::hash<std::thread::id>()(std::this_thread::get_id()) | 1);
+        t_random ^= t_random << 13;
+        t_random ^= t_random >> 17;
+        t_random ^= t_random << 5;
+        const size_t first = t_random % count;
+        for (size_t i = 0; i < count && job == nullptr; i++)
+        {
+            const size_t victim = (first + i) % count;
+            if ((int)victim != t_workerIndex)
+            {
+                job = s_queues[victim]->Steal();
+            }
+        }
+    }
+    if (job != nullptr)
+    {
+        s_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+static void WorkerMain(int index)
+{
+    t_workerIndex = index;
+    while (true)
+    {
+        Job* job = FindJob();
+        if (job != nullptr)
+        {
+            Execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(s_sleepMutex);
+        if (s_quit == true && s_queuedCount.load() <= 0)
+        {
+            return;
+        }
+        s_sleepingCount++;
+        s_wake.wait(lock, []()
+                    {
+                        return s_quit == true || s_queuedCount.load() > 0;
+                    });
+        s_sleepingCount--;
+    }
+}
+
+JobHandle::JobHandle(Job* job) : m_job(job)
+{
+    if (m_job != nullptr)
+    {
+        AddReference(m_job);
+    }
+}
+
+JobHandle JobHandle::Adopt(Job* job)
+{
+    JobHandle handle;
+    handle.m_job = job;
+    return handle;
+}
+
+JobHandle::JobHandle(const JobHandle& other) : JobHandle(other.m_job)
+{
+}
+
+JobHandle::JobHandle(JobHandle&& other) noexcept : m_job(other.m_job)
+{
+    other.m_job = nullptr;
+}
+
+JobHandle& JobHandle::operator=(const JobHandle& other)
+{
+    if (this != &other)
+    {
+        JobHandle copy = JobHandle(other);
+        std::swap(m_job, copy.m_job);
+    }
+    return *this;
+}
+
+JobHandle& JobHandle::operator=(JobHandle&& other) noexcept
+{
+    std::swap(m_job, other.m_job);
+    return *this;
+}
+
+JobHandle::~JobHandle()
+{
+    if (m_job != nullptr)
+    {
+        Release(m_job);
+    }
+}
+
+bool JobHandle::IsDone() const
+{
+    return m_job == nullptr || m_job->unfinished.load(std::memory_order_acquire) == 0;
+}
+
+void Init(unsigned int workerCount)
+{
+    if (s_isRunning.load() == true)
+    {
+        return;
+    }
+    if (workerCount == 0)
+    {
+        const unsigned int cores = std::thread::hardware_concurrency();
+        workerCount = cores > 1 ? cores - 1 : 1;
+    }
+
+    s_quit = false;
+    s_queues.clear();
+    for (unsigned int i = 0; i < workerCount; i++)
+    {
+        s_queues.push_back(std::make_unique<WorkQueue>());
+    }
+    s_isRunning.store(true);
+    for (unsigned int i = 0; i < workerCount; i++)
+    {
+        s_workers.emplace_back(WorkerMain, (int)i);
+    }
+}
+
+void Shutdown()
+{
+    if (s_isRunning.load() == false)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(s_sleepMutex);
+        s_quit = true;
+    }
+    s_wake.notify_all();
+    for (std::thread& worker : s_workers)
+    {
+        worker.join();
+    }
+    s_workers.clear();
+    s_isRunning.store(false);
+
+    // Jobs submitted by other threads while the workers were stopping.
+    while (Job* job = FindJob())
+    {
+        Execute(job);
+    }
+    s_queues.clear();
+}
+
+unsigned int WorkerCount()
+{
+    return s_isRunning.load() == true ? (unsigned int)s_workers.size() : 0;
+}
+
+JobHandle Submit(std::function<void()> function, const JobHandle* dependencies, size_t count)
+{
+    Job* job = new Job();
+    JobHandle handle = JobHandle::Adopt(job);
+    job->function = std::move(function);
+    // Held until every dependency is registered, so none can schedule the job early.
+    job->pendingDependencies.store(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < count; i++)
+    {
+        Job* dependency = dependencies[i].m_job;
+        if (dependency == nullptr)
+        {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(dependency->mutex);
+        if (dependency->isFinished == false)
+        {
+            AddReference(job);
+            job->pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+            dependency->continuations.push_back(job);
+        }
+    }
+
+    if (job->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        Schedule(job);
+    }
+    return handle;
+}
+
+void Wait(const JobHandle& job)
+{
+    while (job.IsDone() == false)
+    {
+        Job* other = FindJob();
+        if (other != nullptr)
+        {
+            Execute(other);
+        }
+        else
+        {
+            // What's left of the job runs on other threads.
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& function)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    const size_t workers = WorkerCount();
+    if (grain == 0)
+    {
+        grain = std::max<size_t>(1, count / ((workers + 1) * 4));
+    }
+    const size_t chunks = (count + grain - 1) / grain;
+    if (workers == 0 || chunks == 1)
+    {
+        function(0, count);
+        return;
+    }
+
+    // The chunks are children of a root job, which finishes once they all did.
+    Job* root = new Job();
+    root->unfinished.store(int(chunks), std::memory_order_relaxed);
+    JobHandle handle = JobHandle::Adopt(root);
+    for (size_t chunk = 1; chunk < chunks; chunk++)
+    {
+        Job* job = new Job();
+        const size_t begin = chunk * grain;
+        const size_t end = std::min(count, begin + grain);
+        job->function = [&function, begin, end]()
+        {
+            function(begin, end);
+        };
+        job->parent = root;
+        AddReference(root);
+        Schedule(job);
+        Release(job);
+    }
+
+    // The calling thread takes the first chunk, then helps with the others.
+    function(0, std::min(count, grain));
+    Finish(root);
+    Wait(handle);
+}
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+
+/**
+ * Jobs shared by the whole application, run by one worker thread per core.
+ * Every worker owns a work-stealing deque: the jobs it submits are pushed to and popped from its
+ * end of the deque (most recent first, while their data is still in cache), and idle workers
+ * steal the oldest jobs from the other end of the others' deques. Threads that aren't workers
+ * (the main, physics and exporter threads) submit to a shared queue that the workers also take from.
+ *
+ * Waiting for a job never blocks a thread: Wait runs other jobs until the one waited for is done,
+ * so jobs can wait for jobs, and a thread waiting for a ParallelFor runs its share of it.
+ * Jobs must not throw.
+ *
+ * Before Init and after Shutdown, jobs are run at once on the thread submitting them.
+ */
+namespace Jobs
+{
+struct Job;
+
+/**
+ * @class   JobHandle
+ * @brief   A reference to a submitted job, to wait for it or to make other jobs depend on it.
+ *          The job is kept alive while a handle refers to it.
+ */
+class JobHandle
+{
+public:
+    JobHandle() = default;
+    JobHandle(const JobHandle& other);
+    JobHandle(JobHandle&& other) noexcept;
+    JobHandle& operator=(const JobHandle& other);
+    JobHandle& operator=(JobHandle&& other) noexcept;
+    ~JobHandle();
+
+    inline bool IsValid() const
+    {
+        return m_job != nullptr;
+    }
+    /**
+     * @brief   Check if the job and everything it waits for finished. An invalid handle is done.
+     */
+    bool IsDone() const;
+
+private:
+    friend JobHandle Submit(std::function<void()> function, const JobHandle* dependencies, size_t count);
+    friend void Wait(const JobHandle& job);
+    friend void ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& function);
+    explicit JobHandle(Job* job);
+    /**
+     * @brief   Make a handle that takes over the reference a new job is created with.
+     */
+    static JobHandle Adopt(Job* job);
+
+private:
+    Job* m_job = nullptr;
+};
+
+/**
+ * @brief   Start the worker threads.
+ * @param   workerCount: 0 for one per core but one, left to the thread calling Init.
+ */
+void Init(unsigned int workerCount = 0);
+
+/**
+ * @brief   Run the jobs still queued and stop the worker threads.
+ */
+void Shutdown();
+
+/**
+ * @brief   Get the number of worker threads, 0 when the jobs are run at once.
+ */
+unsigned int WorkerCount();
+
+/**
+ * @brief   Queue a job.
+ * @param   dependencies: Jobs that must finish before this one starts.
+ */
+JobHandle Submit(std::function<void()> function, const JobHandle* dependencies, size_t count);
+inline JobHandle Submit(std::function<void()> function, std::initializer_list<JobHandle> dependencies = {})
+{
+    return Submit(std::move(function), dependencies.begin(), dependencies.size());
+}
+
+/**
+ * @brief   Run other jobs until a job is done.
+ */
+void Wait(const JobHandle& job);
+
+/**
+ * @brief   Call function(begin, end) over [0..count) split in ranges of grain items, in parallel,
+ *          and return once every range is done. The calling thread runs ranges too.
+ * @param   grain: Items per job, 0 to split the range in a few jobs per worker.
+ */
+void ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& function);
+}
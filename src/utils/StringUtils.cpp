@@ -78,11 +78,15 @@ std::wstring StringUtils::StringToLongString(const std::string& src)
 }
 
 std::string StringUtils::GetCurrentTimeFormated(void)
+{
+    return GetTimeFormated(time(0));
+}
+
+std::string StringUtils::GetTimeFormated(time_t time)
 {
     char timeStamp[100] = { 0 };
-    time_t raw_now = time(0);
     struct tm now;
-    localtime_s(&now, &raw_now);
+    localtime_s(&now, &time);
 
     strftime(timeStamp, sizeof(timeStamp), "[%x - %X]", &now);
 
@@ -16,6 +16,7 @@
 /*****************************************************************************/
 /* Includes */
 #include <iostream>
+#include <time.h>
 
 namespace StringUtils
 {
@@ -45,6 +46,7 @@ namespace StringUtils
     std::wstring StringToLongString(const std::string& src);
 
     std::string GetCurrentTimeFormated(void);
+    std::string GetTimeFormated(time_t time);
 }
 /* Have a wonderful day :) */
 #endif /* _StringUtils */
@@ -0,0 +1,86 @@
+#include "Bvh.h"
+#include <algorithm>
+
+namespace Renderer
+{
+Bvh Bvh::Build(const std::vector<Aabb>& bounds, unsigned int maxLeafSize, std::vector<unsigned int>& order)
+{
+    std::vector<BvhNode> nodes;
+    order.resize(bounds.size());
+    for (unsigned int i = 0; i < (unsigned int)order.size(); i++)
+    {
+        order[i] = i;
+    }
+    if (bounds.empty() == true)
+    {
+        return Bvh();
+    }
+    if (maxLeafSize == 0)
+    {
+        maxLeafSize = 1;
+    }
+
+    std::vector<ImVec2> centers(bounds.size());
+    for (size_t i = 0; i < bounds.size(); i++)
+    {
+        centers[i] = bounds[i].Center();
+    }
+
+    // Each node is split in two until it holds few enough primitives.
+    // Children are always appended after their parent.
+    nodes.reserve(2 * (bounds.size() / maxLeafSize + 1));
+    nodes.push_back(BvhNode());
+    nodes[0].first = 0;
+    nodes[0].count = (unsigned int)bounds.size();
+
+    std::vector<unsigned int> pending = { 0 };
+    while (pending.empty() == false)
+    {
+        unsigned int nodeIndex = pending.back();
+        pending.pop_back();
+
+        unsigned int first = nodes[nodeIndex].first;
+        unsigned int count = nodes[nodeIndex].count;
+
+        Aabb nodeBounds;
+        Aabb centerBounds;
+        for (unsigned int i = first; i < first + count; i++)
+        {
+            nodeBounds.Add(bounds[order[i]]);
+            centerBounds.Add(centers[order[i]]);
+        }
+        nodes[nodeIndex].bounds = nodeBounds;
+
+        if (count <= maxLeafSize)
+        {
+            continue;
+        }
+
+        // Split at the median along the longest axis of the centers.
+        bool splitX = (centerBounds.max.x - centerBounds.min.x) >= (centerBounds.max.y - centerBounds.min.y);
+        unsigned int half = count / 2;
+        std::nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count,
+                         [&centers, splitX](unsigned int a, unsigned int b)
+                         {
+                             return splitX ? centers[a].x < centers[b].x : centers[a].y < centers[b].y;
+                         });
+
+        unsigned int left = (unsigned int)nodes.size();
+        BvhNode child;
+        child.first = first;
+        child.count = half;
+        nodes.push_back(child);
+        child.first = first + half;
+        child.count = count - half;
+        nodes.push_back(child);
+
+        nodes[nodeIndex].first = left;
+        nodes[nodeIndex].count = 0;
+
+        pending.push_back(left + 1);
+        pending.push_back(left);
+    }
+
+    return Bvh(Array<BvhNode>(std::move(nodes)));
+}
+}
@@ -0,0 +1,194 @@
+#pragma once
+#include "utils/Array.h"
+#include "utils/rendering/Transform.h"
+#include "vendor/imgui/imgui.h"
+#include <float.h>
+#include <vector>
+
+namespace Renderer
+{
+
+/**
+ * @struct  Aabb
+ * @brief   Axis-aligned bounding box.
+ *          A default constructed box is empty: it contains nothing and overlaps nothing.
+ */
+struct Aabb
+{
+    ImVec2 min = ImVec2(FLT_MAX, FLT_MAX);
+    ImVec2 max = ImVec2(-FLT_MAX, -FLT_MAX);
+
+    Aabb() = default;
+    Aabb(const ImVec2& mn, const ImVec2& mx) : min(mn), max(mx)
+    {
+    }
+
+    inline bool IsEmpty() const
+    {
+        return min.x > max.x || min.y > max.y;
+    }
+
+    inline void Add(const ImVec2& p)
+    {
+        min.x = p.x < min.x ? p.x : min.x;
+        min.y = p.y < min.y ? p.y : min.y;
+        max.x = p.x > max.x ? p.x : max.x;
+        max.y = p.y > max.y ? p.y : max.y;
+    }
+
+    inline void Add(const Aabb& other)
+    {
+        if (other.IsEmpty() == false)
+        {
+            Add(other.min);
+            Add(other.max);
+        }
+    }
+
+    inline bool Overlaps(const Aabb& other) const
+    {
+        return min.x <= other.max.x && max.x >= other.min.x &&
+            min.y <= other.max.y && max.y >= other.min.y;
+    }
+
+    inline ImVec2 Center() const
+    {
+        return ImVec2((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f);
+    }
+
+    /**
+     * @brief   Get the box that contains this box once transformed.
+     */
+    inline Aabb Transformed(const Transform& transform) const
+    {
+        Aabb out;
+        if (IsEmpty() == false)
+        {
+            out.Add(transform.Apply(min));
+            out.Add(transform.Apply(max));
+            out.Add(transform.Apply(ImVec2(min.x, max.y)));
+            out.Add(transform.Apply(ImVec2(max.x, min.y)));
+        }
+        return out;
+    }
+};
+
+/**
+ * @struct  BvhNode
+ * @brief   Node of a bounding volume hierarchy.
+ *          Leaves (count > 0) hold the primitives [first, first + count) of the BVH's primitive order.
+ *          Other nodes have their two children at first and first + 1.
+ */
+struct BvhNode
+{
+    Aabb bounds;
+    unsigned int first = 0;
+    unsigned int count = 0;
+
+    inline bool IsLeaf() const
+    {
+        return count > 0;
+    }
+};
+
+/**
+ * @class   Bvh
+ * @brief   Bounding volume hierarchy over a set of primitives, built by median split.
+ *          The nodes are stored in a flat array, and children always come after their parent,
+ *          so the bounds can be refitted bottom-up by walking the array backwards.
+ *          The nodes can be viewed from outside memory, like a mapped file, and are only copied when refitted.
+ */
+class Bvh
+{
+public:
+    Bvh() = default;
+
+    /**
+     * @brief   Build a BVH over primitives with the given bounds.
+     * @param   bounds: Bounds of every primitive.
+     * @param   maxLeafSize: Maximum number of primitives in a leaf.
+     * @param   order: Filled with the primitives in the order the leaves refer to them.
+     *          order[i] is the index of the i-th primitive in bounds.
+     */
+    static Bvh Build(const std::vector<Aabb>& bounds, unsigned int maxLeafSize, std::vector<unsigned int>& order);
+
+    /**
+     * @brief   Rebuild a BVH from previously built nodes, e.g. when loaded from a file.
+     */
+    explicit Bvh(Array<BvhNode> nodes) : m_nodes(std::move(nodes))
+    {
+    }
+
+    /**
+     * @brief   Walk the nodes whose bounds are accepted by overlaps and call onLeaf for every accepted leaf.
+     * @param   overlaps: bool(const Aabb&), whether a node's bounds must be visited.
+     * @param   onLeaf: void(const BvhNode&), called for every visited leaf, in primitive order.
+     */
+    template<typename OverlapFunc, typename LeafFunc>
+    inline void Traverse(OverlapFunc&& overlaps, LeafFunc&& onLeaf) const
+    {
+        if (m_nodes.empty() == true)
+        {
+            return;
+        }
+        unsigned int stack[64];
+        int size = 0;
+        stack[size++] = 0;
+        while (size > 0)
+        {
+            const BvhNode& node = m_nodes[stack[--size]];
+            if (overlaps(node.bounds) == false)
+            {
+                continue;
+            }
+            if (node.IsLeaf())
+            {
+                onLeaf(node);
+            }
+            else
+            {
+                // Right first so that the left child is visited first.
+                stack[size++] = node.first + 1;
+                stack[size++] = node.first;
+            }
+        }
+    }
+
+    /**
+     * @brief   Recompute the bounds of every node after the primitives moved.
+     * @param   leafBounds: Aabb(const BvhNode&), the new bounds of a leaf's primitives.
+     */
+    template<typename LeafBoundsFunc>
+    inline void Refit(LeafBoundsFunc&& leafBounds)
+    {
+        BvhNode* nodes = m_nodes.MutableData();
+        for (size_t i = m_nodes.size(); i-- > 0;)
+        {
+            BvhNode& node = nodes[i];
+            if (node.IsLeaf())
+            {
+                node.bounds = leafBounds(node);
+            }
+            else
+            {
+                node.bounds = nodes[node.first].bounds;
+                node.bounds.Add(nodes[node.first + 1].bounds);
+            }
+        }
+    }
+
+    inline const Array<BvhNode>& Nodes() const
+    {
+        return m_nodes;
+    }
+
+    inline const Aabb& Bounds() const
+    {
+        static const Aabb empty;
+        return m_nodes.empty() ? empty : m_nodes[0].bounds;
+    }
+
+private:
+    Array<BvhNode> m_nodes = Array<BvhNode>();
+};
+}
@@ -3,51 +3,75 @@
 
 namespace Renderer
 {
+/**
+ * @class   Color
+ * @brief   A color packed like ImGui's colors (IM_COL32), ready to be written in the vertex stream.
+ */
 class Color
 {
 public:
     Color() = default;
-    Color(ImU32 col)
+    Color(ImU32 col) : m_col(col)
     {
-        // Get a [0..1] val for each color.
-        m_col.x = float((col & 0xFF000000) >> 24) / 256.f;  // R
-        m_col.y = float((col & 0x00FF0000) >> 16) / 256.f;  // G
-        m_col.z = float((col & 0x0000FF00) >> 8) / 256.f;   // B
-        m_col.w = float((col & 0x000000FF)) / 256.f;        // A
     }
-    Color(const ImVec4& col) : m_col(col)
+    Color(const ImVec4& col) : m_col(ImGui::ColorConvertFloat4ToU32(col))
     {
     }
     Color(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
-        : m_col(ImVec4(r, g, b, a))
+        : m_col(IM_COL32(r, g, b, a))
     {
     }
 
-    inline ImU32 Full() const
+    inline const ImU32& Full() const
     {
-        return ImGui::GetColorU32(m_col);
+        return m_col;
     }
 
     inline float R() const
     {
-        return m_col.x;
+        return float((m_col >> IM_COL32_R_SHIFT) & 0xFF) / 255.f;
     }
 
     inline float G() const
     {
-        return m_col.y;
+        return float((m_col >> IM_COL32_G_SHIFT) & 0xFF) / 255.f;
     }
 
     inline float B() const
     {
-        return m_col.z;
+        return float((m_col >> IM_COL32_B_SHIFT) & 0xFF) / 255.f;
     }
 
     inline float A() const
     {
-        return m_col.w;
+        return float((m_col >> IM_COL32_A_SHIFT) & 0xFF) / 255.f;
+    }
+
+    /**
+     * @brief   Multiply two packed colors channel by channel, e.g. to tint a color.
+     */
+    static inline ImU32 Multiply(ImU32 col, ImU32 tint)
+    {
+        ImU32 out = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            ImU32 c = (col >> shift) & 0xFF;
+            ImU32 t = (tint >> shift) & 0xFF;
+            out |= (((c * t) + 127) / 255) << shift;
+        }
+        return out;
+    }
+
+    /**
+     * @brief   Multiply the alpha of a packed color.
+     * @param   alpha: The factor, in the [0..1] range.
+     */
+    static inline ImU32 Fade(ImU32 col, float alpha)
+    {
+        alpha = alpha > 0.0f ? (alpha < 1.0f ? alpha : 1.0f) : 0.0f;
+        return Multiply(col, IM_COL32(255, 255, 255, ImU32((alpha * 255.0f) + 0.5f)));
     }
 private:
-    ImVec4 m_col = ImVec4();
+    ImU32 m_col = 0;
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,131 @@
+#include "ColorTransform.h"
+#include "utils/rendering/Color.h"
+#include <string.h>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLOR_TRANSFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Renderer::ColorTransform
+{
+static constexpr int HEAT_LUT_SIZE = 256;
+
+static const ImU32* GetHeatLut(void);
+
+
+void Tint(const ImU32* in, ImU32* out, size_t count, ImU32 tint)
+{
+    if ( tint == IM_COL32_WHITE )
+    {
+        if ( in != out )
+        {
+            memmove(out, in, count * sizeof(ImU32));
+        }
+        return;
+    }
+
+    size_t i = 0;
+#ifdef COLOR_TRANSFORM_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i half = _mm_set1_epi16(127);
+    // The 4 channels of the tint, twice: one color per 64 bits once widened to 16 bits per channel.
+    const __m128i t = _mm_unpacklo_epi8(_mm_set1_epi32(int(tint)), zero);
+    // 4 colors per iteration.
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), t), half);
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), t), half);
+        // x / 255 == (x + (x >> 8) + 1) >> 8 for every x up to 255 * 255 + 127.
+        lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), one), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), one), 8);
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for ( ; i < count; i++ )
+    {
+        out[i] = Color::Multiply(in[i], tint);
+    }
+}
+
+void Fade(const ImU32* in, ImU32* out, size_t count, float alpha)
+{
+    Tint(in, out, count, Color::Fade(IM_COL32_WHITE, alpha));
+}
+
+void Heat(const float* values, ImU32* out, size_t count, float min, float max)
+{
+    const ImU32* lut = GetHeatLut();
+    const float scale = max > min ? float(HEAT_LUT_SIZE - 1) / (max - min) : 0.0f;
+
+    size_t i = 0;
+#ifdef COLOR_TRANSFORM_SSE2
+    const __m128 vMin = _mm_set1_ps(min);
+    const __m128 vScale = _mm_set1_ps(scale);
+    const __m128 vHalf = _mm_set1_ps(0.5f);
+    const __m128 vZero = _mm_setzero_ps();
+    const __m128 vLast = _mm_set1_ps(float(HEAT_LUT_SIZE - 1));
+    alignas(16) int index[4];
+    // 4 values per iteration. SSE2 has no gather, the colormap lookups stay scalar.
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        __m128 v = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(values + i), vMin), vScale);
+        // _mm_max_ps returns its second operand when the first is a NaN.
+        v = _mm_min_ps(_mm_max_ps(v, vZero), vLast);
+        _mm_store_si128((__m128i*)index, _mm_cvttps_epi32(_mm_add_ps(v, vHalf)));
+        out[i] = lut[index[0]];
+        out[i + 1] = lut[index[1]];
+        out[i + 2] = lut[index[2]];
+        out[i + 3] = lut[index[3]];
+    }
+#endif
+    for ( ; i < count; i++ )
+    {
+        float v = (values[i] - min) * scale;
+        v = v > 0.0f ? v : 0.0f;
+        v = v < float(HEAT_LUT_SIZE - 1) ? v : float(HEAT_LUT_SIZE - 1);
+        out[i] = lut[int(v + 0.5f)];
+    }
+}
+
+ImU32 HeatColor(float t)
+{
+    ImU32 col;
+    Heat(&t, &col, 1, 0.0f, 1.0f);
+    return col;
+}
+
+/**
+ * Build the colormap the first time it is used, by interpolating between a few stops
+ * taken from matplotlib's inferno, which stays readable in grayscale.
+ */
+static const ImU32* GetHeatLut(void)
+{
+    struct Lut
+    {
+        ImU32 colors[HEAT_LUT_SIZE];
+        Lut()
+        {
+            static constexpr float stops[][3] = { { 0, 0, 4 }, { 87, 16, 110 }, { 188, 55, 84 },
+                                                  { 249, 142, 9 }, { 252, 255, 164 } };
+            constexpr int stopCount = int(sizeof(stops) / sizeof(stops[0]));
+            for ( int i = 0; i < HEAT_LUT_SIZE; i++ )
+            {
+                float pos = float(i) * float(stopCount - 1) / float(HEAT_LUT_SIZE - 1);
+                int stop = int(pos) < stopCount - 1 ? int(pos) : stopCount - 2;
+                float f = pos - float(stop);
+                unsigned char rgb[3];
+                for ( int c = 0; c < 3; c++ )
+                {
+                    rgb[c] = (unsigned char)(stops[stop][c] + ((stops[stop + 1][c] - stops[stop][c]) * f) + 0.5f);
+                }
+                colors[i] = IM_COL32(rgb[0], rgb[1], rgb[2], 255);
+            }
+        }
+    };
+    static const Lut lut;
+    return lut.colors;
+}
+}
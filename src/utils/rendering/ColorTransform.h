@@ -0,0 +1,39 @@
+#pragma once
+#include "vendor/imgui/imgui.h"
+
+/**
+ * Batch operations on arrays of packed colors (IM_COL32), like the vertex colors of a mesh.
+ * Each operation is a single pass over the array, 4 colors at a time with SSE2 when the
+ * target has it. The results are identical to the scalar Color functions.
+ */
+namespace Renderer::ColorTransform
+{
+/**
+ * @brief   Multiply count colors channel by channel with a tint, see Color::Multiply.
+ * @param   in: The colors to tint.
+ * @param   out: Where to write the tinted colors. Can be the same as in.
+ */
+void Tint(const ImU32* in, ImU32* out, size_t count, ImU32 tint);
+
+/**
+ * @brief   Multiply the alpha of count colors, see Color::Fade.
+ * @param   alpha: The factor, in the [0..1] range.
+ */
+void Fade(const ImU32* in, ImU32* out, size_t count, float alpha);
+
+/**
+ * @brief   Map count values to an opaque heat colormap, from black through purple, red and orange to pale yellow.
+ *          Values are clamped to [min..max], and NaNs are mapped like min.
+ * @param   values: The values, e.g. temperatures or speeds.
+ * @param   out: Where to write the colors.
+ * @param   min: The value mapped to the coldest color.
+ * @param   max: The value mapped to the hottest color.
+ */
+void Heat(const float* values, ImU32* out, size_t count, float min, float max);
+
+/**
+ * @brief   Get the heat colormap's color at a position.
+ * @param   t: The position, in the [0..1] range.
+ */
+ImU32 HeatColor(float t);
+}
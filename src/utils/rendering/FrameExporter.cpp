@@ -0,0 +1,92 @@
+#include "FrameExporter.h"
+#include "widgets/Logger.h"
+#include <filesystem>
+#include <stdio.h>
+
+namespace Renderer
+{
+FrameExporter::FrameExporter(const std::string& directory, ImageFile::ImageFormat_t format, unsigned int threadCount)
+    : m_directory(directory), m_format(format)
+{
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error)
+    {
+        Logging::System.Error("Unable to create export directory: ", m_directory);
+    }
+
+    if (threadCount == 0)
+    {
+        threadCount = Jobs::WorkerCount() + 1;
+    }
+    m_maxPending = threadCount * MAX_PENDING_PER_THREAD;
+}
+
+FrameExporter::~FrameExporter()
+{
+    // The jobs refer to the exporter.
+    Finish();
+}
+
+std::vector<ImU32> FrameExporter::AcquireBuffer()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_freeBuffers.empty() == true)
+    {
+        return std::vector<ImU32>();
+    }
+    std::vector<ImU32> buffer = std::move(m_freeBuffers.back());
+    m_freeBuffers.pop_back();
+    return buffer;
+}
+
+void FrameExporter::Submit(std::vector<ImU32>&& pixels, int width, int height)
+{
+    if (m_pending.size() >= m_maxPending)
+    {
+        Jobs::Wait(m_pending.front());
+        m_pending.pop_front();
+    }
+    Frame frame = Frame { std::move(pixels), width, height, m_nextIndex++ };
+    m_pending.push_back(Jobs::Submit([this, frame = std::move(frame)]() mutable
+                                     {
+                                         Write(frame);
+                                     }));
+}
+
+bool FrameExporter::Finish()
+{
+    for (const Jobs::JobHandle& job : m_pending)
+    {
+        Jobs::Wait(job);
+    }
+    m_pending.clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failedCount == 0;
+}
+
+std::string FrameExporter::GetFramePath(size_t index) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "frame_%06zu.%s", index, ImageFile::GetExtension(m_format));
+    return m_directory + "/" + name;
+}
+
+void FrameExporter::Write(Frame& frame)
+{
+    // Every thread keeps its encoding buffer from frame to frame.
+    thread_local std::vector<unsigned char> encoded;
+    ImageFile::Encode(m_format, frame.pixels.data(), frame.width, frame.height, encoded);
+    std::string path = GetFramePath(frame.index);
+    if (ImageFile::Write(path, encoded) == false)
+    {
+        Logging::System.Error("Unable to write frame: ", path);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failedCount++;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_freeBuffers.push_back(std::move(frame.pixels));
+}
+}
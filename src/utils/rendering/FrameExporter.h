@@ -0,0 +1,81 @@
+#pragma once
+#include "utils/JobSystem.h"
+#include "utils/rendering/ImageFile.h"
+#include "vendor/imgui/imgui.h"
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Renderer
+{
+
+/**
+ * @class   FrameExporter
+ * @brief   Writes a sequence of frames as numbered image files (frame_000000.png, ...).
+ *          Every frame is encoded and written by a job while the next ones are being rendered, so the
+ *          frame loop only ever waits when MAX_PENDING_PER_THREAD frames per encoder are already
+ *          queued, which bounds the memory used. It then helps with the jobs until the oldest frame is written.
+ *          The pixel buffers are recycled once their frame is written.
+ */
+class FrameExporter
+{
+public:
+    static constexpr size_t MAX_PENDING_PER_THREAD = 2;
+
+    /**
+     * @param   directory: Where to write the frames, created if needed.
+     * @param   format: The format of the frames.
+     * @param   threadCount: Number of frames encoded at once, 0 for one per job worker and one for the caller.
+     */
+    FrameExporter(const std::string& directory, ImageFile::ImageFormat_t format, unsigned int threadCount = 0);
+    ~FrameExporter();
+    FrameExporter(const FrameExporter&) = delete;
+    FrameExporter& operator=(const FrameExporter&) = delete;
+
+    /**
+     * @brief   Get a buffer for the next frame, recycled from a frame already written if possible.
+     */
+    std::vector<ImU32> AcquireBuffer();
+
+    /**
+     * @brief   Queue a frame to be written as the next one of the sequence.
+     * @param   pixels: width * height pixels, packed like IM_COL32, top row first.
+     */
+    void Submit(std::vector<ImU32>&& pixels, int width, int height);
+
+    /**
+     * @brief   Wait until every frame submitted is written.
+     * @retval  False if any frame couldn't be written since the exporter was created.
+     */
+    bool Finish();
+
+    inline size_t SubmittedCount() const
+    {
+        return m_nextIndex;
+    }
+
+private:
+    struct Frame
+    {
+        std::vector<ImU32> pixels;
+        int width;
+        int height;
+        size_t index;
+    };
+
+    void Write(Frame& frame);
+    std::string GetFramePath(size_t index) const;
+
+private:
+    std::string m_directory = "";
+    ImageFile::ImageFormat_t m_format = ImageFile::IMAGE_FORMAT_PNG;
+    size_t m_maxPending = 0;
+    size_t m_nextIndex = 0;
+
+    std::deque<Jobs::JobHandle> m_pending = std::deque<Jobs::JobHandle>();  //!< Frames queued or being written, oldest first.
+    std::mutex m_mutex;                         //!< Guards the buffers and failures, shared with the jobs.
+    std::vector<std::vector<ImU32>> m_freeBuffers = std::vector<std::vector<ImU32>>();
+    size_t m_failedCount = 0;
+};
+}
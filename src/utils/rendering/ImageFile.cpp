@@ -0,0 +1,415 @@
+#include "ImageFile.h"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace Renderer::ImageFile
+{
+static constexpr int WINDOW_SIZE = 32768;       //!< Farthest a deflate match can refer back.
+static constexpr int MIN_MATCH = 3;
+static constexpr int MAX_MATCH = 258;
+static constexpr int HASH_BITS = 15;
+static constexpr int MAX_CHAIN = 8;             //!< Candidates tried per position, trading ratio for speed.
+static constexpr int MAX_INSERT_LENGTH = 16;    //!< Positions inside longer matches aren't indexed, like zlib's fast levels.
+
+static const uint16_t LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                          35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                          3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                            257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                            8193, 12289, 16385, 24577 };
+static const uint8_t DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                            7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+/**
+ * Writes bits least significant first, as deflate expects.
+ */
+class BitWriter
+{
+public:
+    explicit BitWriter(std::vector<unsigned char>& out) : m_out(out)
+    {
+    }
+
+    inline void Write(uint32_t value, int count)
+    {
+        m_bits |= (uint64_t)value << m_count;
+        m_count += count;
+        while (m_count >= 8)
+        {
+            m_out.push_back((unsigned char)m_bits);
+            m_bits >>= 8;
+            m_count -= 8;
+        }
+    }
+
+    /**
+     * @brief   Write a Huffman code, which is stored most significant bit first.
+     */
+    inline void WriteCode(uint32_t code, int count)
+    {
+        uint32_t reversed = 0;
+        for (int i = 0; i < count; i++)
+        {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+        Write(reversed, count);
+    }
+
+    inline void Flush()
+    {
+        if (m_count > 0)
+        {
+            m_out.push_back((unsigned char)m_bits);
+        }
+        m_bits = 0;
+        m_count = 0;
+    }
+
+private:
+    std::vector<unsigned char>& m_out;
+    uint64_t m_bits = 0;
+    int m_count = 0;
+};
+
+static void WriteLiteral(BitWriter& writer, int value)
+{
+    // Fixed Huffman codes of RFC 1951, section 3.2.6.
+    if (value < 144)
+    {
+        writer.WriteCode(0x30 + value, 8);
+    }
+    else if (value < 256)
+    {
+        writer.WriteCode(0x190 + value - 144, 9);
+    }
+    else if (value < 280)
+    {
+        writer.WriteCode(value - 256, 7);
+    }
+    else
+    {
+        writer.WriteCode(0xC0 + value - 280, 8);
+    }
+}
+
+static void WriteMatch(BitWriter& writer, int length, int distance)
+{
+    int code = 28;
+    while (LENGTH_BASE[code] > length)
+    {
+        code--;
+    }
+    WriteLiteral(writer, 257 + code);
+    writer.Write(length - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+
+    code = 29;
+    while (DISTANCE_BASE[code] > distance)
+    {
+        code--;
+    }
+    writer.WriteCode(code, 5);
+    writer.Write(distance - DISTANCE_BASE[code], DISTANCE_EXTRA[code]);
+}
+
+static inline uint32_t Hash(const unsigned char* p)
+{
+    uint32_t value = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16);
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/**
+ * @brief   Number of equal bytes at a and b, up to maxLength, compared 8 at a time.
+ */
+static inline int MatchLength(const unsigned char* a, const unsigned char* b, int maxLength)
+{
+    int length = 0;
+    while (length + 8 <= maxLength)
+    {
+        uint64_t x;
+        uint64_t y;
+        memcpy(&x, a + length, 8);
+        memcpy(&y, b + length, 8);
+        uint64_t difference = x ^ y;
+        if (difference != 0)
+        {
+            // Little-endian: the first different byte is the lowest non-zero one.
+            while ((difference & 0xFF) == 0)
+            {
+                difference >>= 8;
+                length++;
+            }
+            return length;
+        }
+        length += 8;
+    }
+    while (length < maxLength && a[length] == b[length])
+    {
+        length++;
+    }
+    return length;
+}
+
+/**
+ * @brief   Compress data as a single fixed Huffman deflate block, matching the most recent occurrences first.
+ */
+static void Deflate(const unsigned char* data, size_t size, std::vector<unsigned char>& out)
+{
+    BitWriter writer(out);
+    // Final block, fixed Huffman codes.
+    writer.Write(1, 1);
+    writer.Write(1, 2);
+
+    std::vector<int32_t> head(1 << HASH_BITS, -1);
+    std::vector<int32_t> previous(WINDOW_SIZE, -1);
+    auto insert = [&head, &previous, data](size_t position)
+    {
+        uint32_t hash = Hash(data + position);
+        previous[position % WINDOW_SIZE] = head[hash];
+        head[hash] = (int32_t)position;
+    };
+
+    size_t i = 0;
+    while (i < size)
+    {
+        int bestLength = 0;
+        int bestDistance = 0;
+        if (i + MIN_MATCH <= size)
+        {
+            const int maxLength = (int)std::min((size_t)MAX_MATCH, size - i);
+            int32_t candidate = head[Hash(data + i)];
+            for (int chain = 0; chain < MAX_CHAIN && candidate >= 0 && i - candidate <= WINDOW_SIZE; chain++)
+            {
+                int length = MatchLength(data + candidate, data + i, maxLength);
+                if (length > bestLength)
+                {
+                    bestLength = length;
+                    bestDistance = (int)(i - candidate);
+                    if (length == maxLength)
+                    {
+                        break;
+                    }
+                }
+                // Within the window, a position's entry can't have been overwritten yet.
+                candidate = previous[candidate % WINDOW_SIZE];
+            }
+            insert(i);
+        }
+
+        if (bestLength >= MIN_MATCH)
+        {
+            WriteMatch(writer, bestLength, bestDistance);
+            if (bestLength <= MAX_INSERT_LENGTH)
+            {
+                for (size_t j = i + 1; j < i + bestLength && j + MIN_MATCH <= size; j++)
+                {
+                    insert(j);
+                }
+            }
+            i += bestLength;
+        }
+        else
+        {
+            WriteLiteral(writer, data[i]);
+            i++;
+        }
+    }
+
+    WriteLiteral(writer, 256);
+    writer.Flush();
+}
+
+static uint32_t Adler32(const unsigned char* data, size_t size)
+{
+    uint32_t a = 1;
+    uint32_t b = 0;
+    while (size > 0)
+    {
+        // The sums can't overflow over 5552 bytes.
+        size_t block = std::min(size, (size_t)5552);
+        size -= block;
+        for (size_t i = 0; i < block; i++)
+        {
+            a += *data++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+static uint32_t Crc32(const unsigned char* data, size_t size)
+{
+    // Built once, thread-safely, on the first call.
+    static const std::array<uint32_t, 256> table = []()
+    {
+        std::array<uint32_t, 256> t = {};
+        for (uint32_t n = 0; n < 256; n++)
+        {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void WriteBigEndian(std::vector<unsigned char>& out, uint32_t value)
+{
+    out.push_back((unsigned char)(value >> 24));
+    out.push_back((unsigned char)(value >> 16));
+    out.push_back((unsigned char)(value >> 8));
+    out.push_back((unsigned char)value);
+}
+
+/**
+ * @brief   Append a PNG chunk whose data is already at the end of out, after its length and type.
+ */
+static void EndChunk(std::vector<unsigned char>& out, size_t chunkStart)
+{
+    const size_t dataStart = chunkStart + 8;
+    const uint32_t length = (uint32_t)(out.size() - dataStart);
+    out[chunkStart] = (unsigned char)(length >> 24);
+    out[chunkStart + 1] = (unsigned char)(length >> 16);
+    out[chunkStart + 2] = (unsigned char)(length >> 8);
+    out[chunkStart + 3] = (unsigned char)length;
+    WriteBigEndian(out, Crc32(&out[chunkStart + 4], length + 4));
+}
+
+static size_t BeginChunk(std::vector<unsigned char>& out, const char* type)
+{
+    size_t start = out.size();
+    WriteBigEndian(out, 0);
+    out.insert(out.end(), type, type + 4);
+    return start;
+}
+
+const char* GetExtension(ImageFormat_t format)
+{
+    switch (format)
+    {
+        case IMAGE_FORMAT_PNG:
+            return "png";
+        case IMAGE_FORMAT_RAW:
+        default:
+            return "rgba";
+    }
+}
+
+void Encode(ImageFormat_t format, const ImU32* pixels, int width, int height, std::vector<unsigned char>& out)
+{
+    if (format == IMAGE_FORMAT_PNG)
+    {
+        EncodePng(pixels, width, height, out);
+    }
+    else
+    {
+        // Pixels are already R, G, B and A bytes in memory.
+        const unsigned char* bytes = (const unsigned char*)pixels;
+        out.assign(bytes, bytes + (size_t)width * height * 4);
+    }
+}
+
+void EncodePng(const ImU32* pixels, int width, int height, std::vector<unsigned char>& out)
+{
+    // Filter each row with whichever of None, Sub or Up gives the smallest sum of absolute differences.
+    // The filtered rows are kept per thread so that encoding frame after frame doesn't allocate.
+    static thread_local std::vector<unsigned char> filtered;
+    const size_t stride = (size_t)width * 4;
+    filtered.resize((stride + 1) * height);
+    const unsigned char* bytes = (const unsigned char*)pixels;
+    for (int y = 0; y < height; y++)
+    {
+        const unsigned char* row = bytes + y * stride;
+        const unsigned char* above = y > 0 ? row - stride : row;
+        unsigned char* target = &filtered[y * (stride + 1)];
+
+        uint32_t noneCost = 0;
+        uint32_t subCost = 0;
+        uint32_t upCost = 0;
+        for (size_t i = 0; i < stride; i++)
+        {
+            noneCost += std::abs((int)(signed char)row[i]);
+            subCost += std::abs((int)(signed char)(row[i] - (i >= 4 ? row[i - 4] : 0)));
+            upCost += std::abs((int)(signed char)(row[i] - above[i]));
+        }
+        if (y == 0)
+        {
+            upCost = UINT32_MAX;
+        }
+
+        if (noneCost <= subCost && noneCost <= upCost)
+        {
+            target[0] = 0;
+            memcpy(target + 1, row, stride);
+        }
+        else if (subCost <= upCost)
+        {
+            target[0] = 1;
+            memcpy(target + 1, row, 4);
+            for (size_t i = 4; i < stride; i++)
+            {
+                target[1 + i] = (unsigned char)(row[i] - row[i - 4]);
+            }
+        }
+        else
+        {
+            target[0] = 2;
+            for (size_t i = 0; i < stride; i++)
+            {
+                target[1 + i] = (unsigned char)(row[i] - above[i]);
+            }
+        }
+    }
+
+    static const unsigned char SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    out.assign(SIGNATURE, SIGNATURE + 8);
+
+    size_t chunk = BeginChunk(out, "IHDR");
+    WriteBigEndian(out, (uint32_t)width);
+    WriteBigEndian(out, (uint32_t)height);
+    out.push_back(8);   // Bit depth.
+    out.push_back(6);   // RGBA.
+    out.push_back(0);   // Deflate.
+    out.push_back(0);   // Adaptive filtering.
+    out.push_back(0);   // Not interlaced.
+    EndChunk(out, chunk);
+
+    chunk = BeginChunk(out, "IDAT");
+    // zlib header: deflate with a 32K window, no dictionary, fastest compression level.
+    out.push_back(0x78);
+    out.push_back(0x01);
+    Deflate(filtered.data(), filtered.size(), out);
+    WriteBigEndian(out, Adler32(filtered.data(), filtered.size()));
+    EndChunk(out, chunk);
+
+    chunk = BeginChunk(out, "IEND");
+    EndChunk(out, chunk);
+}
+
+bool Write(const std::string& path, const std::vector<unsigned char>& data)
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (file.is_open() == false)
+    {
+        return false;
+    }
+    file.write((const char*)data.data(), data.size());
+    return file.good();
+}
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "vendor/imgui/imgui.h"
+#include <string>
+#include <vector>
+
+/**
+ * Image files, written from RGBA framebuffers packed like IM_COL32.
+ * PNG compression is done here, with a single-pass deflate (LZ77 and fixed Huffman codes)
+ * tuned for rendered frames: large flat areas and repeated rows compress to almost nothing.
+ */
+namespace Renderer::ImageFile
+{
+typedef enum
+{
+    IMAGE_FORMAT_PNG = 0,
+    IMAGE_FORMAT_RAW,       //!< Bare RGBA bytes, top row first, as in ffmpeg's rawvideo rgba format.
+} ImageFormat_t;
+
+/**
+ * @brief   Get the file extension of a format, without its dot.
+ */
+const char* GetExtension(ImageFormat_t format);
+
+/**
+ * @brief   Encode an image in a format.
+ * @param   pixels: width * height pixels, top row first.
+ * @param   out: The encoded file. Cleared first, its storage is reused.
+ */
+void Encode(ImageFormat_t format, const ImU32* pixels, int width, int height, std::vector<unsigned char>& out);
+
+/**
+ * @brief   Encode an image as an 8-bit RGBA PNG.
+ */
+void EncodePng(const ImU32* pixels, int width, int height, std::vector<unsigned char>& out);
+
+/**
+ * @brief   Write a whole buffer to a file, replacing it.
+ * @retval  False if the file couldn't be written.
+ */
+bool Write(const std::string& path, const std::vector<unsigned char>& data);
+}
@@ -0,0 +1,304 @@
+#include "MeshFile.h"
+#include "widgets/Logger.h"
+#include <fstream>
+#include <string.h>
+#include <type_traits>
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Renderer::MeshFile
+{
+static_assert(sizeof(Header) == 32, "Header layout changed, bump VERSION");
+static_assert(sizeof(Level) == 48, "Level layout changed, bump VERSION");
+static_assert(sizeof(ImVec2) == 8 && sizeof(ImU32) == 4 && sizeof(unsigned int) == 4, "Unexpected type sizes");
+static_assert(sizeof(BvhNode) == 24 && std::is_trivially_copyable<BvhNode>::value, "BvhNode layout changed, bump VERSION");
+
+/**
+ * A read-only file mapped in memory, unmapped when destroyed.
+ */
+class MappedFile
+{
+public:
+    ~MappedFile()
+    {
+#if defined(_WIN32)
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping != NULL)
+        {
+            CloseHandle(m_mapping);
+        }
+        if (m_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_file);
+        }
+#else
+        if (m_data != nullptr)
+        {
+            munmap((void*)m_data, m_size);
+        }
+#endif
+    }
+
+    /**
+     * @brief   Map a whole file.
+     * @retval  The mapped file, or nullptr if it couldn't be opened or is empty.
+     */
+    static std::shared_ptr<const MappedFile> Open(const std::string& path)
+    {
+        std::shared_ptr<MappedFile> file(new MappedFile());
+#if defined(_WIN32)
+        file->m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                   FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        LARGE_INTEGER size;
+        if (file->m_file == INVALID_HANDLE_VALUE || GetFileSizeEx(file->m_file, &size) == FALSE || size.QuadPart == 0)
+        {
+            return nullptr;
+        }
+        file->m_size = (size_t)size.QuadPart;
+        file->m_mapping = CreateFileMappingA(file->m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (file->m_mapping == NULL)
+        {
+            return nullptr;
+        }
+        file->m_data = (const unsigned char*)MapViewOfFile(file->m_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (file->m_data == nullptr)
+        {
+            return nullptr;
+        }
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0)
+        {
+            close(fd);
+            return nullptr;
+        }
+        file->m_size = (size_t)info.st_size;
+        void* data = mmap(nullptr, file->m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping stays valid once the descriptor is closed.
+        close(fd);
+        if (data == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        file->m_data = (const unsigned char*)data;
+#endif
+        return file;
+    }
+
+    inline const unsigned char* Data() const
+    {
+        return m_data;
+    }
+    inline size_t Size() const
+    {
+        return m_size;
+    }
+
+private:
+    MappedFile() = default;
+
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+#if defined(_WIN32)
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = NULL;
+#endif
+};
+
+static inline uint64_t Align(uint64_t offset)
+{
+    return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+/**
+ * @brief   Whether count elements of T at offset are entirely inside the file and correctly aligned.
+ */
+template<typename T>
+static bool IsInFile(uint64_t offset, uint64_t count, uint64_t fileSize)
+{
+    if (offset % alignof(T) != 0 || offset > fileSize)
+    {
+        return false;
+    }
+    return count <= (fileSize - offset) / sizeof(T);
+}
+
+/**
+ * @brief   Check that a level's indices and cluster hierarchy only refer to what exists.
+ */
+static bool IsLevelValid(const Level& level, const unsigned int* indices, const BvhNode* nodes)
+{
+    if (level.indexCount % 3 != 0 || (level.indexCount > 0 && level.nodeCount == 0))
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < level.indexCount; i++)
+    {
+        if (indices[i] >= level.vertexCount)
+        {
+            return false;
+        }
+    }
+
+    const uint32_t triangleCount = level.indexCount / 3;
+    for (uint32_t i = 0; i < level.nodeCount; i++)
+    {
+        const BvhNode& node = nodes[i];
+        if (node.IsLeaf())
+        {
+            if (node.first > triangleCount || node.count > triangleCount - node.first)
+            {
+                return false;
+            }
+        }
+        else if (node.first <= i || node.first >= level.nodeCount - 1)
+        {
+            // Children must come after their parent, which also rules out cycles.
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Save(const std::string& path, const MeshGeometry& geometry)
+{
+    const uint32_t levelCount = (uint32_t)geometry.LodCount();
+    std::vector<Level> levels(levelCount);
+
+    uint64_t offset = Align(sizeof(Header) + levelCount * sizeof(Level));
+    for (uint32_t i = 0; i < levelCount; i++)
+    {
+        const MeshGeometry& lod = geometry.Lod(i);
+        Level& level = levels[i];
+        level.error = geometry.LodError(i);
+        level.vertexCount = (uint32_t)lod.VertexCount();
+        level.indexCount = (uint32_t)lod.Indices().size();
+        level.nodeCount = (uint32_t)lod.Clusters().Nodes().size();
+        level.verticesOffset = offset;
+        offset = Align(offset + level.vertexCount * sizeof(ImVec2));
+        level.colorsOffset = offset;
+        offset = Align(offset + level.vertexCount * sizeof(ImU32));
+        level.indicesOffset = offset;
+        offset = Align(offset + level.indexCount * sizeof(unsigned int));
+        level.nodesOffset = offset;
+        offset = Align(offset + level.nodeCount * sizeof(BvhNode));
+    }
+
+    Header header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(Header);
+    header.levelCount = levelCount;
+    header.fileSize = offset;
+
+    std::vector<unsigned char> buffer((size_t)offset, 0);
+    memcpy(&buffer[0], &header, sizeof(Header));
+    memcpy(&buffer[sizeof(Header)], levels.data(), levelCount * sizeof(Level));
+    for (uint32_t i = 0; i < levelCount; i++)
+    {
+        const MeshGeometry& lod = geometry.Lod(i);
+        const Level& level = levels[i];
+        memcpy(&buffer[(size_t)level.verticesOffset], lod.Vertices().data(), level.vertexCount * sizeof(ImVec2));
+        memcpy(&buffer[(size_t)level.colorsOffset], lod.Colors().data(), level.vertexCount * sizeof(ImU32));
+        memcpy(&buffer[(size_t)level.indicesOffset], lod.Indices().data(), level.indexCount * sizeof(unsigned int));
+        memcpy(&buffer[(size_t)level.nodesOffset], lod.Clusters().Nodes().data(), level.nodeCount * sizeof(BvhNode));
+    }
+
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (file.is_open() == false)
+    {
+        Logging::System.Error("Unable to write mesh file: ", path);
+        return false;
+    }
+    file.write((const char*)buffer.data(), buffer.size());
+    return file.good();
+}
+
+std::shared_ptr<const MeshGeometry> Load(const std::string& path)
+{
+    std::shared_ptr<const MappedFile> file = MappedFile::Open(path);
+    if (file == nullptr)
+    {
+        return nullptr;
+    }
+
+    const unsigned char* data = file->Data();
+    const uint64_t size = file->Size();
+    Header header;
+    if (size < sizeof(Header))
+    {
+        Logging::System.Error("Invalid mesh file: ", path);
+        return nullptr;
+    }
+    memcpy(&header, data, sizeof(Header));
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.headerSize != sizeof(Header) ||
+        header.fileSize != size)
+    {
+        Logging::System.Error("Invalid mesh file: ", path);
+        return nullptr;
+    }
+    if (header.version != VERSION)
+    {
+        Logging::System.Error("Unsupported mesh file version: ", header.version);
+        return nullptr;
+    }
+    if (header.levelCount == 0 || header.levelCount > MeshGeometry::MAX_LOD_COUNT ||
+        IsInFile<Level>(sizeof(Header), header.levelCount, size) == false)
+    {
+        Logging::System.Error("Invalid mesh file: ", path);
+        return nullptr;
+    }
+
+    const Level* levels = (const Level*)(data + sizeof(Header));
+    std::vector<MeshGeometry> geometries;
+    geometries.reserve(header.levelCount);
+    for (uint32_t i = 0; i < header.levelCount; i++)
+    {
+        const Level& level = levels[i];
+        if (IsInFile<ImVec2>(level.verticesOffset, level.vertexCount, size) == false ||
+            IsInFile<ImU32>(level.colorsOffset, level.vertexCount, size) == false ||
+            IsInFile<unsigned int>(level.indicesOffset, level.indexCount, size) == false ||
+            IsInFile<BvhNode>(level.nodesOffset, level.nodeCount, size) == false)
+        {
+            Logging::System.Error("Invalid mesh file: ", path);
+            return nullptr;
+        }
+
+        const ImVec2* vertices = (const ImVec2*)(data + level.verticesOffset);
+        const ImU32* colors = (const ImU32*)(data + level.colorsOffset);
+        const unsigned int* indices = (const unsigned int*)(data + level.indicesOffset);
+        const BvhNode* nodes = (const BvhNode*)(data + level.nodesOffset);
+        if (IsLevelValid(level, indices, nodes) == false)
+        {
+            Logging::System.Error("Invalid mesh file: ", path);
+            return nullptr;
+        }
+
+        geometries.emplace_back(Array<ImVec2>(vertices, level.vertexCount, file),
+                                Array<ImU32>(colors, level.vertexCount, file),
+                                Array<unsigned int>(indices, level.indexCount, file),
+                                Bvh(Array<BvhNode>(nodes, level.nodeCount, file)));
+    }
+
+    std::shared_ptr<MeshGeometry> geometry = std::make_shared<MeshGeometry>(std::move(geometries[0]));
+    for (uint32_t i = 1; i < header.levelCount; i++)
+    {
+        geometry->AddLod(std::make_shared<const MeshGeometry>(std::move(geometries[i])), levels[i].error);
+    }
+    return geometry;
+}
+}
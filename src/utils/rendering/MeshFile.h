@@ -0,0 +1,62 @@
+#pragma once
+#include "utils/rendering/MeshGeometry.h"
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+/**
+ * Binary mesh files.
+ * A file holds every level of detail of a MeshGeometry, each with its vertices, packed colors,
+ * indices and cluster hierarchy, laid out exactly like they are in memory. Loading a file maps it
+ * in memory and the geometry views the mapped arrays directly, nothing is parsed or copied.
+ *
+ * Layout (little-endian):
+ *      Header
+ *      Level[levelCount]
+ *      Arrays, each aligned on ALIGNMENT bytes.
+ */
+namespace Renderer::MeshFile
+{
+constexpr char MAGIC[4] = { 'R', 'M', 'S', 'H' };
+constexpr uint32_t VERSION = 1;
+constexpr uint64_t ALIGNMENT = 16;
+
+struct Header
+{
+    char magic[4];          //!< Always MAGIC.
+    uint32_t version;       //!< VERSION of the writer.
+    uint32_t headerSize;    //!< sizeof(Header), to catch mismatched layouts.
+    uint32_t levelCount;    //!< Number of levels of detail, including the full geometry.
+    uint64_t fileSize;      //!< Size of the whole file, in bytes.
+    uint32_t reserved[2];
+};
+
+struct Level
+{
+    float error;            //!< Outline error of the level, in mesh coordinates. 0 for the full geometry.
+    uint32_t vertexCount;
+    uint32_t indexCount;    //!< 3 per triangle.
+    uint32_t nodeCount;     //!< Number of nodes in the cluster hierarchy.
+    uint64_t verticesOffset;//!< ImVec2[vertexCount].
+    uint64_t colorsOffset;  //!< ImU32[vertexCount].
+    uint64_t indicesOffset; //!< uint32_t[indexCount].
+    uint64_t nodesOffset;   //!< BvhNode[nodeCount].
+};
+
+/**
+ * @brief   Write a geometry and all of its levels of detail to a file.
+ * @param   path: Path of the file to write.
+ * @param   geometry: The geometry to write.
+ * @retval  False if the file couldn't be written.
+ */
+bool Save(const std::string& path, const MeshGeometry& geometry);
+
+/**
+ * @brief   Map a mesh file in memory and build a geometry that views its arrays.
+ *          The file stays mapped as long as the geometry, or a copy of its arrays, exists.
+ *          The whole file is validated so that a corrupted file can't make drawing read out of bounds.
+ * @param   path: Path of the file to load.
+ * @retval  The geometry, or nullptr if the file doesn't exist or isn't a valid mesh file.
+ */
+std::shared_ptr<const MeshGeometry> Load(const std::string& path);
+}
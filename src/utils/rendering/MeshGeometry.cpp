@@ -0,0 +1,579 @@
+#include "MeshGeometry.h"
+#include "utils/rendering/Meshes.h"
+#include <algorithm>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <unordered_map>
+
+namespace Renderer
+{
+/**
+ * Key used to find identical vertices. Positions and colors are compared bit for bit.
+ */
+struct VertexKey
+{
+    float x;
+    float y;
+    ImU32 col;
+
+    VertexKey(const ImVec2& pos, ImU32 color) : x(pos.x), y(pos.y), col(color)
+    {
+    }
+
+    bool operator==(const VertexKey& other) const
+    {
+        return memcmp(this, &other, sizeof(VertexKey)) == 0;
+    }
+};
+
+struct VertexKeyHash
+{
+    size_t operator()(const VertexKey& key) const
+    {
+        // FNV-1a over the raw bytes.
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&key);
+        size_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < sizeof(VertexKey); i++)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+};
+
+/**
+ * Edge collapse simplification of a MeshGeometry, used to build its levels of detail.
+ * A collapse moves a vertex onto one of its neighbours, removing the triangles using both.
+ * Collapses are applied in passes: every pass picks the cheapest collapse of each vertex,
+ * then applies them from the cheapest, skipping the ones next to a vertex that was already touched.
+ */
+class MeshSimplifier
+{
+public:
+    MeshSimplifier(const MeshGeometry& geometry) :
+        m_positions(geometry.Vertices().begin(), geometry.Vertices().end()),
+        m_colors(geometry.Colors().begin(), geometry.Colors().end()),
+        m_indices(geometry.Indices().begin(), geometry.Indices().end()),
+        m_isAlive(geometry.TriangleCount(), 1), m_triangleCount(geometry.TriangleCount())
+    {
+    }
+
+    /**
+     * @brief   Collapse edges until at most targetTriangles triangles are left.
+     * @retval  False if no collapse within maxError is left before reaching the target.
+     */
+    bool Reduce(size_t targetTriangles, float maxError)
+    {
+        while (m_triangleCount > targetTriangles)
+        {
+            if (CollapsePass(targetTriangles, maxError) == false)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t TriangleCount() const
+    {
+        return m_triangleCount;
+    }
+
+    /**
+     * @brief   Get the largest distance between the simplified and the original outlines.
+     */
+    float Error() const
+    {
+        float error = 0.0f;
+        for (const auto& edge : m_outline)
+        {
+            error = std::max(error, edge.second.error);
+        }
+        return error;
+    }
+
+    /**
+     * @brief   Build the geometry of the remaining triangles, in their original order.
+     */
+    MeshGeometry Build() const
+    {
+        std::vector<unsigned int> remap(m_positions.size(), UINT_MAX);
+        std::vector<ImVec2> vertices;
+        std::vector<ImU32> colors;
+        std::vector<unsigned int> indices;
+        indices.reserve(m_triangleCount * 3);
+        for (size_t t = 0; t < m_isAlive.size(); t++)
+        {
+            if (m_isAlive[t] == 0)
+            {
+                continue;
+            }
+            for (size_t k = 0; k < 3; k++)
+            {
+                unsigned int v = m_indices[t * 3 + k];
+                if (remap[v] == UINT_MAX)
+                {
+                    remap[v] = (unsigned int)vertices.size();
+                    vertices.push_back(m_positions[v]);
+                    colors.push_back(m_colors[v]);
+                }
+                indices.push_back(remap[v]);
+            }
+        }
+        return MeshGeometry(std::move(vertices), std::move(colors), std::move(indices));
+    }
+
+private:
+    struct Collapse
+    {
+        float error;        //!< Outline error after the collapse.
+        float length;       //!< Squared length of the collapsed edge, to prefer short edges.
+        unsigned int from;  //!< The removed vertex.
+        unsigned int to;    //!< The vertex it is moved onto.
+        unsigned int other; //!< For an outline vertex, its other outline neighbour.
+    };
+
+    /**
+     * An outline edge that replaced a part of the original outline.
+     */
+    struct OutlineEdge
+    {
+        std::vector<ImVec2> points; //!< The original outline vertices that were removed between the edge's ends.
+        float error;                //!< Largest distance from those vertices to the edge.
+    };
+
+    static inline uint64_t EdgeKey(unsigned int a, unsigned int b)
+    {
+        return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+    }
+
+    static inline float Cross(const ImVec2& a, const ImVec2& b, const ImVec2& c)
+    {
+        return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    }
+
+    static inline float SegmentDistance(const ImVec2& p, const ImVec2& a, const ImVec2& b)
+    {
+        float abX = b.x - a.x;
+        float abY = b.y - a.y;
+        float len2 = abX * abX + abY * abY;
+        float t = len2 > 0.0f ? ((p.x - a.x) * abX + (p.y - a.y) * abY) / len2 : 0.0f;
+        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+        float dX = p.x - (a.x + abX * t);
+        float dY = p.y - (a.y + abY * t);
+        return sqrtf(dX * dX + dY * dY);
+    }
+
+    /**
+     * @brief   List the alive triangles of every vertex and the uses of every edge.
+     */
+    void BuildAdjacency()
+    {
+        const size_t vertexCount = m_positions.size();
+        m_triangleStart.assign(vertexCount + 1, 0);
+        m_edgeUses.clear();
+        for (size_t t = 0; t < m_isAlive.size(); t++)
+        {
+            if (m_isAlive[t] == 0)
+            {
+                continue;
+            }
+            for (size_t k = 0; k < 3; k++)
+            {
+                m_triangleStart[m_indices[t * 3 + k] + 1]++;
+                m_edgeUses[EdgeKey(m_indices[t * 3 + k], m_indices[t * 3 + (k + 1) % 3])]++;
+            }
+        }
+        for (size_t v = 0; v < vertexCount; v++)
+        {
+            m_triangleStart[v + 1] += m_triangleStart[v];
+        }
+        m_vertexTriangles.resize(m_triangleStart[vertexCount]);
+        std::vector<unsigned int> cursor(m_triangleStart.begin(), m_triangleStart.end() - 1);
+        for (size_t t = 0; t < m_isAlive.size(); t++)
+        {
+            if (m_isAlive[t] == 1)
+            {
+                for (size_t k = 0; k < 3; k++)
+                {
+                    m_vertexTriangles[cursor[m_indices[t * 3 + k]]++] = (unsigned int)t;
+                }
+            }
+        }
+    }
+
+    unsigned int EdgeUses(unsigned int a, unsigned int b) const
+    {
+        auto it = m_edgeUses.find(EdgeKey(a, b));
+        return it == m_edgeUses.end() ? 0 : it->second;
+    }
+
+    void GetNeighbours(unsigned int v, std::vector<unsigned int>& out) const
+    {
+        out.clear();
+        for (unsigned int i = m_triangleStart[v]; i < m_triangleStart[v + 1]; i++)
+        {
+            const unsigned int* tri = &m_indices[m_vertexTriangles[i] * 3];
+            for (size_t k = 0; k < 3; k++)
+            {
+                if (tri[k] != v && std::find(out.begin(), out.end(), tri[k]) == out.end())
+                {
+                    out.push_back(tri[k]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief   Whether collapsing from onto to keeps the mesh manifold: the only neighbours the two vertices
+     *          have in common must be the third vertices of the triangles using the edge.
+     */
+    bool CheckLink(unsigned int from, unsigned int to, const std::vector<unsigned int>& fromNeighbours)
+    {
+        GetNeighbours(to, m_scratch);
+        size_t common = 0;
+        for (unsigned int n : fromNeighbours)
+        {
+            if (std::find(m_scratch.begin(), m_scratch.end(), n) != m_scratch.end())
+            {
+                common++;
+            }
+        }
+        return common == EdgeUses(from, to);
+    }
+
+    /**
+     * @brief   Whether moving from onto to would flip or flatten one of the triangles that are kept.
+     */
+    bool Flips(unsigned int from, unsigned int to) const
+    {
+        for (unsigned int i = m_triangleStart[from]; i < m_triangleStart[from + 1]; i++)
+        {
+            const unsigned int* tri = &m_indices[m_vertexTriangles[i] * 3];
+            if (tri[0] == to || tri[1] == to || tri[2] == to)
+            {
+                continue;
+            }
+            ImVec2 p[3] = { m_positions[tri[0]], m_positions[tri[1]], m_positions[tri[2]] };
+            float before = Cross(p[0], p[1], p[2]);
+            for (size_t k = 0; k < 3; k++)
+            {
+                if (tri[k] == from)
+                {
+                    p[k] = m_positions[to];
+                }
+            }
+            float after = Cross(p[0], p[1], p[2]);
+            if (after == 0.0f || (after > 0.0f) != (before > 0.0f))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief   Get the outline error after sliding an outline vertex onto one of its outline neighbours.
+     *          The outline then goes straight from the other neighbour to the target. Since the original
+     *          outline between them is a continuous chain, the largest distance between the two is the
+     *          largest distance from the chain's vertices to the new edge.
+     */
+    float OutlineError(unsigned int from, unsigned int to, unsigned int other) const
+    {
+        const ImVec2& a = m_positions[other];
+        const ImVec2& b = m_positions[to];
+        float error = SegmentDistance(m_positions[from], a, b);
+        for (uint64_t key : { EdgeKey(other, from), EdgeKey(from, to) })
+        {
+            auto it = m_outline.find(key);
+            if (it != m_outline.end())
+            {
+                for (const ImVec2& p : it->second.points)
+                {
+                    error = std::max(error, SegmentDistance(p, a, b));
+                }
+            }
+        }
+        return error;
+    }
+
+    /**
+     * @brief   Replace the two outline edges of a vertex by a single edge after it was collapsed.
+     */
+    void MergeOutline(const Collapse& collapse)
+    {
+        OutlineEdge merged;
+        merged.points.push_back(m_positions[collapse.from]);
+        merged.error = collapse.error;
+        for (uint64_t key : { EdgeKey(collapse.other, collapse.from), EdgeKey(collapse.from, collapse.to) })
+        {
+            auto it = m_outline.find(key);
+            if (it != m_outline.end())
+            {
+                merged.points.insert(merged.points.end(), it->second.points.begin(), it->second.points.end());
+                m_outline.erase(it);
+            }
+        }
+        m_outline[EdgeKey(collapse.other, collapse.to)] = std::move(merged);
+    }
+
+    /**
+     * @brief   Find the cheapest collapse of every vertex and apply as many as possible.
+     * @retval  False if no collapse could be applied.
+     */
+    bool CollapsePass(size_t targetTriangles, float maxError)
+    {
+        BuildAdjacency();
+
+        const unsigned int vertexCount = (unsigned int)m_positions.size();
+        std::vector<unsigned char> outlineEdges(vertexCount, 0);
+        std::vector<unsigned char> touched(vertexCount, 0);
+        for (const auto& edge : m_edgeUses)
+        {
+            unsigned int a = (unsigned int)(edge.first >> 32);
+            unsigned int b = (unsigned int)(edge.first & 0xFFFFFFFF);
+            if (edge.second == 1)
+            {
+                outlineEdges[a] = outlineEdges[a] < 255 ? outlineEdges[a] + 1 : 255;
+                outlineEdges[b] = outlineEdges[b] < 255 ? outlineEdges[b] + 1 : 255;
+            }
+            else if (edge.second > 2)
+            {
+                // Non-manifold edge, leave it alone.
+                touched[a] = 1;
+                touched[b] = 1;
+            }
+        }
+
+        std::vector<Collapse> collapses;
+        std::vector<unsigned int> neighbours;
+        for (unsigned int from = 0; from < vertexCount; from++)
+        {
+            if (m_triangleStart[from] == m_triangleStart[from + 1] || touched[from] == 1)
+            {
+                continue;
+            }
+            const bool isOutline = outlineEdges[from] > 0;
+            if (isOutline && outlineEdges[from] != 2)
+            {
+                // Corner where several outlines meet.
+                continue;
+            }
+
+            GetNeighbours(from, neighbours);
+            unsigned int outline[2] = { UINT_MAX, UINT_MAX };
+            if (isOutline)
+            {
+                size_t found = 0;
+                for (unsigned int n : neighbours)
+                {
+                    if (found < 2 && EdgeUses(from, n) == 1)
+                    {
+                        outline[found++] = n;
+                    }
+                }
+            }
+
+            Collapse best = { FLT_MAX, FLT_MAX, from, UINT_MAX, UINT_MAX };
+            for (unsigned int to : neighbours)
+            {
+                Collapse collapse = { 0.0f, 0.0f, from, to, UINT_MAX };
+                if (isOutline)
+                {
+                    // An outline vertex can only slide along the outline.
+                    if (to != outline[0] && to != outline[1])
+                    {
+                        continue;
+                    }
+                    collapse.other = to == outline[0] ? outline[1] : outline[0];
+                    collapse.error = OutlineError(from, to, collapse.other);
+                    if (collapse.error > maxError)
+                    {
+                        continue;
+                    }
+                }
+                float dX = m_positions[to].x - m_positions[from].x;
+                float dY = m_positions[to].y - m_positions[from].y;
+                collapse.length = dX * dX + dY * dY;
+                if (collapse.error > best.error || (collapse.error == best.error && collapse.length >= best.length))
+                {
+                    continue;
+                }
+                if (Flips(from, to) == true || CheckLink(from, to, neighbours) == false)
+                {
+                    continue;
+                }
+                best = collapse;
+            }
+            if (best.to != UINT_MAX)
+            {
+                collapses.push_back(best);
+            }
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b)
+                  {
+                      return a.error < b.error || (a.error == b.error && a.length < b.length);
+                  });
+
+        bool applied = false;
+        for (const Collapse& collapse : collapses)
+        {
+            if (m_triangleCount <= targetTriangles)
+            {
+                break;
+            }
+            if (touched[collapse.from] == 1 || touched[collapse.to] == 1 ||
+                (collapse.other != UINT_MAX && touched[collapse.other] == 1))
+            {
+                continue;
+            }
+
+            // The adjacency of everything around the two vertices is stale after this, lock it until the next pass.
+            for (unsigned int v : { collapse.from, collapse.to })
+            {
+                GetNeighbours(v, neighbours);
+                for (unsigned int n : neighbours)
+                {
+                    touched[n] = 1;
+                }
+                touched[v] = 1;
+            }
+
+            for (unsigned int i = m_triangleStart[collapse.from]; i < m_triangleStart[collapse.from + 1]; i++)
+            {
+                unsigned int t = m_vertexTriangles[i];
+                unsigned int* tri = &m_indices[t * 3];
+                if (tri[0] == collapse.to || tri[1] == collapse.to || tri[2] == collapse.to)
+                {
+                    m_isAlive[t] = 0;
+                    m_triangleCount--;
+                    continue;
+                }
+                for (size_t k = 0; k < 3; k++)
+                {
+                    if (tri[k] == collapse.from)
+                    {
+                        tri[k] = collapse.to;
+                    }
+                }
+            }
+            if (collapse.other != UINT_MAX)
+            {
+                MergeOutline(collapse);
+            }
+            applied = true;
+        }
+        return applied;
+    }
+
+private:
+    std::vector<ImVec2> m_positions;
+    std::vector<ImU32> m_colors;
+    std::vector<unsigned int> m_indices;
+    std::vector<unsigned char> m_isAlive;       //!< For every triangle, whether it wasn't collapsed.
+    std::unordered_map<uint64_t, OutlineEdge> m_outline; //!< Outline edges that replaced parts of the original outline.
+    size_t m_triangleCount;                     //!< Number of alive triangles.
+
+    std::vector<unsigned int> m_triangleStart;  //!< For every vertex, where its triangles start in m_vertexTriangles.
+    std::vector<unsigned int> m_vertexTriangles;
+    std::unordered_map<uint64_t, unsigned int> m_edgeUses;
+    std::vector<unsigned int> m_scratch;
+};
+
+MeshGeometry::MeshGeometry(Array<ImVec2> vertices, Array<ImU32> colors, Array<unsigned int> indices) :
+    m_vertices(std::move(vertices)), m_colors(std::move(colors)), m_indices(std::move(indices))
+{
+    BuildClusters();
+}
+
+MeshGeometry MeshGeometry::FromTriangles(const std::vector<Triangle>& triangles)
+{
+    std::vector<ImVec2> vertices;
+    std::vector<ImU32> colors;
+    std::vector<unsigned int> indices;
+    indices.reserve(triangles.size() * 3);
+
+    std::unordered_map<VertexKey, unsigned int, VertexKeyHash> uniqueVertices;
+    uniqueVertices.reserve(triangles.size() * 3);
+
+    for (const Triangle& triangle : triangles)
+    {
+        const ImU32 packed = triangle.m_col.Full();
+        for (const ImVec2* p : { &triangle.m_p1, &triangle.m_p2, &triangle.m_p3 })
+        {
+            auto it = uniqueVertices.emplace(VertexKey(*p, packed), (unsigned int)vertices.size());
+            if (it.second == true)
+            {
+                // First time this vertex is seen.
+                vertices.push_back(*p);
+                colors.push_back(packed);
+            }
+            indices.push_back(it.first->second);
+        }
+    }
+
+    vertices.shrink_to_fit();
+    colors.shrink_to_fit();
+    return MeshGeometry(std::move(vertices), std::move(colors), std::move(indices));
+}
+
+void MeshGeometry::BuildClusters()
+{
+    // Clusters are runs of consecutive triangles, so that drawing them in order keeps the triangles' draw order.
+    size_t triangleCount = TriangleCount();
+    size_t clusterCount = (triangleCount + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    std::vector<Aabb> bounds(clusterCount);
+    for (size_t i = 0; i < triangleCount * 3; i++)
+    {
+        bounds[i / (CLUSTER_SIZE * 3)].Add(m_vertices[m_indices[i]]);
+    }
+
+    std::vector<unsigned int> order;
+    m_clusters = Bvh::Build(bounds, 1, order);
+
+    // Make the leaves refer to the triangles of their cluster.
+    std::vector<BvhNode> nodes(m_clusters.Nodes().begin(), m_clusters.Nodes().end());
+    for (BvhNode& node : nodes)
+    {
+        if (node.IsLeaf())
+        {
+            size_t first = (size_t)order[node.first] * CLUSTER_SIZE;
+            node.first = (unsigned int)first;
+            node.count = (unsigned int)(triangleCount - first < CLUSTER_SIZE ? triangleCount - first : CLUSTER_SIZE);
+        }
+    }
+    m_clusters = Bvh(Array<BvhNode>(std::move(nodes)));
+}
+
+void MeshGeometry::BuildLods(float maxError)
+{
+    m_lods.clear();
+
+    MeshSimplifier simplifier(*this);
+    size_t triangleCount = TriangleCount();
+    while (LodCount() < MAX_LOD_COUNT && triangleCount > 1)
+    {
+        size_t target = triangleCount / 2;
+        bool reachedTarget = simplifier.Reduce(target, maxError);
+
+        // A level that is barely smaller than the previous one isn't worth its memory.
+        size_t reduced = simplifier.TriangleCount();
+        if (reduced * 4 > triangleCount * 3)
+        {
+            break;
+        }
+        m_lods.push_back({ std::make_shared<const MeshGeometry>(simplifier.Build()), simplifier.Error() });
+        triangleCount = reduced;
+
+        if (reachedTarget == false)
+        {
+            // Nothing else can be collapsed within maxError.
+            break;
+        }
+    }
+}
+}
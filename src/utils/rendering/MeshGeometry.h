@@ -0,0 +1,153 @@
+#pragma once
+#include "utils/Array.h"
+#include "utils/rendering/Bvh.h"
+#include "utils/rendering/Color.h"
+#include "vendor/imgui/imgui.h"
+#include <memory>
+#include <vector>
+
+namespace Renderer
+{
+class Triangle;
+
+/**
+ * @class   MeshGeometry
+ * @brief   Indexed geometry of a mesh, in mesh coordinates ([0..1] range).
+ *          Every unique vertex (position and packed color) is stored once, and triangles
+ *          refer to their vertices through an index array, 3 indices per triangle.
+ *          The three vertices of a triangle always have the same color.
+ *          The arrays can view outside memory, like a mapped mesh file (see MeshFile).
+ *          Consecutive triangles are grouped in clusters of up to CLUSTER_SIZE triangles,
+ *          under a bounding volume hierarchy, so that a mesh can be culled cluster by cluster.
+ *
+ *          The geometry can also hold a chain of simplified versions of itself (levels of detail),
+ *          see BuildLods.
+ */
+class MeshGeometry
+{
+public:
+    static constexpr unsigned int CLUSTER_SIZE = 128;   //!< Maximum number of triangles in a cluster.
+    static constexpr float DEFAULT_LOD_MAX_ERROR = 0.25f; //!< Largest error of the coarsest level, in mesh coordinates.
+    static constexpr size_t MAX_LOD_COUNT = 8;          //!< Maximum number of levels, including the full geometry.
+
+    MeshGeometry() = default;
+    /**
+     * @brief   Build geometry and its clusters from indexed data.
+     */
+    MeshGeometry(Array<ImVec2> vertices, Array<ImU32> colors, Array<unsigned int> indices);
+    /**
+     * @brief   Build geometry from indexed data and clusters that were already built, e.g. loaded from a file.
+     */
+    MeshGeometry(Array<ImVec2> vertices, Array<ImU32> colors, Array<unsigned int> indices, Bvh clusters) :
+        m_vertices(std::move(vertices)), m_colors(std::move(colors)), m_indices(std::move(indices)),
+        m_clusters(std::move(clusters))
+    {
+    }
+
+    /**
+     * @brief   Build indexed geometry from a list of triangles, merging the vertices
+     *          that have the exact same position and color.
+     * @param   triangles: The triangles, in mesh coordinates.
+     */
+    static MeshGeometry FromTriangles(const std::vector<Triangle>& triangles);
+
+    /**
+     * @brief   Build the chain of simplified levels of this geometry, replacing any existing one.
+     *          Each level has about half the triangles of the previous one, and is built by collapsing
+     *          edges. Interior vertices are removed freely, while the outlines (edges used by a single
+     *          triangle, which include the borders between colors) are only collapsed while they stay
+     *          within maxError of the original outline.
+     * @param   maxError: Largest allowed distance between the original and the simplified outlines, in mesh coordinates.
+     */
+    void BuildLods(float maxError = DEFAULT_LOD_MAX_ERROR);
+
+    /**
+     * @brief   Append a level of detail, coarser than the existing ones.
+     * @param   geometry: The simplified geometry.
+     * @param   error: Largest distance between its outline and the full geometry's, in mesh coordinates.
+     */
+    inline void AddLod(std::shared_ptr<const MeshGeometry> geometry, float error)
+    {
+        m_lods.push_back({ std::move(geometry), error });
+    }
+
+    /**
+     * @brief   Get the number of levels of detail, including the full geometry (level 0).
+     */
+    inline size_t LodCount() const
+    {
+        return m_lods.size() + 1;
+    }
+    /**
+     * @brief   Get a level of detail. Level 0 is this geometry, higher levels are coarser.
+     */
+    inline const MeshGeometry& Lod(size_t level) const
+    {
+        return level == 0 ? *this : *m_lods[level - 1].geometry;
+    }
+    /**
+     * @brief   Get the largest distance between the outlines of a level and of the full geometry, in mesh coordinates.
+     */
+    inline float LodError(size_t level) const
+    {
+        return level == 0 ? 0.0f : m_lods[level - 1].error;
+    }
+
+    inline const Array<ImVec2>& Vertices() const
+    {
+        return m_vertices;
+    }
+    /**
+     * @brief   Get the color of every vertex, packed like ImGui's colors (IM_COL32).
+     */
+    inline const Array<ImU32>& Colors() const
+    {
+        return m_colors;
+    }
+    inline const Array<unsigned int>& Indices() const
+    {
+        return m_indices;
+    }
+
+    /**
+     * @brief   Get the bounds of the geometry, in mesh coordinates.
+     */
+    inline const Aabb& Bounds() const
+    {
+        return m_clusters.Bounds();
+    }
+    /**
+     * @brief   Get the cluster hierarchy. Each leaf is a cluster, holding the triangles
+     *          [first, first + count), triangle i using the indices [3 * i, 3 * i + 3).
+     */
+    inline const Bvh& Clusters() const
+    {
+        return m_clusters;
+    }
+
+    inline size_t VertexCount() const
+    {
+        return m_vertices.size();
+    }
+    inline size_t TriangleCount() const
+    {
+        return m_indices.size() / 3;
+    }
+
+private:
+    struct LodLevel
+    {
+        std::shared_ptr<const MeshGeometry> geometry;
+        float error;
+    };
+
+    void BuildClusters();
+
+private:
+    Array<ImVec2> m_vertices = Array<ImVec2>();                 //!< Unique vertices.
+    Array<ImU32> m_colors = Array<ImU32>();                     //!< One packed color per vertex.
+    Array<unsigned int> m_indices = Array<unsigned int>();      //!< 3 vertex indices per triangle.
+    Bvh m_clusters = Bvh();                                     //!< Triangle clusters.
+    std::vector<LodLevel> m_lods = std::vector<LodLevel>();     //!< Simplified levels, from the finest to the coarsest.
+};
+}
@@ -1,9 +1,18 @@
 #pragma once
+#include "utils/rendering/Bvh.h"
 #include "utils/rendering/Color.h"
+#include "utils/rendering/ColorTransform.h"
+#include "utils/rendering/MeshGeometry.h"
+#include "utils/rendering/Transform.h"
+#include "utils/rendering/VertexTransform.h"
 #include "vendor/imgui/imgui.h"
 #include "widgets/Logger.h"
+#include <algorithm>
+#include <memory>
+#include <utility>
 #include <vector>
 #include <math.h>
+#include <string.h>
 #include <iostream>
 #include <sstream>
 
@@ -19,6 +28,7 @@ namespace Renderer
  */
 class Triangle
 {
+    friend class MeshGeometry;
 public:
     Triangle() = default;
     Triangle(const ImVec2& p1, const ImVec2& p2, const ImVec2& p3, ImVec4 col) :
@@ -38,15 +48,13 @@ public:
      */
     inline void Draw(const ImVec2& screenPos, const ImVec2& meshSize, ImVec2& anchor)
     {
-        ImVec2 p1 = ComputeRotation(m_p1, m_rotation);
-        ImVec2 p2 = ComputeRotation(m_p2, m_rotation);
-        ImVec2 p3 = ComputeRotation(m_p3, m_rotation);
         // Translate the mesh-coordinates of the triangle into absolute coordinates.
-        p1 = ((p1 * meshSize) + screenPos) - (anchor * meshSize);
-        p2 = ((p2 * meshSize) + screenPos) - (anchor * meshSize);
-        p3 = ((p3 * meshSize) + screenPos) - (anchor * meshSize);
+        Transform transform = Transform::FromMesh(screenPos, meshSize, anchor, m_rotation);
 
-        ImGui::GetWindowDrawList()->AddTriangleFilled(p1, p2, p3, m_col.Full());
+        ImGui::GetWindowDrawList()->AddTriangleFilled(transform.Apply(m_p1),
+                                                      transform.Apply(m_p2),
+                                                      transform.Apply(m_p3),
+                                                      ImGui::GetColorU32(m_col.Full()));
     }
     inline void Scale(float percent)
     {
@@ -102,60 +110,215 @@ private:
     ImVec2 m_p3 = ImVec2();
     Color m_col = Color();
     float m_rotation = 0.0f;
-
-    /**
-     * @brief   Apply rotation to the triangle by an amount between -360.0f and 360.0f.
-     *          This is accomplished by individually taking each point.
-     *          We treat a point like a Cartesian vector (x, y) and convert it to Polar (r, t).
-     *          We then add the desired angle to the new vector and translate it back to Cartesian.
-     * @param   from: A vector to apply the rotation to.
-     * @param   rot: The number of degrees to rotate the triangle by.
-     */
-    inline ImVec2 ComputeRotation(ImVec2 from, float rot)
-    {
-        static const float pi = 3.14159265359;
-        // If from == (0,0), the transformation will be erronous, so return.
-        if (from.x == 0 && from.y == 0)
-        {
-            return from;
-        }
-        float r = sqrt(pow(from.x, 2.f) + pow(from.y, 2.f));
-        float t = atan(from.y / from.x) * 180 / pi;
-        t += rot;
-        float x = r * cos((t * pi) / 180.0f); // cos takes radians, not degrees.
-        float y = r * sin((t * pi) / 180.0f); // sin takes radians, not degrees.
-
-        return ImVec2(x, y);
-    }
 };
 
+/**
+ * @struct  MeshInstance
+ * @brief   Placement of one copy of a mesh drawn with Mesh::DrawInstances.
+ *          Only what changes between the copies is stored, the geometry stays in the mesh.
+ */
+struct MeshInstance
+{
+    ImVec2 pos = ImVec2();          //!< Screen position of the instance's anchor.
+    ImVec2 size = ImVec2();         //!< Size in pixels.
+    float rotation = 0.0f;          //!< Rotation in degrees.
+    ImU32 tint = IM_COL32_WHITE;    //!< Multiplied with the color of every triangle.
+};
 
+/**
+ * @class   Mesh
+ * @brief   A collection of triangles drawn together.
+ *          The geometry is indexed (see MeshGeometry) and shared between copies of the mesh,
+ *          so every unique vertex is only stored and transformed once. The whole mesh is
+ *          written to the draw list in a single PrimReserve block instead of one
+ *          AddTriangleFilled call per triangle.
+ *
+ *          The mesh-to-screen transform is only rebuilt when the size, position, anchor or
+ *          rotation changes, and the resulting vertices are kept until the next change.
+ *          Drawing a mesh that didn't move is a copy of those vertices into the draw list.
+ *
+ *          A mesh outside of the window's clip rect is rejected from its bounds before anything
+ *          is transformed. A mesh that is partially visible only writes the triangle clusters
+ *          (see MeshGeometry::Clusters) that overlap the clip rect.
+ *
+ *          When the geometry has levels of detail (see MeshGeometry::BuildLods), the coarsest
+ *          level whose outline stays within the allowed pixel error at the mesh's size is drawn.
+ *          The level is picked when the size changes, and the caches are reserved for the full
+ *          geometry up front so switching levels never allocates.
+ *
+ *          The vertex colors are packed once, with the mesh's tint and the style's alpha, and only
+ *          packed again when one of them changes. HeatColors replaces the geometry's colors with a
+ *          colormap of per-vertex values, e.g. temperatures or speeds.
+ */
 class Mesh
 {
 public:
+    static constexpr float DEFAULT_LOD_PIXEL_ERROR = 0.5f;  //!< Default allowed outline error, in pixels.
+
     Mesh() = default;
+    /**
+     * @brief   Build a mesh and its levels of detail from a list of triangles.
+     */
     Mesh(const std::vector<Triangle>& triangles, const ImVec2& size, const ImVec2& pos, const ImVec2& anchor = ImVec2()) :
-        m_triangles(triangles), m_size(size), m_pos(pos), m_anchor(anchor)
+        Mesh(BuildGeometry(triangles), size, pos, anchor)
+    {
+    }
+    Mesh(std::shared_ptr<const MeshGeometry> geometry, const ImVec2& size, const ImVec2& pos, const ImVec2& anchor = ImVec2()) :
+        m_geometry(std::move(geometry)), m_size(size), m_pos(pos), m_anchor(anchor)
+    {
+        UpdateTransform();
+        ReserveCaches();
+    }
+
+    /**
+     * @brief   Build indexed geometry and its levels of detail from a list of triangles,
+     *          ready to be shared between meshes.
+     */
+    static inline std::shared_ptr<const MeshGeometry> BuildGeometry(const std::vector<Triangle>& triangles)
     {
+        MeshGeometry geometry = MeshGeometry::FromTriangles(triangles);
+        geometry.BuildLods();
+        return std::make_shared<const MeshGeometry>(std::move(geometry));
     }
 
+    /**
+     * @brief   Draw (Render) the mesh in the current window.
+     *          With anti-aliasing, the output has the same layout as calling AddTriangleFilled
+     *          for every visible triangle, including the fringe and the points where ImGui would
+     *          start a new vertex block for 16-bit indices.
+     *          Without anti-aliasing, the unique vertices are written once and the triangles
+     *          index them directly.
+     */
     inline void Draw()
     {
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
         ImVec2 drawPos = ImVec2(m_pos.x - (m_anchor.x * m_size.x),
                                 m_pos.y - (m_anchor.y * m_size.y));
-        for (auto& triangle : m_triangles)
+
+        const Aabb clip = GetClipBounds(drawList);
+        if (FindVisibleClusters(DrawGeometry(), m_transform, clip, m_drawClusters) == true)
         {
-            triangle.Draw(m_pos, m_size, m_anchor);
+            const bool antiAliased = (drawList->Flags & ImDrawListFlags_AntiAliasedFill) != 0;
+            const ImVec2 uv = ImGui::GetFontTexUvWhitePixel();
+            const float styleAlpha = ImGui::GetStyle().Alpha;
+            if (m_colorsChanged == true || styleAlpha != m_packedStyleAlpha)
+            {
+                PackColors(styleAlpha);
+                m_isDirty = true;
+            }
+            if (antiAliased != m_cacheIsAntiAliased || uv.x != m_cacheUv.x || uv.y != m_cacheUv.y)
+            {
+                m_isDirty = true;
+            }
+            if (m_isDirty == true)
+            {
+                BuildVertexCache(antiAliased, uv);
+            }
+
+            WriteVertexCache(drawList);
         }
 
         // Draw boundaries for virtual and actual sizes.
-        ImGui::GetWindowDrawList()->AddRect(m_pos, ImVec2(m_pos.x + m_size.x, m_pos.y + m_size.y), 0xFFFF0000);
-        ImGui::GetWindowDrawList()->AddRect(drawPos, ImVec2(drawPos.x + m_size.x, drawPos.y + m_size.y), 0xFF00FF00);
+        drawList->AddRect(m_pos, ImVec2(m_pos.x + m_size.x, m_pos.y + m_size.y), 0xFFFF0000);
+        drawList->AddRect(drawPos, ImVec2(drawPos.x + m_size.x, drawPos.y + m_size.y), 0xFF00FF00);
+    }
+
+    /**
+     * @brief   Draw the mesh once per instance in the current window.
+     *          Every instance uses the geometry and anchor of this mesh with its own
+     *          position, size, rotation and tint. The mesh's own position, size and rotation
+     *          are not used, nor are its tint and heat colors. Nothing is cached, the instances
+     *          can change every frame. Each instance picks its own level of detail from its size.
+     * @param   instances: The instances to draw.
+     * @param   count: The number of instances.
+     */
+    inline void DrawInstances(const MeshInstance* instances, size_t count)
+    {
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        const bool antiAliased = (drawList->Flags & ImDrawListFlags_AntiAliasedFill) != 0;
+        const ImVec2 uv = ImGui::GetFontTexUvWhitePixel();
+        const Aabb clip = GetClipBounds(drawList);
+        const float styleAlpha = ImGui::GetStyle().Alpha;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const MeshInstance& instance = instances[i];
+            if ((instance.tint & IM_COL32_A_MASK) == 0)
+            {
+                continue;
+            }
+
+            const size_t lod = SelectLod(instance.size);
+            const MeshGeometry& geometry = m_geometry->Lod(lod);
+            Transform transform = Transform::FromMesh(instance.pos, instance.size, m_anchor, instance.rotation);
+            if (FindVisibleClusters(geometry, transform, clip, m_drawClusters) == false)
+            {
+                continue;
+            }
+
+            const Array<ImVec2>& vertices = geometry.Vertices();
+            const Array<BvhNode>& nodes = geometry.Clusters().Nodes();
+            const bool indexed = !antiAliased && CanIndex(drawList, vertices.size());
+
+            m_instancePoints.resize(vertices.size());
+            m_instanceColors.resize(vertices.size());
+            // The style's alpha is folded in the tint so that the colors are packed in a single pass.
+            ColorTransform::Tint(geometry.Colors().data(), m_instanceColors.data(), vertices.size(),
+                                 Color::Fade(instance.tint, styleAlpha));
+            VertexTransform::Apply(transform, vertices.data(), m_instancePoints.data(), vertices.size());
+
+            m_instanceIndices.clear();
+            for (unsigned int cluster : m_drawClusters)
+            {
+                const BvhNode& node = nodes[cluster];
+                FindVisibleTriangles(geometry, m_instanceColors, node.first, node.first + node.count, m_instanceIndices);
+            }
+            if (m_instanceIndices.empty() == true)
+            {
+                continue;
+            }
+
+            if (indexed)
+            {
+                drawList->PrimReserve(int(m_instanceIndices.size()), int(vertices.size()));
+                ImDrawVert* vtx = drawList->_VtxWritePtr;
+                for (size_t v = 0; v < vertices.size(); v++)
+                {
+                    vtx[v].pos = m_instancePoints[v];
+                    vtx[v].uv = uv;
+                    vtx[v].col = m_instanceColors[v];
+                }
+                drawList->_VtxWritePtr += vertices.size();
+                WriteIndices(drawList, m_instanceIndices.data(), m_instanceIndices.size());
+                drawList->_VtxCurrentIdx += (unsigned int)vertices.size();
+                continue;
+            }
+
+            size_t triangle = 0;
+            size_t remaining = m_instanceIndices.size() / 3;
+            while (remaining > 0)
+            {
+                size_t reserved = ReserveTriangles(drawList, remaining, antiAliased);
+                ImDrawVert* vtx = drawList->_VtxWritePtr;
+                for (size_t t = 0; t < reserved; t++, triangle++)
+                {
+                    BuildTriangle(&m_instanceIndices[triangle * 3], m_instancePoints.data(),
+                                  m_instanceColors.data(), antiAliased, uv, vtx);
+                }
+                drawList->_VtxWritePtr = vtx;
+                remaining -= reserved;
+            }
+        }
+    }
+    inline void DrawInstances(const std::vector<MeshInstance>& instances)
+    {
+        DrawInstances(instances.data(), instances.size());
     }
 
     inline void Size(const ImVec2& size)
     {
         m_size = size;
+        UpdateTransform();
     }
     inline const ImVec2& Size() const
     {
@@ -165,6 +328,7 @@ public:
     inline void Pos(const ImVec2& pos)
     {
         m_pos = pos;
+        UpdateTransform();
     }
     inline const ImVec2& Pos() const
     {
@@ -174,6 +338,7 @@ public:
     inline void Anchor(const ImVec2& anchor)
     {
         m_anchor = anchor;
+        UpdateTransform();
     }
     inline const ImVec2& Anchor() const
     {
@@ -183,21 +348,621 @@ public:
     inline void Rotation(float rot)
     {
         m_rotation = rot;
-        for (auto& tri : m_triangles)
-        {
-            tri.Rotate(rot);
-        }
+        UpdateTransform();
     }
     inline float Rotation() const
     {
         return m_rotation;
     }
 
+    /**
+     * @brief   Set how far, in pixels, the outline of the drawn level of detail may be from the full geometry's.
+     */
+    inline void LodPixelError(float error)
+    {
+        m_lodPixelError = error;
+        UpdateTransform();
+    }
+    inline float LodPixelError() const
+    {
+        return m_lodPixelError;
+    }
+
+    /**
+     * @brief   Multiply the color of every triangle drawn by Draw with a tint.
+     */
+    inline void Tint(ImU32 tint)
+    {
+        if (tint != m_tint)
+        {
+            m_tint = tint;
+            m_colorsChanged = true;
+        }
+    }
+    inline ImU32 Tint() const
+    {
+        return m_tint;
+    }
+
+    /**
+     * @brief   Set the alpha of the tint, fading the whole mesh in or out.
+     * @param   alpha: The opacity, in the [0..1] range.
+     */
+    inline void Fade(float alpha)
+    {
+        Tint((m_tint & ~IM_COL32_A_MASK) | (Color::Fade(IM_COL32_WHITE, alpha) & IM_COL32_A_MASK));
+    }
+
+    /**
+     * @brief   Color the vertices from a heat colormap instead of the geometry's colors, see ColorTransform::Heat.
+     *          The values can change every frame, the colormap is applied in a single pass.
+     *          Since simplified levels don't share the full geometry's vertices, the full geometry is
+     *          drawn until ResetColors is called.
+     * @param   values: One value per vertex of the full geometry (see MeshGeometry::Vertices).
+     * @param   count: The number of values, must be the geometry's vertex count.
+     * @param   min: The value mapped to the coldest color.
+     * @param   max: The value mapped to the hottest color.
+     */
+    inline void HeatColors(const float* values, size_t count, float min, float max)
+    {
+        if (count != m_geometry->VertexCount())
+        {
+            Logging::System.Error("Heat values don't match the mesh's vertex count: ", count);
+            return;
+        }
+        m_heatColors.resize(count);
+        ColorTransform::Heat(values, m_heatColors.data(), count, min, max);
+        m_colorsChanged = true;
+        UpdateTransform();
+    }
+    inline void HeatColors(const std::vector<float>& values, float min, float max)
+    {
+        HeatColors(values.data(), values.size(), min, max);
+    }
+
+    /**
+     * @brief   Go back to the geometry's colors after HeatColors. The tint is kept.
+     */
+    inline void ResetColors()
+    {
+        if (m_heatColors.empty() == false)
+        {
+            m_heatColors.clear();
+            m_colorsChanged = true;
+            UpdateTransform();
+        }
+    }
+
+    /**
+     * @brief   Get the level of detail drawn by Draw, 0 being the full geometry.
+     */
+    inline size_t Lod() const
+    {
+        return m_lod;
+    }
+
+    inline const Transform& GetTransform() const
+    {
+        return m_transform;
+    }
+
+    inline const std::shared_ptr<const MeshGeometry>& Geometry() const
+    {
+        return m_geometry;
+    }
+
+    inline size_t TriangleCount() const
+    {
+        return m_geometry->TriangleCount();
+    }
+
+    /**
+     * @brief   Pick the coarsest level of detail whose outline error is within the allowed pixel error at that size.
+     */
+    inline size_t SelectLod(const ImVec2& size) const
+    {
+        const float scale = fabsf(size.x) > fabsf(size.y) ? fabsf(size.x) : fabsf(size.y);
+        for (size_t level = m_geometry->LodCount() - 1; level > 0; level--)
+        {
+            if (m_geometry->LodError(level) * scale <= m_lodPixelError)
+            {
+                return level;
+            }
+        }
+        return 0;
+    }
+
 private:
-    std::vector<Triangle> m_triangles = std::vector<Triangle>();
+    std::shared_ptr<const MeshGeometry> m_geometry = std::make_shared<const MeshGeometry>();
+    std::vector<ImU32> m_packedColors = std::vector<ImU32>(); //!< Vertex colors of the drawn level, tinted and with the style's alpha.
+    std::vector<ImU32> m_heatColors = std::vector<ImU32>();   //!< Colors of the full geometry set by HeatColors, empty to use the geometry's.
+    ImU32 m_tint = IM_COL32_WHITE;          //!< Multiplied with the color of every triangle.
+    float m_packedStyleAlpha = 1.0f;        //!< Style alpha applied to m_packedColors.
+    bool m_colorsChanged = true;            //!< Set when m_packedColors must be packed again.
     ImVec2 m_size = ImVec2();   //!< Size in pixels.
     ImVec2 m_pos = ImVec2();    //!< Screen position of the mesh.
     ImVec2 m_anchor = ImVec2(); //!< Where in mesh coordinates is m_pos. [0..1] range.
     float m_rotation = 0;
+    float m_lodPixelError = DEFAULT_LOD_PIXEL_ERROR;   //!< Allowed outline error of the drawn level, in pixels.
+    size_t m_lod = 0;                                   //!< Level of detail drawn by Draw.
+
+    Transform m_transform = Transform();    //!< Mesh to screen transform, rebuilt by the setters.
+    bool m_isDirty = true;                  //!< Set when the vertex cache doesn't match the mesh anymore.
+    std::vector<ImVec2> m_screenPoints = std::vector<ImVec2>();        //!< Unique vertices in screen coordinates.
+    std::vector<ImDrawVert> m_vertexCache = std::vector<ImDrawVert>(); //!< Vertices ready to be copied in the draw list.
+    std::vector<unsigned int> m_visibleIndices = std::vector<unsigned int>(); //!< Indices of the triangles that are not transparent.
+    std::vector<unsigned int> m_visibleBefore = std::vector<unsigned int>();  //!< For every triangle, the number of visible triangles before it.
+    std::vector<unsigned char> m_clusterIsBuilt = std::vector<unsigned char>(); //!< For every cluster node, whether its vertices are in m_vertexCache.
+    std::vector<unsigned int> m_drawClusters = std::vector<unsigned int>();   //!< Scratch, clusters overlapping the clip rect.
+    std::vector<std::pair<unsigned int, unsigned int>> m_drawRanges = std::vector<std::pair<unsigned int, unsigned int>>(); //!< Scratch, ranges of visible triangles to draw.
+    bool m_cacheIsAntiAliased = false;      //!< Whether m_vertexCache has the anti-aliased fringe.
+    bool m_cacheIsIndexed = false;          //!< Whether m_vertexCache holds the unique vertices or 3 or 6 vertices per triangle.
+    ImVec2 m_cacheUv = ImVec2();            //!< White pixel UV used in m_vertexCache.
+
+    std::vector<ImVec2> m_instancePoints = std::vector<ImVec2>();  //!< Scratch, vertices of the instance being drawn.
+    std::vector<ImU32> m_instanceColors = std::vector<ImU32>();    //!< Scratch, tinted colors of the instance being drawn.
+    std::vector<unsigned int> m_instanceIndices = std::vector<unsigned int>(); //!< Scratch, visible triangles of the instance.
+
+    // Index pattern of one triangle, relative to its first vertex. Same order as ImDrawList::AddConvexPolyFilled.
+    static constexpr ImDrawIdx s_indicesAA[21] = { 0, 2, 4,
+                                                   0, 4, 5, 5, 1, 0,
+                                                   2, 0, 1, 1, 3, 2,
+                                                   4, 2, 3, 3, 5, 4 };
+    static constexpr ImDrawIdx s_indices[3] = { 0, 1, 2 };
+
+    inline void UpdateTransform()
+    {
+        Transform transform = Transform::FromMesh(m_pos, m_size, m_anchor, m_rotation);
+        if (transform != m_transform)
+        {
+            m_transform = transform;
+            m_isDirty = true;
+        }
+
+        // Heat colors are only known for the full geometry's vertices.
+        size_t lod = m_heatColors.empty() == true ? SelectLod(m_size) : 0;
+        if (lod != m_lod)
+        {
+            m_lod = lod;
+            m_colorsChanged = true;
+            m_isDirty = true;
+        }
+    }
+
+    /**
+     * @brief   Get the level of detail drawn by Draw.
+     */
+    inline const MeshGeometry& DrawGeometry() const
+    {
+        return m_geometry->Lod(m_lod);
+    }
+
+    /**
+     * @brief   Reserve every cache for the full geometry, the largest level, so that changing levels doesn't allocate.
+     */
+    inline void ReserveCaches()
+    {
+        const size_t vertexCount = m_geometry->VertexCount();
+        const size_t triangleCount = m_geometry->TriangleCount();
+        const size_t clusterCount = m_geometry->Clusters().Nodes().size();
+        m_packedColors.reserve(vertexCount);
+        m_screenPoints.reserve(vertexCount);
+        m_vertexCache.reserve(vertexCount > triangleCount * 6 ? vertexCount : triangleCount * 6);
+        m_visibleIndices.reserve(triangleCount * 3);
+        m_visibleBefore.reserve(triangleCount + 1);
+        m_clusterIsBuilt.reserve(clusterCount);
+        m_drawClusters.reserve(clusterCount);
+        m_drawRanges.reserve(clusterCount);
+        m_instancePoints.reserve(vertexCount);
+        m_instanceColors.reserve(vertexCount);
+        m_instanceIndices.reserve(triangleCount * 3);
+    }
+
+    /**
+     * @brief   Whether vertexCount unique vertices can be referenced by 16-bit indices at all.
+     */
+    static inline bool CanIndex(size_t vertexCount)
+    {
+        return sizeof(ImDrawIdx) > 2 || vertexCount < (1 << 16);
+    }
+
+    /**
+     * @brief   Whether vertexCount unique vertices written next in the draw list can be referenced by its indices.
+     *          Without ImDrawListFlags_AllowVtxOffset, ImGui never starts a new vertex block, so the vertices
+     *          must fit after the ones already in the current block.
+     */
+    static inline bool CanIndex(const ImDrawList* drawList, size_t vertexCount)
+    {
+        if (sizeof(ImDrawIdx) > 2)
+        {
+            return true;
+        }
+        return CanIndex(vertexCount) && ((drawList->Flags & ImDrawListFlags_AllowVtxOffset) != 0 ||
+                                         drawList->_VtxCurrentIdx + vertexCount < (1 << 16));
+    }
+
+    /**
+     * @brief   Pack the vertex colors of the drawn level with the tint and the style's alpha, in a single pass.
+     */
+    inline void PackColors(float styleAlpha)
+    {
+        const MeshGeometry& geometry = DrawGeometry();
+        const ImU32* colors = m_heatColors.empty() == true ? geometry.Colors().data() : m_heatColors.data();
+        m_packedColors.resize(geometry.VertexCount());
+        ColorTransform::Tint(colors, m_packedColors.data(), m_packedColors.size(), Color::Fade(m_tint, styleAlpha));
+        m_packedStyleAlpha = styleAlpha;
+        m_colorsChanged = false;
+    }
+
+    /**
+     * @brief   Get the draw list's clip rect, grown to include the anti-aliased fringe of the triangles along its edges.
+     */
+    static inline Aabb GetClipBounds(ImDrawList* drawList)
+    {
+        const ImVec2 clipMin = drawList->GetClipRectMin();
+        const ImVec2 clipMax = drawList->GetClipRectMax();
+        return Aabb(ImVec2(clipMin.x - 1.0f, clipMin.y - 1.0f), ImVec2(clipMax.x + 1.0f, clipMax.y + 1.0f));
+    }
+
+    /**
+     * @brief   List the clusters of the geometry that overlap the clip rect once transformed.
+     *          Only the bounds are transformed, not the vertices.
+     * @param   geometry: The level of detail to draw.
+     * @param   transform: Mesh to screen transform.
+     * @param   clip: The clip rect, in screen coordinates.
+     * @param   out: Node index of every cluster to draw, sorted by first triangle.
+     * @retval  False if no cluster overlaps the clip rect.
+     */
+    static inline bool FindVisibleClusters(const MeshGeometry& geometry, const Transform& transform, const Aabb& clip,
+                                           std::vector<unsigned int>& out)
+    {
+        out.clear();
+        const Bvh& clusters = geometry.Clusters();
+        const Aabb bounds = clusters.Bounds().Transformed(transform);
+        if (bounds.Overlaps(clip) == false)
+        {
+            return false;
+        }
+
+        // When the whole mesh is inside, every cluster is drawn without testing it.
+        const bool inside = bounds.min.x >= clip.min.x && bounds.min.y >= clip.min.y &&
+            bounds.max.x <= clip.max.x && bounds.max.y <= clip.max.y;
+        const BvhNode* nodes = clusters.Nodes().data();
+        clusters.Traverse([&](const Aabb& nodeBounds)
+                          {
+                              return inside || nodeBounds.Transformed(transform).Overlaps(clip);
+                          },
+                          [&](const BvhNode& node)
+                          {
+                              out.push_back((unsigned int)(&node - nodes));
+                          });
+
+        // Draw the clusters in the order of their triangles.
+        std::sort(out.begin(), out.end(), [nodes](unsigned int a, unsigned int b)
+                  {
+                      return nodes[a].first < nodes[b].first;
+                  });
+        return out.empty() == false;
+    }
+
+    /**
+     * @brief   List the indices of the triangles that are not fully transparent.
+     *          Transparent triangles are skipped, like AddTriangleFilled does.
+     * @param   geometry: The level of detail to draw.
+     * @param   colors: The packed color of every vertex.
+     * @param   first: The first triangle to look at.
+     * @param   end: The triangle after the last one to look at.
+     * @param   out: Where the indices of the visible triangles are appended, 3 per triangle.
+     */
+    static inline void FindVisibleTriangles(const MeshGeometry& geometry, const std::vector<ImU32>& colors,
+                                            size_t first, size_t end, std::vector<unsigned int>& out)
+    {
+        const Array<unsigned int>& indices = geometry.Indices();
+        for (size_t i = first * 3; i < end * 3; i += 3)
+        {
+            // All three vertices of a triangle have the same color.
+            if ((colors[indices[i]] & IM_COL32_A_MASK) != 0)
+            {
+                out.insert(out.end(), &indices[i], &indices[i] + 3);
+            }
+        }
+    }
+
+    /**
+     * @brief   Transform the mesh to screen coordinates and find its visible triangles.
+     *          Without indexing, the vertices of a cluster are only built the first time it is drawn, see BuildCluster.
+     */
+    inline void BuildVertexCache(bool antiAliased, const ImVec2& uv)
+    {
+        const MeshGeometry& geometry = DrawGeometry();
+        const Array<ImVec2>& vertices = geometry.Vertices();
+        const Array<unsigned int>& indices = geometry.Indices();
+        m_screenPoints.resize(vertices.size());
+        VertexTransform::Apply(m_transform, vertices.data(), m_screenPoints.data(), vertices.size());
+
+        const size_t triangleCount = geometry.TriangleCount();
+        m_visibleIndices.clear();
+        m_visibleBefore.resize(triangleCount + 1);
+        for (size_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            m_visibleBefore[triangle] = (unsigned int)(m_visibleIndices.size() / 3);
+            // All three vertices of a triangle have the same color.
+            if ((m_packedColors[indices[triangle * 3]] & IM_COL32_A_MASK) != 0)
+            {
+                m_visibleIndices.insert(m_visibleIndices.end(), &indices[triangle * 3], &indices[triangle * 3] + 3);
+            }
+        }
+        m_visibleBefore[triangleCount] = (unsigned int)(m_visibleIndices.size() / 3);
+
+        m_cacheIsIndexed = !antiAliased && CanIndex(vertices.size());
+        if (m_cacheIsIndexed)
+        {
+            m_vertexCache.resize(vertices.size());
+            for (size_t v = 0; v < vertices.size(); v++)
+            {
+                m_vertexCache[v].pos = m_screenPoints[v];
+                m_vertexCache[v].uv = uv;
+                m_vertexCache[v].col = m_packedColors[v];
+            }
+        }
+        else
+        {
+            m_vertexCache.resize(m_visibleBefore[triangleCount] * (antiAliased ? 6 : 3));
+            m_clusterIsBuilt.assign(geometry.Clusters().Nodes().size(), 0);
+        }
+
+        m_cacheIsAntiAliased = antiAliased;
+        m_cacheUv = uv;
+        m_isDirty = false;
+    }
+
+    /**
+     * @brief   Build the vertices of the visible triangles of a cluster in the vertex cache.
+     */
+    inline void BuildCluster(unsigned int cluster)
+    {
+        const BvhNode& node = DrawGeometry().Clusters().Nodes()[cluster];
+        const size_t first = m_visibleBefore[node.first];
+        const size_t end = m_visibleBefore[node.first + node.count];
+        ImDrawVert* vtx = &m_vertexCache[0] + first * (m_cacheIsAntiAliased ? 6 : 3);
+        for (size_t triangle = first; triangle < end; triangle++)
+        {
+            BuildTriangle(&m_visibleIndices[triangle * 3], m_screenPoints.data(),
+                          m_packedColors.data(), m_cacheIsAntiAliased, m_cacheUv, vtx);
+        }
+        m_clusterIsBuilt[cluster] = 1;
+    }
+
+    /**
+     * @brief   Copy the cached vertices of the clusters in m_drawClusters into the draw list.
+     */
+    inline void WriteVertexCache(ImDrawList* drawList)
+    {
+        if (m_visibleIndices.empty() == true)
+        {
+            return;
+        }
+
+        // Merge the clusters into ranges of visible triangles.
+        const Array<BvhNode>& nodes = DrawGeometry().Clusters().Nodes();
+        m_drawRanges.clear();
+        size_t indexCount = 0;
+        for (unsigned int cluster : m_drawClusters)
+        {
+            const BvhNode& node = nodes[cluster];
+            const unsigned int first = m_visibleBefore[node.first];
+            const unsigned int end = m_visibleBefore[node.first + node.count];
+            if (first == end)
+            {
+                continue;
+            }
+            if (m_cacheIsIndexed == false && m_clusterIsBuilt[cluster] == 0)
+            {
+                BuildCluster(cluster);
+            }
+            if (m_drawRanges.empty() == false && m_drawRanges.back().second == first)
+            {
+                m_drawRanges.back().second = end;
+            }
+            else
+            {
+                m_drawRanges.emplace_back(first, end);
+            }
+            indexCount += (end - first) * 3;
+        }
+        if (indexCount == 0)
+        {
+            return;
+        }
+
+        if (m_cacheIsIndexed && CanIndex(drawList, m_vertexCache.size()))
+        {
+            drawList->PrimReserve(int(indexCount), int(m_vertexCache.size()));
+            memcpy(drawList->_VtxWritePtr, m_vertexCache.data(), m_vertexCache.size() * sizeof(ImDrawVert));
+            drawList->_VtxWritePtr += m_vertexCache.size();
+            for (const auto& range : m_drawRanges)
+            {
+                WriteIndices(drawList, &m_visibleIndices[range.first * 3], (range.second - range.first) * 3);
+            }
+            drawList->_VtxCurrentIdx += (unsigned int)m_vertexCache.size();
+            return;
+        }
+
+        if (m_cacheIsIndexed)
+        {
+            // The draw list's current vertex block is too full for the unique vertices:
+            // write the triangles one by one from them, like the non-indexed cache.
+            for (const auto& range : m_drawRanges)
+            {
+                size_t triangle = range.first;
+                while (triangle < range.second)
+                {
+                    size_t count = ReserveTriangles(drawList, range.second - triangle, false);
+                    ImDrawVert* vtx = drawList->_VtxWritePtr;
+                    const unsigned int* indices = &m_visibleIndices[triangle * 3];
+                    for (size_t i = 0; i < count * 3; i++)
+                    {
+                        vtx[i] = m_vertexCache[indices[i]];
+                    }
+                    drawList->_VtxWritePtr += count * 3;
+                    triangle += count;
+                }
+            }
+            return;
+        }
+
+        const size_t vtxPerTriangle = m_cacheIsAntiAliased ? 6 : 3;
+        for (const auto& range : m_drawRanges)
+        {
+            size_t triangle = range.first;
+            while (triangle < range.second)
+            {
+                size_t count = ReserveTriangles(drawList, range.second - triangle, m_cacheIsAntiAliased);
+                memcpy(drawList->_VtxWritePtr, &m_vertexCache[triangle * vtxPerTriangle],
+                       count * vtxPerTriangle * sizeof(ImDrawVert));
+                drawList->_VtxWritePtr += count * vtxPerTriangle;
+                triangle += count;
+            }
+        }
+    }
+
+    /**
+     * @brief   Write the indices of vertices that were just written to the draw list.
+     *          The caller advances drawList->_VtxCurrentIdx once all the indices referring to those vertices are written.
+     * @param   drawList: The draw list to write to. PrimReserve must already have been called.
+     * @param   indices: Indices relative to the first written vertex.
+     * @param   count: The number of indices.
+     */
+    static inline void WriteIndices(ImDrawList* drawList, const unsigned int* indices, size_t count)
+    {
+        ImDrawIdx* idx = drawList->_IdxWritePtr;
+        const unsigned int base = drawList->_VtxCurrentIdx;
+        for (size_t i = 0; i < count; i++)
+        {
+            idx[i] = (ImDrawIdx)(base + indices[i]);
+        }
+        drawList->_IdxWritePtr += count;
+    }
+
+    /**
+     * @brief   Reserve room for up to count triangles in the draw list and write their indices.
+     *          With 16-bit indices, only the current vertex block is filled, up to where AddTriangleFilled
+     *          would have stopped, so that ImGui starts new blocks at the exact same triangles.
+     *          The caller must write the vertices of the reserved triangles at drawList->_VtxWritePtr.
+     * @param   drawList: The draw list to write to.
+     * @param   count: The number of triangles left to write.
+     * @param   antiAliased: Whether the triangles have an anti-aliased fringe.
+     * @retval  The number of triangles reserved, between 1 and count.
+     */
+    static inline size_t ReserveTriangles(ImDrawList* drawList, size_t count, bool antiAliased)
+    {
+        const unsigned int vtxPerTriangle = antiAliased ? 6 : 3;
+        const unsigned int idxPerTriangle = antiAliased ? 21 : 3;
+        const ImDrawIdx* pattern = antiAliased ? s_indicesAA : s_indices;
+
+        if (sizeof(ImDrawIdx) == 2)
+        {
+            const unsigned int maxIdx = (1 << 16) - 1;
+            unsigned int room = drawList->_VtxCurrentIdx < maxIdx ?
+                (maxIdx - drawList->_VtxCurrentIdx) / vtxPerTriangle : 0;
+            if (room == 0)
+            {
+                room = maxIdx / vtxPerTriangle;
+            }
+            count = room < count ? room : count;
+        }
+
+        drawList->PrimReserve(int(count * idxPerTriangle), int(count * vtxPerTriangle));
+        ImDrawIdx* idx = drawList->_IdxWritePtr;
+        unsigned int vtxIdx = drawList->_VtxCurrentIdx;
+        for (size_t i = 0; i < count; i++)
+        {
+            for (unsigned int j = 0; j < idxPerTriangle; j++)
+            {
+                idx[j] = (ImDrawIdx)(vtxIdx + pattern[j]);
+            }
+            idx += idxPerTriangle;
+            vtxIdx += vtxPerTriangle;
+        }
+        drawList->_IdxWritePtr = idx;
+        drawList->_VtxCurrentIdx = vtxIdx;
+
+        return count;
+    }
+
+    /**
+     * @brief   Build the 3 (or 6 with anti-aliasing) vertices of one triangle from the transformed unique vertices.
+     * @param   indices: The 3 indices of the triangle.
+     * @param   points: The unique vertices, in screen coordinates.
+     * @param   colors: The packed color of every unique vertex.
+     */
+    static inline void BuildTriangle(const unsigned int* indices, const ImVec2* points, const ImU32* colors,
+                                     bool antiAliased, const ImVec2& uv, ImDrawVert*& vtx)
+    {
+        const ImVec2 triangle[3] = { points[indices[0]], points[indices[1]], points[indices[2]] };
+        const ImU32 col = colors[indices[0]];
+        if (antiAliased)
+        {
+            BuildTriangleAA(triangle, col, uv, vtx);
+        }
+        else
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                vtx[i].pos = triangle[i];
+                vtx[i].uv = uv;
+                vtx[i].col = col;
+            }
+            vtx += 3;
+        }
+    }
+
+    /**
+     * @brief   Build the vertices of a triangle and its anti-aliased fringe, the same way ImDrawList::AddConvexPolyFilled does.
+     *          The operations are kept in the same order as ImGui's so the output is bit-identical.
+     */
+    static inline void BuildTriangleAA(const ImVec2* points, ImU32 col, const ImVec2& uv, ImDrawVert*& vtx)
+    {
+        const float AA_SIZE = 1.0f;
+        const ImU32 colTrans = col & ~IM_COL32_A_MASK;
+
+        // Edge normals.
+        ImVec2 normals[3];
+        for (int i0 = 2, i1 = 0; i1 < 3; i0 = i1++)
+        {
+            float dx = points[i1].x - points[i0].x;
+            float dy = points[i1].y - points[i0].y;
+            float d2 = dx * dx + dy * dy;
+            if (d2 > 0.0f)
+            {
+                float invLen = 1.0f / sqrtf(d2);
+                dx *= invLen;
+                dy *= invLen;
+            }
+            normals[i0].x = dy;
+            normals[i0].y = -dx;
+        }
+
+        for (int i0 = 2, i1 = 0; i1 < 3; i0 = i1++)
+        {
+            // Average normals.
+            float dmX = (normals[i0].x + normals[i1].x) * 0.5f;
+            float dmY = (normals[i0].y + normals[i1].y) * 0.5f;
+            float d2 = dmX * dmX + dmY * dmY;
+            if (d2 < 0.5f)
+            {
+                d2 = 0.5f;
+            }
+            float invLenSq = 1.0f / d2;
+            dmX *= invLenSq;
+            dmY *= invLenSq;
+            dmX *= AA_SIZE * 0.5f;
+            dmY *= AA_SIZE * 0.5f;
+
+            vtx[0].pos.x = (points[i1].x - dmX); vtx[0].pos.y = (points[i1].y - dmY); vtx[0].uv = uv; vtx[0].col = col;      // Inner
+            vtx[1].pos.x = (points[i1].x + dmX); vtx[1].pos.y = (points[i1].y + dmY); vtx[1].uv = uv; vtx[1].col = colTrans; // Outer
+            vtx += 2;
+        }
+    }
 };
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "Object.h"
+
+namespace Renderer
+{
+void Object::Render()
+{
+    if (m_isVisible == false)
+    {
+        return;
+    }
+    m_mesh.Pos(m_position);
+    m_mesh.Draw();
+}
+
+bool Object::IsColliding(const Object& other) const
+{
+    if (m_isCollidable == false || other.m_isCollidable == false)
+    {
+        return false;
+    }
+    return GetBounds().Overlaps(other.GetBounds());
+}
+
+Aabb Object::GetBounds() const
+{
+    return m_collisionMesh.Geometry()->Bounds().Transformed(GetCollisionTransform());
+}
+
+Transform Object::GetCollisionTransform() const
+{
+    // The collision mesh's own position isn't kept up to date, place it at the object's.
+    return Transform::FromMesh(m_position, m_collisionMesh.Size(), m_collisionMesh.Anchor(), m_collisionMesh.Rotation());
+}
+
+void Object::Step(float dt, const ImVec2& gravity)
+{
+    if (m_isMoveable == false)
+    {
+        return;
+    }
+    if (m_isAffectedByPhysics == true)
+    {
+        m_velocity.x += gravity.x * dt;
+        m_velocity.y += gravity.y * dt;
+    }
+    m_position.x += m_velocity.x * dt;
+    m_position.y += m_velocity.y * dt;
+}
+}
@@ -4,6 +4,14 @@
 
 namespace Renderer
 {
+/**
+ * @class   Object
+ * @brief   Something in the simulated world: a visible mesh, a collision mesh and its motion.
+ *          The meshes are placed at the object's position (their anchor lands on it).
+ *          A world doesn't keep objects: adding one to Simulation::World makes it an entity, whose
+ *          components are stored column by column in the world's Simulation::EntityStore.
+ *          Objects remain to describe entities, and for the code that handles a single thing at a time.
+ */
 class Object
 {
 public:
@@ -17,10 +25,91 @@ public:
         m_position(position), m_isMoveable(isMoveable),
         m_velocity(velocity), m_isAffectedByPhysics(isAffectedByPhysics)
     {
+        m_mesh.Pos(m_position);
+        m_collisionMesh.Pos(m_position);
     }
 
-    virtual void Render();
-    virtual bool IsColliding(const Object& other);
+    /**
+     * @brief   Draw the object's mesh at its position in the current window, if it is visible.
+     */
+    void Render();
+    /**
+     * @brief   Check if the bounds of the collision meshes of two collidable objects overlap.
+     */
+    bool IsColliding(const Object& other) const;
+
+    /**
+     * @brief   Get the bounds of the collision mesh at the object's position, in world coordinates.
+     */
+    Aabb GetBounds() const;
+    /**
+     * @brief   Get the transform of the collision mesh at the object's position, from mesh to world coordinates.
+     */
+    Transform GetCollisionTransform() const;
+
+    /**
+     * @brief   Advance the object's motion by one time step (semi-implicit Euler).
+     *          Only objects affected by physics are accelerated, and only moveable objects move.
+     * @param   dt: The time step, in seconds.
+     * @param   gravity: The acceleration of gravity, in world units per second squared.
+     */
+    void Step(float dt, const ImVec2& gravity);
+
+#pragma region Accessors
+    inline const ImVec2& Position() const
+    {
+        return m_position;
+    }
+    inline void Position(const ImVec2& position)
+    {
+        m_position = position;
+    }
+
+    inline const ImVec2& Velocity() const
+    {
+        return m_velocity;
+    }
+    inline void Velocity(const ImVec2& velocity)
+    {
+        m_velocity = velocity;
+    }
+
+    inline float Mass() const
+    {
+        return m_mass;
+    }
+    inline void Mass(float mass)
+    {
+        m_mass = mass;
+    }
+
+    inline bool IsVisible() const
+    {
+        return m_isVisible;
+    }
+    inline bool IsCollidable() const
+    {
+        return m_isCollidable;
+    }
+    inline bool IsMoveable() const
+    {
+        return m_isMoveable;
+    }
+    inline bool IsAffectedByPhysics() const
+    {
+        return m_isAffectedByPhysics;
+    }
+
+    inline const Mesh& GetMesh() const
+    {
+        return m_mesh;
+    }
+    inline const Mesh& GetCollisionMesh() const
+    {
+        return m_collisionMesh;
+    }
+#pragma endregion
+
 private:
     Mesh m_mesh = Mesh();
     bool m_isVisible = false;
@@ -33,5 +122,7 @@ private:
 
     ImVec2 m_velocity = ImVec2();
     bool m_isAffectedByPhysics = false;
+
+    float m_mass = 1.0f;
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,460 @@
+#include "SoftwareRasterizer.h"
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+namespace Renderer
+{
+/**
+ * @brief   x * y / 255, rounded, for x and y in [0, 255].
+ */
+static inline unsigned int MulDiv255(unsigned int x, unsigned int y)
+{
+    unsigned int t = x * y + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+/**
+ * @brief   Multiply two colors channel by channel.
+ */
+static inline ImU32 Modulate(ImU32 a, ImU32 b)
+{
+    ImU32 out = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        out |= MulDiv255((a >> shift) & 0xFF, (b >> shift) & 0xFF) << shift;
+    }
+    return out;
+}
+
+/**
+ * @brief   Divide the two 16-bit lanes of x by 255, rounded, each lane being at most 255 * 255.
+ */
+static inline ImU32 LanesDiv255(ImU32 x)
+{
+    x += 0x00800080;
+    return ((x + ((x >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+}
+
+/**
+ * @brief   Blend src over dst with src's alpha, on every channel like glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA).
+ *          R and B, then G and A, are blended together in two lanes of an integer.
+ */
+static inline ImU32 Blend(ImU32 src, ImU32 dst)
+{
+    ImU32 alpha = src >> IM_COL32_A_SHIFT;
+    if (alpha == 0xFF)
+    {
+        return src;
+    }
+    ImU32 inverse = 255 - alpha;
+    ImU32 rb = (src & 0x00FF00FF) * alpha + (dst & 0x00FF00FF) * inverse;
+    ImU32 ga = ((src >> 8) & 0x00FF00FF) * alpha + ((dst >> 8) & 0x00FF00FF) * inverse;
+    return LanesDiv255(rb) | (LanesDiv255(ga) << 8);
+}
+
+/**
+ * @brief   Blend the same color over a span of pixels.
+ */
+static inline void BlendSpan(ImU32* dst, int count, ImU32 src)
+{
+    ImU32 alpha = src >> IM_COL32_A_SHIFT;
+    if (alpha == 0xFF)
+    {
+        std::fill(dst, dst + count, src);
+        return;
+    }
+    ImU32 inverse = 255 - alpha;
+    ImU32 rb = (src & 0x00FF00FF) * alpha;
+    ImU32 ga = ((src >> 8) & 0x00FF00FF) * alpha;
+    for (int i = 0; i < count; i++)
+    {
+        ImU32 d = dst[i];
+        dst[i] = LanesDiv255(rb + (d & 0x00FF00FF) * inverse) | (LanesDiv255(ga + ((d >> 8) & 0x00FF00FF) * inverse) << 8);
+    }
+}
+
+SoftwareRasterizer::SoftwareRasterizer(unsigned int threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // The thread calling Render rasterizes too.
+    for (unsigned int i = 1; i < threadCount; i++)
+    {
+        m_workers.emplace_back(&SoftwareRasterizer::WorkerMain, this);
+    }
+}
+
+SoftwareRasterizer::~SoftwareRasterizer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+ImTextureID SoftwareRasterizer::AddTexture(const unsigned char* pixels, int width, int height)
+{
+    std::unique_ptr<Texture> texture = std::make_unique<Texture>();
+    texture->width = width;
+    texture->height = height;
+    texture->pixels.resize((size_t)width * height);
+    memcpy(texture->pixels.data(), pixels, texture->pixels.size() * sizeof(ImU32));
+
+    // The texture's address is unique and stable, it makes a good ID.
+    ImTextureID id = (ImTextureID)texture.get();
+    m_textures.push_back(std::move(texture));
+    return id;
+}
+
+void SoftwareRasterizer::AddFontAtlas(ImFontAtlas* atlas)
+{
+    unsigned char* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    atlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+    atlas->TexID = AddTexture(pixels, width, height);
+}
+
+const SoftwareRasterizer::Texture* SoftwareRasterizer::FindTexture(ImTextureID id) const
+{
+    for (const std::unique_ptr<Texture>& texture : m_textures)
+    {
+        if ((ImTextureID)texture.get() == id)
+        {
+            return texture.get();
+        }
+    }
+    return nullptr;
+}
+
+void SoftwareRasterizer::Render(const ImDrawData* drawData, ImU32 clearColor)
+{
+    m_width = std::max(0, (int)(drawData->DisplaySize.x * drawData->FramebufferScale.x));
+    m_height = std::max(0, (int)(drawData->DisplaySize.y * drawData->FramebufferScale.y));
+    m_pixels.resize((size_t)m_width * m_height);
+    m_clearColor = clearColor;
+
+    m_tilesX = (m_width + TILE_SIZE - 1) / TILE_SIZE;
+    m_tilesY = (m_height + TILE_SIZE - 1) / TILE_SIZE;
+    // Keep the bins' storage from frame to frame.
+    if (m_bins.size() < (size_t)m_tilesX * m_tilesY)
+    {
+        m_bins.resize((size_t)m_tilesX * m_tilesY);
+    }
+    for (std::vector<unsigned int>& bin : m_bins)
+    {
+        bin.clear();
+    }
+    m_setups.clear();
+
+    // Set up and bin every triangle, in draw order.
+    const ImVec2 offset = drawData->DisplayPos;
+    const ImVec2 scale = drawData->FramebufferScale;
+    for (int n = 0; n < drawData->CmdListsCount; n++)
+    {
+        const ImDrawList* cmdList = drawData->CmdLists[n];
+        for (const ImDrawCmd& cmd : cmdList->CmdBuffer)
+        {
+            if (cmd.UserCallback != nullptr)
+            {
+                // There is no render state to reset, other callbacks run before anything is rasterized.
+                if (cmd.UserCallback != ImDrawCallback_ResetRenderState)
+                {
+                    cmd.UserCallback(cmdList, &cmd);
+                }
+                continue;
+            }
+
+            ImVec4 clip = ImVec4((cmd.ClipRect.x - offset.x) * scale.x, (cmd.ClipRect.y - offset.y) * scale.y,
+                                 (cmd.ClipRect.z - offset.x) * scale.x, (cmd.ClipRect.w - offset.y) * scale.y);
+            if (clip.x >= m_width || clip.y >= m_height || clip.z <= 0.0f || clip.w <= 0.0f)
+            {
+                continue;
+            }
+
+            const Texture* texture = FindTexture(cmd.TextureId);
+            const ImDrawVert* vertices = cmdList->VtxBuffer.Data + cmd.VtxOffset;
+            const ImDrawIdx* indices = cmdList->IdxBuffer.Data + cmd.IdxOffset;
+            for (unsigned int i = 0; i + 2 < cmd.ElemCount; i += 3)
+            {
+                SetupTriangle(vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]],
+                              clip, texture, offset, scale);
+            }
+        }
+    }
+
+    // Hand the tiles over to the workers and rasterize along with them.
+    m_nextTile = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_frame++;
+        m_busyWorkers = (unsigned int)m_workers.size();
+    }
+    m_wake.notify_all();
+    RasterizeTiles();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]()
+                {
+                    return m_busyWorkers == 0;
+                });
+}
+
+void SoftwareRasterizer::SetupTriangle(const ImDrawVert& v0, const ImDrawVert& v1, const ImDrawVert& v2,
+                                       const ImVec4& clip, const Texture* texture, const ImVec2& offset,
+                                       const ImVec2& scale)
+{
+    const ImDrawVert* v[3] = { &v0, &v1, &v2 };
+    ImVec2 p[3];
+    int64_t sx[3];
+    int64_t sy[3];
+    for (int i = 0; i < 3; i++)
+    {
+        p[i] = ImVec2((v[i]->pos.x - offset.x) * scale.x, (v[i]->pos.y - offset.y) * scale.y);
+        if (std::abs(p[i].x) > MAX_COORDINATE || std::abs(p[i].y) > MAX_COORDINATE || p[i].x != p[i].x || p[i].y != p[i].y)
+        {
+            return;
+        }
+        sx[i] = (int64_t)std::lround(p[i].x * SUBPIXELS);
+        sy[i] = (int64_t)std::lround(p[i].y * SUBPIXELS);
+    }
+
+    // Coverage is computed exactly on the snapped positions, so that triangles sharing an edge never overlap nor leave gaps.
+    int64_t area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sy[1] - sy[0]) * (sx[2] - sx[0]);
+    if (area == 0)
+    {
+        return;
+    }
+
+    // Pixels whose center is inside both the triangle and the clip rect.
+    float minX = std::max({ (float)std::min({ sx[0], sx[1], sx[2] }) / SUBPIXELS, clip.x, 0.0f });
+    float minY = std::max({ (float)std::min({ sy[0], sy[1], sy[2] }) / SUBPIXELS, clip.y, 0.0f });
+    float maxX = std::min({ (float)std::max({ sx[0], sx[1], sx[2] }) / SUBPIXELS, clip.z, (float)m_width });
+    float maxY = std::min({ (float)std::max({ sy[0], sy[1], sy[2] }) / SUBPIXELS, clip.w, (float)m_height });
+    Setup setup;
+    setup.minX = (int)std::ceil(minX - 0.5f);
+    setup.minY = (int)std::ceil(minY - 0.5f);
+    setup.maxX = (int)std::ceil(maxX - 0.5f);
+    setup.maxY = (int)std::ceil(maxY - 0.5f);
+    if (setup.minX >= setup.maxX || setup.minY >= setup.maxY)
+    {
+        return;
+    }
+
+    // Edge i is opposite to vertex i, equal to the area at it and positive inside.
+    // Once divided by the area, the edges are the barycentric weights used to interpolate the attributes.
+    const int64_t sign = area > 0 ? 1 : -1;
+    const float invArea = 1.0f / ((float)area / (SUBPIXELS * SUBPIXELS));
+    Plane weights[3];
+    for (int i = 0; i < 3; i++)
+    {
+        int a = (i + 1) % 3;
+        int b = (i + 2) % 3;
+        Edge& edge = setup.edges[i];
+        edge.a = (sy[a] - sy[b]) * sign;
+        edge.b = (sx[b] - sx[a]) * sign;
+        edge.c = (sx[a] * sy[b] - sy[a] * sx[b]) * sign;
+        // Exactly one of two triangles sharing an edge owns the pixels on it: the one on its top-left side.
+        if ((edge.a > 0 || (edge.a == 0 && edge.b > 0)) == false)
+        {
+            edge.c -= 1;
+        }
+
+        weights[i].dx = (p[a].y - p[b].y) * invArea;
+        weights[i].dy = (p[b].x - p[a].x) * invArea;
+        weights[i].c = (p[a].x * p[b].y - p[a].y * p[b].x) * invArea;
+    }
+
+    auto makePlane = [&weights](float f0, float f1, float f2)
+    {
+        Plane plane;
+        plane.dx = f0 * weights[0].dx + f1 * weights[1].dx + f2 * weights[2].dx;
+        plane.dy = f0 * weights[0].dy + f1 * weights[1].dy + f2 * weights[2].dy;
+        plane.c = f0 * weights[0].c + f1 * weights[1].c + f2 * weights[2].c;
+        return plane;
+    };
+
+    setup.texture = texture;
+    setup.isColorFlat = v0.col == v1.col && v0.col == v2.col;
+    setup.isFlat = setup.isColorFlat == true &&
+                   ((v0.uv.x == v1.uv.x && v0.uv.x == v2.uv.x && v0.uv.y == v1.uv.y && v0.uv.y == v2.uv.y) ||
+                    texture == nullptr);
+    setup.flatColor = v0.col;
+    if (setup.isFlat == true)
+    {
+        // Solid shapes all sample the atlas' white pixel, they only need one sample.
+        if (texture != nullptr)
+        {
+            int x = std::min(std::max((int)(v0.uv.x * texture->width), 0), texture->width - 1);
+            int y = std::min(std::max((int)(v0.uv.y * texture->height), 0), texture->height - 1);
+            setup.flatColor = Modulate(texture->pixels[(size_t)y * texture->width + x], v0.col);
+        }
+        if ((setup.flatColor >> IM_COL32_A_SHIFT) == 0)
+        {
+            return;
+        }
+    }
+    else
+    {
+        setup.u = makePlane(v0.uv.x * (texture != nullptr ? texture->width : 0),
+                            v1.uv.x * (texture != nullptr ? texture->width : 0),
+                            v2.uv.x * (texture != nullptr ? texture->width : 0));
+        setup.v = makePlane(v0.uv.y * (texture != nullptr ? texture->height : 0),
+                            v1.uv.y * (texture != nullptr ? texture->height : 0),
+                            v2.uv.y * (texture != nullptr ? texture->height : 0));
+        for (int c = 0; c < 4; c++)
+        {
+            int shift = c * 8;
+            setup.color[c] = makePlane(float((v0.col >> shift) & 0xFF), float((v1.col >> shift) & 0xFF),
+                                       float((v2.col >> shift) & 0xFF));
+        }
+    }
+
+    unsigned int index = (unsigned int)m_setups.size();
+    m_setups.push_back(setup);
+    for (int ty = setup.minY / TILE_SIZE; ty <= (setup.maxY - 1) / TILE_SIZE; ty++)
+    {
+        for (int tx = setup.minX / TILE_SIZE; tx <= (setup.maxX - 1) / TILE_SIZE; tx++)
+        {
+            m_bins[(size_t)ty * m_tilesX + tx].push_back(index);
+        }
+    }
+}
+
+void SoftwareRasterizer::RasterizeTiles()
+{
+    const int tileCount = m_tilesX * m_tilesY;
+    for (int tile = m_nextTile++; tile < tileCount; tile = m_nextTile++)
+    {
+        RasterizeTile(tile);
+    }
+}
+
+void SoftwareRasterizer::RasterizeTile(int tile)
+{
+    const int minX = (tile % m_tilesX) * TILE_SIZE;
+    const int minY = (tile / m_tilesX) * TILE_SIZE;
+    const int maxX = std::min(minX + TILE_SIZE, m_width);
+    const int maxY = std::min(minY + TILE_SIZE, m_height);
+
+    for (int y = minY; y < maxY; y++)
+    {
+        std::fill(&m_pixels[(size_t)y * m_width + minX], &m_pixels[(size_t)y * m_width + maxX], m_clearColor);
+    }
+
+    for (unsigned int index : m_bins[tile])
+    {
+        const Setup& setup = m_setups[index];
+        RasterizeTriangle(setup, std::max(minX, setup.minX), std::max(minY, setup.minY),
+                          std::min(maxX, setup.maxX), std::min(maxY, setup.maxY));
+    }
+}
+
+/**
+ * @brief   floor(n / d), for d > 0.
+ */
+static inline int64_t FloorDiv(int64_t n, int64_t d)
+{
+    return n >= 0 ? n / d : -((-n + d - 1) / d);
+}
+
+void SoftwareRasterizer::RasterizeTriangle(const Setup& setup, int minX, int minY, int maxX, int maxY)
+{
+    for (int y = minY; y < maxY; y++)
+    {
+        // Find the span of pixels inside all three edges, from the edges' values at the first pixel of the row.
+        const int64_t centerX = (int64_t)minX * SUBPIXELS + SUBPIXELS / 2;
+        const int64_t centerY = (int64_t)y * SUBPIXELS + SUBPIXELS / 2;
+        int64_t first = 0;
+        int64_t last = maxX - minX - 1;
+        for (const Edge& edge : setup.edges)
+        {
+            const int64_t value = edge.a * centerX + edge.b * centerY + edge.c;
+            const int64_t step = edge.a * SUBPIXELS;
+            if (step > 0)
+            {
+                first = std::max(first, -FloorDiv(value, step));
+            }
+            else if (step < 0)
+            {
+                last = std::min(last, FloorDiv(value, -step));
+            }
+            else if (value < 0)
+            {
+                last = -1;
+            }
+        }
+
+        ImU32* row = &m_pixels[(size_t)y * m_width];
+        const float py = y + 0.5f;
+        if (setup.isFlat == true)
+        {
+            if (first <= last)
+            {
+                BlendSpan(row + minX + first, (int)(last - first + 1), setup.flatColor);
+            }
+            continue;
+        }
+        for (int x = minX + (int)first; x <= minX + (int)last; x++)
+        {
+            const float px = x + 0.5f;
+            ImU32 color = setup.flatColor;
+            if (setup.isColorFlat == false)
+            {
+                color = 0;
+                for (int c = 0; c < 4; c++)
+                {
+                    int value = (int)(setup.color[c].At(px, py) + 0.5f);
+                    color |= (ImU32)std::min(std::max(value, 0), 255) << (c * 8);
+                }
+            }
+            if (setup.texture != nullptr)
+            {
+                const Texture& texture = *setup.texture;
+                int tx = (int)std::floor(setup.u.At(px, py));
+                int ty = (int)std::floor(setup.v.At(px, py));
+                tx = std::min(std::max(tx, 0), texture.width - 1);
+                ty = std::min(std::max(ty, 0), texture.height - 1);
+                color = Modulate(texture.pixels[(size_t)ty * texture.width + tx], color);
+            }
+            row[x] = Blend(color, row[x]);
+        }
+    }
+}
+
+void SoftwareRasterizer::WorkerMain()
+{
+    unsigned int frame = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this, frame]()
+                        {
+                            return m_quit == true || m_frame != frame;
+                        });
+            if (m_quit == true)
+            {
+                return;
+            }
+            frame = m_frame;
+        }
+
+        RasterizeTiles();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busyWorkers--;
+        }
+        m_done.notify_one();
+    }
+}
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include "vendor/imgui/imgui.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace Renderer
+{
+
+/**
+ * @class   SoftwareRasterizer
+ * @brief   Renders ImDrawData into an RGBA framebuffer in memory, without any GPU.
+ *          It matches what the OpenGL back-end does: clip rects are scissors, textures are
+ *          multiplied by the vertex colors, and everything is alpha blended in submission order.
+ *          Textures are sampled at the nearest texel, which is exact for the font atlas as
+ *          glyphs are drawn with one texel per pixel.
+ *
+ *          Triangles are set up and binned into TILE_SIZE square tiles in order, then the tiles
+ *          are rasterized in parallel. Each tile is owned by a single thread, so no pixel is ever
+ *          written by two threads, and the blending order within a tile is the draw order.
+ */
+class SoftwareRasterizer
+{
+public:
+    static constexpr int TILE_SIZE = 64;
+    static constexpr int SUBPIXELS = 16;                //!< Vertices are snapped to 1/SUBPIXELS of a pixel.
+    static constexpr float MAX_COORDINATE = 1 << 22;    //!< Triangles with a vertex further away, in pixels, are dropped.
+
+    /**
+     * @param   threadCount: Number of threads rasterizing tiles, including the one calling Render.
+     *          0 uses every core.
+     */
+    explicit SoftwareRasterizer(unsigned int threadCount = 0);
+    ~SoftwareRasterizer();
+    SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+    SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+
+    /**
+     * @brief   Copy a texture so that draw commands can use it.
+     * @param   pixels: width * height RGBA pixels, 4 bytes each.
+     * @retval  The ID the draw commands must use to sample the texture.
+     */
+    ImTextureID AddTexture(const unsigned char* pixels, int width, int height);
+
+    /**
+     * @brief   Add the texture of a font atlas and make the atlas use it.
+     *          The atlas gets built if it wasn't already.
+     */
+    void AddFontAtlas(ImFontAtlas* atlas);
+
+    /**
+     * @brief   Render a frame. The framebuffer is resized to the draw data's display size,
+     *          scaled by its framebuffer scale, and cleared first.
+     *          Draw commands using an unknown texture are drawn with their vertex colors only.
+     * @param   drawData: The frame to render, usually ImGui::GetDrawData().
+     * @param   clearColor: The color of the background.
+     */
+    void Render(const ImDrawData* drawData, ImU32 clearColor = IM_COL32(0, 0, 0, 255));
+
+    /**
+     * @brief   The framebuffer, in rows from top to bottom, packed like IM_COL32: R, G, B and A bytes in memory.
+     */
+    inline const ImU32* Pixels() const
+    {
+        return m_pixels.data();
+    }
+    /**
+     * @brief   Exchange the framebuffer with another buffer, to take the frame without copying it.
+     *          The buffer given back is reused and resized by the next Render.
+     */
+    inline void SwapPixels(std::vector<ImU32>& pixels)
+    {
+        m_pixels.swap(pixels);
+    }
+    inline int Width() const
+    {
+        return m_width;
+    }
+    inline int Height() const
+    {
+        return m_height;
+    }
+    inline unsigned int ThreadCount() const
+    {
+        return (unsigned int)m_workers.size() + 1;
+    }
+
+private:
+    struct Texture
+    {
+        std::vector<ImU32> pixels;
+        int width = 0;
+        int height = 0;
+    };
+
+    /**
+     * An attribute interpolated linearly over a triangle: value = dx * x + dy * y + c.
+     */
+    struct Plane
+    {
+        float dx;
+        float dy;
+        float c;
+
+        inline float At(float x, float y) const
+        {
+            return dx * x + dy * y + c;
+        }
+    };
+
+    /**
+     * An edge function in fixed point: a * x + b * y + c, at the center of a pixel in subpixels.
+     * A pixel is covered when it is 0 or more for all three edges of a triangle.
+     */
+    struct Edge
+    {
+        int64_t a;
+        int64_t b;
+        int64_t c;
+    };
+
+    /**
+     * A triangle ready to be rasterized, in framebuffer pixels.
+     */
+    struct Setup
+    {
+        Edge edges[3];
+        int minX;               //!< Pixels covered, clipped, max excluded.
+        int minY;
+        int maxX;
+        int maxY;
+        Plane u;
+        Plane v;
+        Plane color[4];         //!< R, G, B and A, 0 to 255.
+        const Texture* texture; //!< nullptr when untextured.
+        bool isColorFlat;       //!< The vertex color is the same over the whole triangle.
+        bool isFlat;            //!< The vertex color and UVs are the same over the whole triangle.
+        ImU32 flatColor;        //!< The vertex color when it is flat, multiplied by the texture if the whole triangle is.
+    };
+
+    const Texture* FindTexture(ImTextureID id) const;
+    void SetupTriangle(const ImDrawVert& v0, const ImDrawVert& v1, const ImDrawVert& v2,
+                       const ImVec4& clip, const Texture* texture, const ImVec2& offset, const ImVec2& scale);
+    void RasterizeTiles();
+    void RasterizeTile(int tile);
+    void RasterizeTriangle(const Setup& setup, int minX, int minY, int maxX, int maxY);
+    void WorkerMain();
+
+private:
+    std::vector<std::unique_ptr<Texture>> m_textures = std::vector<std::unique_ptr<Texture>>();
+
+    std::vector<ImU32> m_pixels = std::vector<ImU32>();
+    int m_width = 0;
+    int m_height = 0;
+    ImU32 m_clearColor = 0;
+
+    std::vector<Setup> m_setups = std::vector<Setup>();
+    std::vector<std::vector<unsigned int>> m_bins = std::vector<std::vector<unsigned int>>(); //!< Setups overlapping each tile, in draw order.
+    int m_tilesX = 0;
+    int m_tilesY = 0;
+
+    std::vector<std::thread> m_workers = std::vector<std::thread>();
+    std::mutex m_mutex;
+    std::condition_variable m_wake;         //!< Signals the workers that a frame is ready to be rasterized.
+    std::condition_variable m_done;         //!< Signals Render that every worker is done with the frame.
+    unsigned int m_frame = 0;               //!< Incremented for every frame given to the workers.
+    unsigned int m_busyWorkers = 0;
+    bool m_quit = false;
+    std::atomic<int> m_nextTile = 0;
+};
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "vendor/imgui/imgui.h"
+#include <math.h>
+
+namespace Renderer
+{
+
+/**
+ * @class   Transform
+ * @brief   A 2x3 affine matrix that maps mesh coordinates ([0..1] range) to screen coordinates.
+ *
+ *          | A  B  Tx |   | x |
+ *          | C  D  Ty | * | y |
+ *                         | 1 |
+ *
+ *          The rotation is applied around the origin of the mesh, then the result is scaled to
+ *          the size of the mesh and translated so that the anchor lands on the mesh's position.
+ */
+class Transform
+{
+public:
+    Transform() = default;
+    Transform(float a, float b, float c, float d, float tx, float ty) :
+        m_a(a), m_b(b), m_c(c), m_d(d), m_tx(tx), m_ty(ty)
+    {
+    }
+
+    /**
+     * @brief   Build the transform of a mesh.
+     * @param   pos: Screen position of the mesh's anchor.
+     * @param   size: Size of the mesh in pixels.
+     * @param   anchor: Where in mesh coordinates is pos. [0..1] range.
+     * @param   rotation: Rotation of the mesh, in degrees.
+     */
+    static inline Transform FromMesh(const ImVec2& pos, const ImVec2& size, const ImVec2& anchor, float rotation)
+    {
+        static const float pi = 3.14159265359f;
+        const float rad = (rotation * pi) / 180.0f;    // cos and sin take radians, not degrees.
+        const float c = cosf(rad);
+        const float s = sinf(rad);
+
+        return Transform(size.x * c, -size.x * s,
+                         size.y * s, size.y * c,
+                         pos.x - (anchor.x * size.x), pos.y - (anchor.y * size.y));
+    }
+
+    /**
+     * @brief   Transform a single point from mesh coordinates to screen coordinates.
+     */
+    inline ImVec2 Apply(const ImVec2& p) const
+    {
+        return ImVec2(((m_a * p.x) + (m_b * p.y)) + m_tx,
+                      ((m_c * p.x) + (m_d * p.y)) + m_ty);
+    }
+
+    /**
+     * @brief   Transform count points from mesh coordinates to screen coordinates.
+     * @param   in: The points to transform.
+     * @param   out: Where to write the transformed points. Can be the same as in.
+     * @param   count: The number of points.
+     */
+    inline void Apply(const ImVec2* in, ImVec2* out, size_t count) const
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            out[i] = Apply(in[i]);
+        }
+    }
+
+    inline bool operator==(const Transform& other) const
+    {
+        return m_a == other.m_a && m_b == other.m_b && m_c == other.m_c &&
+            m_d == other.m_d && m_tx == other.m_tx && m_ty == other.m_ty;
+    }
+    inline bool operator!=(const Transform& other) const
+    {
+        return !(*this == other);
+    }
+
+#pragma region Accessors
+    inline float A() const
+    {
+        return m_a;
+    }
+    inline float B() const
+    {
+        return m_b;
+    }
+    inline float C() const
+    {
+        return m_c;
+    }
+    inline float D() const
+    {
+        return m_d;
+    }
+    inline float Tx() const
+    {
+        return m_tx;
+    }
+    inline float Ty() const
+    {
+        return m_ty;
+    }
+#pragma endregion
+
+private:
+    float m_a = 1.0f;
+    float m_b = 0.0f;
+    float m_c = 0.0f;
+    float m_d = 1.0f;
+    float m_tx = 0.0f;
+    float m_ty = 0.0f;
+};
+}
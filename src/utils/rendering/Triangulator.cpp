@@ -0,0 +1,1430 @@
+// The ear clipping is ported from earcut, https://github.com/mapbox/earcut, under the following license:
+//
+// ISC License
+//
+// Copyright (c) 2016, Mapbox
+//
+// Permission to use, copy, modify, and/or distribute this software for any purpose
+// with or without fee is hereby granted, provided that the above copyright notice
+// and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND ISC DISCLAIMS ALL WARRANTIES WITH REGARD TO
+// THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+// IN NO EVENT SHALL ISC BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+// DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+// WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+// OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "Triangulator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Renderer
+{
+const std::vector<unsigned int>& Triangulator::Triangulate(const ImVec2* outline, size_t count,
+                                                           const std::vector<std::vector<ImVec2>>& holes)
+{
+    m_indices.clear();
+    m_usedNodes = 0;
+    m_invSize = 0.0f;
+
+    size_t totalCount = count;
+    for (const std::vector<ImVec2>& hole : holes)
+    {
+        totalCount += hole.size();
+    }
+    m_indices.reserve(3 * (totalCount + 2 * holes.size()));
+
+    Node* outerNode = LinkedList(outline, count, 0, true);
+    if (outerNode == nullptr || outerNode->next == outerNode->prev)
+    {
+        return m_indices;
+    }
+
+    // Large polygons are split into monotone pieces, in O(n log n) whatever their shape.
+    // Ear clipping is kept for small polygons, and for the ones the sweep rejects, such as self-intersecting ones.
+    if (totalCount > HASH_THRESHOLD)
+    {
+        if (SweepTriangulate(outerNode, holes, (unsigned int)count) == true)
+        {
+            return m_indices;
+        }
+        m_indices.clear();
+        m_usedNodes = 0;
+        outerNode = LinkedList(outline, count, 0, true);
+    }
+
+    if (holes.empty() == false)
+    {
+        outerNode = EliminateHoles(holes, (unsigned int)count, outerNode);
+    }
+
+    // Index the vertices along a z-order curve so that ears only check the vertices near them.
+    if (totalCount > HASH_THRESHOLD)
+    {
+        // Holes are included in case they stick out of the outline, which would overflow the curve.
+        float maxX = outline[0].x;
+        float maxY = outline[0].y;
+        m_minX = maxX;
+        m_minY = maxY;
+        auto addBounds = [&maxX, &maxY, this](const ImVec2* points, size_t pointCount)
+        {
+            for (size_t i = 0; i < pointCount; i++)
+            {
+                m_minX = std::min(m_minX, points[i].x);
+                m_minY = std::min(m_minY, points[i].y);
+                maxX = std::max(maxX, points[i].x);
+                maxY = std::max(maxY, points[i].y);
+            }
+        };
+        addBounds(outline, count);
+        for (const std::vector<ImVec2>& hole : holes)
+        {
+            addBounds(hole.data(), hole.size());
+        }
+        float size = std::max(maxX - m_minX, maxY - m_minY);
+        m_invSize = size != 0.0f ? 32767.0f / size : 0.0f;
+    }
+
+    EarcutLinked(outerNode, 0);
+    return m_indices;
+}
+
+void Triangulator::Triangulate(const std::vector<ImVec2>& outline, const std::vector<std::vector<ImVec2>>& holes,
+                               ImU32 color, std::vector<Triangle>& out)
+{
+    out.clear();
+    const std::vector<unsigned int>& indices = Triangulate(outline, holes);
+    if (indices.empty() == true)
+    {
+        return;
+    }
+
+    // Points of the holes come after the outline's, in order.
+    m_points.assign(outline.begin(), outline.end());
+    for (const std::vector<ImVec2>& hole : holes)
+    {
+        m_points.insert(m_points.end(), hole.begin(), hole.end());
+    }
+
+    ImVec2 min = outline[0];
+    ImVec2 max = outline[0];
+    for (const ImVec2& point : outline)
+    {
+        min = ImVec2(std::min(min.x, point.x), std::min(min.y, point.y));
+        max = ImVec2(std::max(max.x, point.x), std::max(max.y, point.y));
+    }
+    ImVec2 scale = ImVec2(max.x != min.x ? 1.0f / (max.x - min.x) : 0.0f,
+                          max.y != min.y ? 1.0f / (max.y - min.y) : 0.0f);
+    for (ImVec2& point : m_points)
+    {
+        point = ImVec2((point.x - min.x) * scale.x, (point.y - min.y) * scale.y);
+    }
+
+    out.reserve(indices.size() / 3);
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        out.emplace_back(m_points[indices[i]], m_points[indices[i + 1]], m_points[indices[i + 2]], color);
+    }
+}
+
+Triangulator::Node* Triangulator::NewNode(unsigned int i, float x, float y)
+{
+    // Nodes are allocated in blocks that are never moved nor freed, the links between them stay valid.
+    size_t block = m_usedNodes / BLOCK_SIZE;
+    if (block == m_blocks.size())
+    {
+        m_blocks.emplace_back(new Node[BLOCK_SIZE]);
+    }
+    Node* node = &m_blocks[block][m_usedNodes % BLOCK_SIZE];
+    m_usedNodes++;
+
+    node->i = i;
+    node->x = x;
+    node->y = y;
+    node->prev = nullptr;
+    node->next = nullptr;
+    node->z = 0;
+    node->prevZ = nullptr;
+    node->nextZ = nullptr;
+    node->steiner = false;
+    return node;
+}
+
+Triangulator::Node* Triangulator::InsertNode(unsigned int i, float x, float y, Node* last)
+{
+    Node* p = NewNode(i, x, y);
+    if (last == nullptr)
+    {
+        p->prev = p;
+        p->next = p;
+    }
+    else
+    {
+        p->next = last->next;
+        p->prev = last;
+        last->next->prev = p;
+        last->next = p;
+    }
+    return p;
+}
+
+void Triangulator::RemoveNode(Node* p)
+{
+    p->next->prev = p->prev;
+    p->prev->next = p->next;
+    if (p->prevZ != nullptr)
+    {
+        p->prevZ->nextZ = p->nextZ;
+    }
+    if (p->nextZ != nullptr)
+    {
+        p->nextZ->prevZ = p->prevZ;
+    }
+}
+
+/**
+ * @brief   Build a ring from points, in the requested winding.
+ */
+Triangulator::Node* Triangulator::LinkedList(const ImVec2* points, size_t count, unsigned int first, bool clockwise)
+{
+    if (count == 0)
+    {
+        return nullptr;
+    }
+
+    double sum = 0.0;
+    for (size_t i = 0, j = count - 1; i < count; j = i++)
+    {
+        sum += double(points[j].x - points[i].x) * double(points[i].y + points[j].y);
+    }
+
+    Node* last = nullptr;
+    if (clockwise == (sum > 0.0))
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            last = InsertNode(first + (unsigned int)i, points[i].x, points[i].y, last);
+        }
+    }
+    else
+    {
+        for (size_t i = count; i-- > 0;)
+        {
+            last = InsertNode(first + (unsigned int)i, points[i].x, points[i].y, last);
+        }
+    }
+
+    if (last != nullptr && Equals(last, last->next) == true)
+    {
+        RemoveNode(last);
+        last = last->next;
+    }
+    return last;
+}
+
+/**
+ * @brief   Remove duplicated and collinear points.
+ */
+Triangulator::Node* Triangulator::FilterPoints(Node* start, Node* end)
+{
+    if (start == nullptr)
+    {
+        return start;
+    }
+    if (end == nullptr)
+    {
+        end = start;
+    }
+
+    Node* p = start;
+    bool again;
+    do
+    {
+        again = false;
+        if (p->steiner == false && (Equals(p, p->next) == true || Area(p->prev, p, p->next) == 0.0f))
+        {
+            RemoveNode(p);
+            p = end = p->prev;
+            if (p == p->next)
+            {
+                break;
+            }
+            again = true;
+        }
+        else
+        {
+            p = p->next;
+        }
+    } while (again == true || p != end);
+
+    return end;
+}
+
+/**
+ * @brief   Clip ears off a ring until only a triangle is left.
+ *          When no ear can be found, the ring is cleaned up and retried: first without its degenerate points,
+ *          then with its local self-intersections cut off, and finally split in two along a valid diagonal.
+ */
+void Triangulator::EarcutLinked(Node* ear, int pass)
+{
+    if (ear == nullptr)
+    {
+        return;
+    }
+    if (pass == 0 && m_invSize != 0.0f)
+    {
+        IndexCurve(ear);
+    }
+
+    Node* stop = ear;
+    while (ear->prev != ear->next)
+    {
+        Node* prev = ear->prev;
+        Node* next = ear->next;
+
+        if (m_invSize != 0.0f ? IsEarHashed(ear) : IsEar(ear))
+        {
+            AddTriangle(prev, ear, next);
+            RemoveNode(ear);
+
+            // Skipping the next vertex leads to less sliver triangles.
+            ear = next->next;
+            stop = next->next;
+            continue;
+        }
+
+        ear = next;
+        if (ear == stop)
+        {
+            if (pass == 0)
+            {
+                EarcutLinked(FilterPoints(ear), 1);
+            }
+            else if (pass == 1)
+            {
+                ear = CureLocalIntersections(FilterPoints(ear));
+                EarcutLinked(ear, 2);
+            }
+            else if (pass == 2)
+            {
+                SplitEarcut(ear);
+            }
+            break;
+        }
+    }
+}
+
+bool Triangulator::IsEar(Node* ear) const
+{
+    const Node* a = ear->prev;
+    const Node* b = ear;
+    const Node* c = ear->next;
+    if (Area(a, b, c) >= 0.0f)
+    {
+        // Reflex, can't be an ear.
+        return false;
+    }
+
+    // No other point may be inside the ear.
+    for (const Node* p = ear->next->next; p != ear->prev; p = p->next)
+    {
+        if (PointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) == true &&
+            Area(p->prev, p, p->next) >= 0.0f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Triangulator::IsEarHashed(Node* ear) const
+{
+    const Node* a = ear->prev;
+    const Node* b = ear;
+    const Node* c = ear->next;
+    if (Area(a, b, c) >= 0.0f)
+    {
+        return false;
+    }
+
+    // Only the points whose z-order is within the triangle's bounding box can be inside it.
+    const float minX = std::min(a->x, std::min(b->x, c->x));
+    const float minY = std::min(a->y, std::min(b->y, c->y));
+    const float maxX = std::max(a->x, std::max(b->x, c->x));
+    const float maxY = std::max(a->y, std::max(b->y, c->y));
+    const int32_t minZ = ZOrder(minX, minY);
+    const int32_t maxZ = ZOrder(maxX, maxY);
+
+    auto isBlocking = [a, b, c, ear](const Node* p)
+    {
+        return p != ear->prev && p != ear->next &&
+               PointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) == true &&
+               Area(p->prev, p, p->next) >= 0.0f;
+    };
+
+    // Look both ways from the ear at the same time.
+    const Node* p = ear->prevZ;
+    const Node* n = ear->nextZ;
+    while (p != nullptr && p->z >= minZ && n != nullptr && n->z <= maxZ)
+    {
+        if (isBlocking(p) == true || isBlocking(n) == true)
+        {
+            return false;
+        }
+        p = p->prevZ;
+        n = n->nextZ;
+    }
+    for (; p != nullptr && p->z >= minZ; p = p->prevZ)
+    {
+        if (isBlocking(p) == true)
+        {
+            return false;
+        }
+    }
+    for (; n != nullptr && n->z <= maxZ; n = n->nextZ)
+    {
+        if (isBlocking(n) == true)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief   Cut off the triangles formed by two crossing consecutive edges.
+ */
+Triangulator::Node* Triangulator::CureLocalIntersections(Node* start)
+{
+    Node* p = start;
+    do
+    {
+        Node* a = p->prev;
+        Node* b = p->next->next;
+
+        if (Equals(a, b) == false && Intersects(a, p, p->next, b) == true &&
+            LocallyInside(a, b) == true && LocallyInside(b, a) == true)
+        {
+            AddTriangle(a, p, b);
+            RemoveNode(p);
+            RemoveNode(p->next);
+            p = start = b;
+        }
+        p = p->next;
+    } while (p != start);
+
+    return FilterPoints(p);
+}
+
+/**
+ * @brief   Split a ring in two along a valid diagonal and triangulate both halves.
+ */
+void Triangulator::SplitEarcut(Node* start)
+{
+    Node* a = start;
+    do
+    {
+        for (Node* b = a->next->next; b != a->prev; b = b->next)
+        {
+            if (a->i != b->i && IsValidDiagonal(a, b) == true)
+            {
+                Node* c = SplitPolygon(a, b);
+                a = FilterPoints(a, a->next);
+                c = FilterPoints(c, c->next);
+
+                EarcutLinked(a, 0);
+                EarcutLinked(c, 0);
+                return;
+            }
+        }
+        a = a->next;
+    } while (a != start);
+}
+
+/**
+ * @brief   Merge every hole into the outline, from left to right, through a bridge to a visible outline vertex.
+ */
+Triangulator::Node* Triangulator::EliminateHoles(const std::vector<std::vector<ImVec2>>& holes, unsigned int first,
+                                                 Node* outerNode)
+{
+    m_holeQueue.clear();
+    for (const std::vector<ImVec2>& hole : holes)
+    {
+        Node* list = LinkedList(hole.data(), hole.size(), first, false);
+        first += (unsigned int)hole.size();
+        if (list == nullptr)
+        {
+            continue;
+        }
+        if (list == list->next)
+        {
+            list->steiner = true;
+        }
+
+        // Bridge from the leftmost point of the hole.
+        Node* leftmost = list;
+        Node* p = list;
+        do
+        {
+            if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y))
+            {
+                leftmost = p;
+            }
+            p = p->next;
+        } while (p != list);
+        m_holeQueue.push_back(leftmost);
+    }
+
+    std::sort(m_holeQueue.begin(), m_holeQueue.end(), [](const Node* a, const Node* b)
+              {
+                  return a->x < b->x;
+              });
+
+    for (Node* hole : m_holeQueue)
+    {
+        outerNode = EliminateHole(hole, outerNode);
+    }
+    return outerNode;
+}
+
+Triangulator::Node* Triangulator::EliminateHole(Node* hole, Node* outerNode)
+{
+    Node* bridge = FindHoleBridge(hole, outerNode);
+    if (bridge == nullptr)
+    {
+        return outerNode;
+    }
+
+    Node* bridgeReverse = SplitPolygon(bridge, hole);
+
+    // Filter the collinear points around the cuts.
+    FilterPoints(bridgeReverse, bridgeReverse->next);
+    return FilterPoints(bridge, bridge->next);
+}
+
+/**
+ * @brief   Find an outline vertex the hole's leftmost point can be connected to without crossing any edge.
+ */
+Triangulator::Node* Triangulator::FindHoleBridge(Node* hole, Node* outerNode)
+{
+    Node* p = outerNode;
+    const float hx = hole->x;
+    const float hy = hole->y;
+    float qx = -INFINITY;
+    Node* m = nullptr;
+
+    // Find the segment left of the hole point, on a ray going left, that is the closest to it.
+    do
+    {
+        if (hy <= p->y && hy >= p->next->y && p->next->y != p->y)
+        {
+            float x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+            if (x <= hx && x > qx)
+            {
+                qx = x;
+                m = p->x < p->next->x ? p : p->next;
+                if (x == hx)
+                {
+                    // The hole touches the outline.
+                    return m;
+                }
+            }
+        }
+        p = p->next;
+    } while (p != outerNode);
+
+    if (m == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Check for vertices inside the triangle formed by the hole point, the intersection and the segment's end.
+    // If there are any, the one with the smallest angle to the ray is the bridge instead.
+    const Node* stop = m;
+    const float mx = m->x;
+    const float my = m->y;
+    float tanMin = INFINITY;
+
+    p = m;
+    do
+    {
+        if (hx >= p->x && p->x >= mx && hx != p->x &&
+            PointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y) == true)
+        {
+            float tan = std::abs(hy - p->y) / (hx - p->x);
+            if (LocallyInside(p, hole) == true &&
+                (tan < tanMin || (tan == tanMin && (p->x > m->x || (p->x == m->x && SectorContainsSector(m, p) == true)))))
+            {
+                m = p;
+                tanMin = tan;
+            }
+        }
+        p = p->next;
+    } while (p != stop);
+
+    return m;
+}
+
+/**
+ * @brief   Sort the nodes of a ring along the z-order curve, through their z links.
+ */
+void Triangulator::IndexCurve(Node* start) const
+{
+    Node* p = start;
+    do
+    {
+        if (p->z == 0)
+        {
+            p->z = ZOrder(p->x, p->y);
+        }
+        p->prevZ = p->prev;
+        p->nextZ = p->next;
+        p = p->next;
+    } while (p != start);
+
+    p->prevZ->nextZ = nullptr;
+    p->prevZ = nullptr;
+
+    SortLinked(p);
+}
+
+/**
+ * @brief   Bottom-up merge sort of the z links, in O(n log n) without any allocation.
+ */
+Triangulator::Node* Triangulator::SortLinked(Node* list)
+{
+    int inSize = 1;
+    int numMerges;
+    do
+    {
+        Node* p = list;
+        Node* tail = nullptr;
+        list = nullptr;
+        numMerges = 0;
+
+        while (p != nullptr)
+        {
+            numMerges++;
+            Node* q = p;
+            int pSize = 0;
+            for (int i = 0; i < inSize && q != nullptr; i++)
+            {
+                pSize++;
+                q = q->nextZ;
+            }
+            int qSize = inSize;
+
+            while (pSize > 0 || (qSize > 0 && q != nullptr))
+            {
+                Node* e;
+                if (pSize != 0 && (qSize == 0 || q == nullptr || p->z <= q->z))
+                {
+                    e = p;
+                    p = p->nextZ;
+                    pSize--;
+                }
+                else
+                {
+                    e = q;
+                    q = q->nextZ;
+                    qSize--;
+                }
+
+                if (tail != nullptr)
+                {
+                    tail->nextZ = e;
+                }
+                else
+                {
+                    list = e;
+                }
+                e->prevZ = tail;
+                tail = e;
+            }
+            p = q;
+        }
+
+        tail->nextZ = nullptr;
+        inSize *= 2;
+    } while (numMerges > 1);
+
+    return list;
+}
+
+/**
+ * @brief   Position of a point on the z-order curve, its coordinates scaled to 15 bits and interleaved.
+ */
+int32_t Triangulator::ZOrder(float x, float y) const
+{
+    int32_t ix = int32_t((x - m_minX) * m_invSize);
+    int32_t iy = int32_t((y - m_minY) * m_invSize);
+
+    ix = (ix | (ix << 8)) & 0x00FF00FF;
+    ix = (ix | (ix << 4)) & 0x0F0F0F0F;
+    ix = (ix | (ix << 2)) & 0x33333333;
+    ix = (ix | (ix << 1)) & 0x55555555;
+
+    iy = (iy | (iy << 8)) & 0x00FF00FF;
+    iy = (iy | (iy << 4)) & 0x0F0F0F0F;
+    iy = (iy | (iy << 2)) & 0x33333333;
+    iy = (iy | (iy << 1)) & 0x55555555;
+
+    return ix | (iy << 1);
+}
+
+/**
+ * @brief   Link a and b with a diagonal, splitting the ring in two.
+ *          If a and b are on different rings, such as a hole and the outline, they are merged into one instead.
+ * @retval  The copy of b, on the second ring.
+ */
+Triangulator::Node* Triangulator::SplitPolygon(Node* a, Node* b)
+{
+    Node* a2 = NewNode(a->i, a->x, a->y);
+    Node* b2 = NewNode(b->i, b->x, b->y);
+    Node* an = a->next;
+    Node* bp = b->prev;
+
+    a->next = b;
+    b->prev = a;
+
+    a2->next = an;
+    an->prev = a2;
+
+    b2->next = a2;
+    a2->prev = b2;
+
+    bp->next = b2;
+    b2->prev = bp;
+
+    return b2;
+}
+
+void Triangulator::AddTriangle(const Node* a, const Node* b, const Node* c)
+{
+    m_indices.push_back(a->i);
+    m_indices.push_back(b->i);
+    m_indices.push_back(c->i);
+}
+
+/**
+ * @brief   Twice the signed area of a triangle, negative when it turns the way the rings are built.
+ */
+float Triangulator::Area(const Node* p, const Node* q, const Node* r)
+{
+    return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+}
+
+bool Triangulator::Equals(const Node* a, const Node* b)
+{
+    return a->x == b->x && a->y == b->y;
+}
+
+bool Triangulator::PointInTriangle(float ax, float ay, float bx, float by, float cx, float cy, float px, float py)
+{
+    return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+           (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+           (bx - px) * (cy - py) >= (cx - px) * (by - py);
+}
+
+static inline int Sign(float value)
+{
+    return (value > 0.0f) - (value < 0.0f);
+}
+
+static inline bool OnSegment(float px, float py, float qx, float qy, float rx, float ry)
+{
+    return qx <= std::max(px, rx) && qx >= std::min(px, rx) && qy <= std::max(py, ry) && qy >= std::min(py, ry);
+}
+
+bool Triangulator::Intersects(const Node* p1, const Node* q1, const Node* p2, const Node* q2)
+{
+    int o1 = Sign(Area(p1, q1, p2));
+    int o2 = Sign(Area(p1, q1, q2));
+    int o3 = Sign(Area(p2, q2, p1));
+    int o4 = Sign(Area(p2, q2, q1));
+
+    if (o1 != o2 && o3 != o4)
+    {
+        return true;
+    }
+
+    // Collinear points lying on the other segment.
+    return (o1 == 0 && OnSegment(p1->x, p1->y, p2->x, p2->y, q1->x, q1->y)) ||
+           (o2 == 0 && OnSegment(p1->x, p1->y, q2->x, q2->y, q1->x, q1->y)) ||
+           (o3 == 0 && OnSegment(p2->x, p2->y, p1->x, p1->y, q2->x, q2->y)) ||
+           (o4 == 0 && OnSegment(p2->x, p2->y, q1->x, q1->y, q2->x, q2->y));
+}
+
+/**
+ * @brief   Whether the segment ab crosses any edge of the ring.
+ */
+bool Triangulator::IntersectsPolygon(const Node* a, const Node* b)
+{
+    const Node* p = a;
+    do
+    {
+        if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i &&
+            Intersects(p, p->next, a, b) == true)
+        {
+            return true;
+        }
+        p = p->next;
+    } while (p != a);
+    return false;
+}
+
+/**
+ * @brief   Whether the diagonal ab starts towards the inside of the ring at a.
+ */
+bool Triangulator::LocallyInside(const Node* a, const Node* b)
+{
+    if (Area(a->prev, a, a->next) < 0.0f)
+    {
+        return Area(a, b, a->next) >= 0.0f && Area(a, a->prev, b) >= 0.0f;
+    }
+    return Area(a, b, a->prev) < 0.0f || Area(a, a->next, b) < 0.0f;
+}
+
+/**
+ * @brief   Whether the middle of the diagonal ab is inside the ring.
+ */
+bool Triangulator::MiddleInside(const Node* a, const Node* b)
+{
+    const Node* p = a;
+    bool inside = false;
+    const float px = (a->x + b->x) / 2.0f;
+    const float py = (a->y + b->y) / 2.0f;
+    do
+    {
+        if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+            (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x))
+        {
+            inside = !inside;
+        }
+        p = p->next;
+    } while (p != a);
+    return inside;
+}
+
+/**
+ * @brief   Whether the ring can be split along the diagonal ab.
+ */
+bool Triangulator::IsValidDiagonal(const Node* a, const Node* b)
+{
+    if (a->next->i == b->i || a->prev->i == b->i || IntersectsPolygon(a, b) == true)
+    {
+        return false;
+    }
+
+    // The diagonal must be inside the ring and not make a degenerate split,
+    if (LocallyInside(a, b) == true && LocallyInside(b, a) == true && MiddleInside(a, b) == true &&
+        (Area(a->prev, a, b->prev) != 0.0f || Area(a, b->prev, b) != 0.0f))
+    {
+        return true;
+    }
+    // or join two identical points that are both convex.
+    return Equals(a, b) == true && Area(a->prev, a, a->next) > 0.0f && Area(b->prev, b, b->next) > 0.0f;
+}
+
+/**
+ * @brief   Whether the sector of the vertex m contains the sector of the vertex p, both at the same position.
+ */
+bool Triangulator::SectorContainsSector(const Node* m, const Node* p)
+{
+    return Area(m->prev, m, p->prev) < 0.0f && Area(p->next, m, m->next) < 0.0f;
+}
+
+/**
+ * @brief   Triangulate the outline and its holes by splitting them into y-monotone pieces with a sweep line,
+ *          then triangulating every piece along its two chains.
+ * @param   outerNode: The outer ring.
+ * @param   holes: The inner rings.
+ * @param   first: Index of the first point of the first hole.
+ * @retval  False if the rings are degenerate or intersect each other, m_indices must then be discarded.
+ */
+bool Triangulator::SweepTriangulate(Node* outerNode, const std::vector<std::vector<ImVec2>>& holes, unsigned int first)
+{
+    m_sweep.clear();
+    m_polygonArea = 0.0;
+    if (AddSweepRing(FilterPoints(outerNode)) == false)
+    {
+        return false;
+    }
+    for (const std::vector<ImVec2>& hole : holes)
+    {
+        Node* list = LinkedList(hole.data(), hole.size(), first, false);
+        first += (unsigned int)hole.size();
+        if (list != nullptr && AddSweepRing(FilterPoints(list)) == false)
+        {
+            return false;
+        }
+    }
+    if (m_polygonArea <= 0.0)
+    {
+        return false;
+    }
+
+    m_sweepOrder.resize(m_sweep.size());
+    for (unsigned int v = 0; v < (unsigned int)m_sweep.size(); v++)
+    {
+        m_sweepOrder[v] = v;
+    }
+    std::sort(m_sweepOrder.begin(), m_sweepOrder.end(), [this](unsigned int a, unsigned int b)
+              {
+                  return Before(a, b);
+              });
+
+    // The status holds the edges with the inside of the polygon to their east, in west to east order.
+    // An edge is referred to by the vertex it starts from, following the ring.
+    m_statusRoot = NONE;
+    m_statusError = false;
+    m_diagonals.clear();
+    for (unsigned int v : m_sweepOrder)
+    {
+        SweepVertex& vertex = m_sweep[v];
+        const unsigned int prev = vertex.prev;
+        const bool prevBefore = Before(prev, v);
+        const bool nextBefore = Before(vertex.next, v);
+        const bool reflex = SweepArea(prev, v, vertex.next) > 0.0;
+        m_sweepX = vertex.x;
+        m_sweepY = vertex.y;
+        vertex.merge = prevBefore && nextBefore && reflex;
+
+        if (prevBefore == false && nextBefore == false)
+        {
+            // Start vertex, or split vertex, that is linked to the last vertex seen to its west.
+            if (reflex)
+            {
+                unsigned int west = FindWestEdge();
+                if (west == NONE)
+                {
+                    return false;
+                }
+                AddDiagonal(v, m_sweep[west].helper);
+                m_sweep[west].helper = v;
+            }
+            InsertStatus(prev, v);
+        }
+        else if (nextBefore)
+        {
+            // End, merge or regular vertex ending the edge it shares with the next vertex.
+            EndStatus(v, v);
+            if (prevBefore == false)
+            {
+                InsertStatus(prev, v);
+            }
+        }
+        if (prevBefore && (nextBefore == false || reflex))
+        {
+            // Merge vertex, or regular vertex with the inside to its west.
+            unsigned int west = FindWestEdge();
+            if (west == NONE)
+            {
+                return false;
+            }
+            if (m_sweep[m_sweep[west].helper].merge)
+            {
+                AddDiagonal(v, m_sweep[west].helper);
+            }
+            m_sweep[west].helper = v;
+        }
+        if (m_statusError)
+        {
+            return false;
+        }
+    }
+
+    return TriangulatePieces();
+}
+
+/**
+ * @brief   Append a ring to the sweep vertices.
+ * @retval  False if the ring is degenerate.
+ */
+bool Triangulator::AddSweepRing(Node* start)
+{
+    if (start == nullptr || start->next == start->prev)
+    {
+        return false;
+    }
+
+    const unsigned int first = (unsigned int)m_sweep.size();
+    const Node* p = start;
+    do
+    {
+        SweepVertex vertex;
+        vertex.i = p->i;
+        vertex.x = p->x;
+        vertex.y = p->y;
+        vertex.prev = (unsigned int)m_sweep.size() - 1;
+        vertex.next = (unsigned int)m_sweep.size() + 1;
+        m_sweep.push_back(vertex);
+        p = p->next;
+    } while (p != start);
+    const unsigned int last = (unsigned int)m_sweep.size() - 1;
+    m_sweep[first].prev = last;
+    m_sweep[last].next = first;
+
+    // The rings are built so that the outline's area is positive and the holes' are negative.
+    double area = 0.0;
+    for (unsigned int v = first; v <= last; v++)
+    {
+        const SweepVertex& next = m_sweep[m_sweep[v].next];
+        area += double(m_sweep[v].x) * next.y - double(next.x) * m_sweep[v].y;
+    }
+    m_polygonArea += area;
+    return true;
+}
+
+/**
+ * @brief   Whether the sweep line reaches the vertex a before the vertex b: from top to bottom, then from left to right.
+ */
+bool Triangulator::Before(unsigned int a, unsigned int b) const
+{
+    const SweepVertex& p = m_sweep[a];
+    const SweepVertex& q = m_sweep[b];
+    if (p.y != q.y)
+    {
+        return p.y < q.y;
+    }
+    if (p.x != q.x)
+    {
+        return p.x < q.x;
+    }
+    return a < b;
+}
+
+/**
+ * @brief   Twice the signed area of a triangle of sweep vertices, negative when it turns the way the rings are built.
+ */
+double Triangulator::SweepArea(unsigned int p, unsigned int q, unsigned int r) const
+{
+    const SweepVertex& a = m_sweep[p];
+    const SweepVertex& b = m_sweep[q];
+    const SweepVertex& c = m_sweep[r];
+    return (double(b.y) - a.y) * (double(c.x) - b.x) - (double(b.x) - a.x) * (double(c.y) - b.y);
+}
+
+/**
+ * @brief   Where the edge crosses the sweep line.
+ */
+double Triangulator::EdgeX(unsigned int edge) const
+{
+    const SweepVertex& a = m_sweep[edge];
+    const SweepVertex& b = m_sweep[a.next];
+    if (a.y == b.y)
+    {
+        return std::min(a.x, b.x);
+    }
+    return a.x + (m_sweepY - double(a.y)) * (double(b.x) - a.x) / (double(b.y) - a.y);
+}
+
+/**
+ * @brief   Whether the edge a is west of the edge b along the sweep line.
+ *          Edges that cross it at the same point are ordered by where they go below it.
+ */
+bool Triangulator::IsWestOf(unsigned int a, unsigned int b) const
+{
+    const double ax = EdgeX(a);
+    const double bx = EdgeX(b);
+    if (ax != bx)
+    {
+        return ax < bx;
+    }
+
+    auto direction = [this](unsigned int edge)
+    {
+        const SweepVertex& p = m_sweep[edge];
+        const SweepVertex& q = m_sweep[p.next];
+        return Before(edge, p.next) ? ImVec2(q.x - p.x, q.y - p.y) : ImVec2(p.x - q.x, p.y - q.y);
+    };
+    const ImVec2 da = direction(a);
+    const ImVec2 db = direction(b);
+    const double cross = double(da.x) * db.y - double(db.x) * da.y;
+    return cross != 0.0 ? cross < 0.0 : a < b;
+}
+
+/**
+ * @brief   Add an edge to the sweep status.
+ * @param   edge: The edge, by the vertex it starts from.
+ * @param   helper: The last vertex seen between the edge and the next one to its east.
+ */
+void Triangulator::InsertStatus(unsigned int edge, unsigned int helper)
+{
+    SweepVertex& vertex = m_sweep[edge];
+    vertex.helper = helper;
+    vertex.west = NONE;
+    vertex.east = NONE;
+
+    // The status is a treap, balanced by a hash of the edge.
+    uint32_t priority = edge * 0x9E3779B9u;
+    priority ^= priority >> 16;
+    priority *= 0x85EBCA6Bu;
+    vertex.priority = priority ^ (priority >> 13);
+
+    unsigned int west;
+    unsigned int east;
+    SplitStatus(m_statusRoot, edge, west, east);
+    m_statusRoot = MergeStatus(MergeStatus(west, edge), east);
+}
+
+/**
+ * @brief   Remove an edge from the sweep status, once the sweep line reaches its bottom vertex.
+ *          Its helper is linked to the vertex if it is a merge vertex.
+ */
+void Triangulator::EndStatus(unsigned int edge, unsigned int vertex)
+{
+    if (m_sweep[m_sweep[edge].helper].merge)
+    {
+        AddDiagonal(vertex, m_sweep[edge].helper);
+    }
+    m_statusRoot = EraseStatus(m_statusRoot, edge);
+}
+
+/**
+ * @brief   Split a subtree of the sweep status into the edges west of an edge and the others.
+ */
+void Triangulator::SplitStatus(unsigned int tree, unsigned int edge, unsigned int& west, unsigned int& east)
+{
+    if (tree == NONE)
+    {
+        west = NONE;
+        east = NONE;
+    }
+    else if (IsWestOf(tree, edge))
+    {
+        SplitStatus(m_sweep[tree].east, edge, m_sweep[tree].east, east);
+        west = tree;
+    }
+    else
+    {
+        SplitStatus(m_sweep[tree].west, edge, west, m_sweep[tree].west);
+        east = tree;
+    }
+}
+
+/**
+ * @brief   Merge two subtrees of the sweep status, every edge of west being west of every edge of east.
+ */
+unsigned int Triangulator::MergeStatus(unsigned int west, unsigned int east)
+{
+    if (west == NONE)
+    {
+        return east;
+    }
+    if (east == NONE)
+    {
+        return west;
+    }
+    if (m_sweep[west].priority > m_sweep[east].priority)
+    {
+        m_sweep[west].east = MergeStatus(m_sweep[west].east, east);
+        return west;
+    }
+    m_sweep[east].west = MergeStatus(west, m_sweep[east].west);
+    return east;
+}
+
+/**
+ * @brief   Remove an edge from a subtree of the sweep status.
+ * @retval  The new root of the subtree.
+ */
+unsigned int Triangulator::EraseStatus(unsigned int tree, unsigned int edge)
+{
+    if (tree == NONE)
+    {
+        // The edges crossed each other.
+        m_statusError = true;
+        return NONE;
+    }
+    if (tree == edge)
+    {
+        return MergeStatus(m_sweep[tree].west, m_sweep[tree].east);
+    }
+    if (IsWestOf(edge, tree))
+    {
+        m_sweep[tree].west = EraseStatus(m_sweep[tree].west, edge);
+    }
+    else
+    {
+        m_sweep[tree].east = EraseStatus(m_sweep[tree].east, edge);
+    }
+    return tree;
+}
+
+/**
+ * @brief   Find the edge of the sweep status directly west of the current vertex.
+ * @retval  The edge, NONE if there is none.
+ */
+unsigned int Triangulator::FindWestEdge() const
+{
+    unsigned int west = NONE;
+    unsigned int tree = m_statusRoot;
+    while (tree != NONE)
+    {
+        if (EdgeX(tree) < m_sweepX)
+        {
+            west = tree;
+            tree = m_sweep[tree].east;
+        }
+        else
+        {
+            tree = m_sweep[tree].west;
+        }
+    }
+    return west;
+}
+
+void Triangulator::AddDiagonal(unsigned int a, unsigned int b)
+{
+    m_diagonals.emplace_back(a, b);
+}
+
+/**
+ * @brief   Walk the monotone pieces bounded by the rings and the diagonals, and triangulate each of them.
+ * @retval  False if the pieces don't cover the polygon exactly.
+ */
+bool Triangulator::TriangulatePieces()
+{
+    // List the neighbours of every vertex: the ring's first, then the diagonals.
+    const unsigned int vertexCount = (unsigned int)m_sweep.size();
+    m_adjacencyStart.assign(vertexCount + 1, 2);
+    for (const auto& diagonal : m_diagonals)
+    {
+        m_adjacencyStart[diagonal.first]++;
+        m_adjacencyStart[diagonal.second]++;
+    }
+    unsigned int offset = 0;
+    for (unsigned int v = 0; v <= vertexCount; v++)
+    {
+        const unsigned int degree = m_adjacencyStart[v];
+        m_adjacencyStart[v] = offset;
+        offset += degree;
+    }
+    m_adjacency.resize(m_adjacencyStart[vertexCount]);
+    for (unsigned int v = 0; v < vertexCount; v++)
+    {
+        m_adjacency[m_adjacencyStart[v]] = m_sweep[v].prev;
+        m_adjacency[m_adjacencyStart[v] + 1] = m_sweep[v].next;
+        // The helpers are not needed anymore, they hold where the next diagonal of the vertex goes.
+        m_sweep[v].helper = m_adjacencyStart[v] + 2;
+    }
+    for (const auto& diagonal : m_diagonals)
+    {
+        m_adjacency[m_sweep[diagonal.first].helper++] = diagonal.second;
+        m_adjacency[m_sweep[diagonal.second].helper++] = diagonal.first;
+    }
+
+    // Around the vertices with diagonals, the neighbours are sorted counterclockwise.
+    for (unsigned int v = 0; v < vertexCount; v++)
+    {
+        if (m_adjacencyStart[v + 1] - m_adjacencyStart[v] > 2)
+        {
+            std::sort(m_adjacency.begin() + m_adjacencyStart[v], m_adjacency.begin() + m_adjacencyStart[v + 1],
+                      [this, v](unsigned int a, unsigned int b)
+                      {
+                          return IsCounterclockwise(v, a, b);
+                      });
+        }
+    }
+
+    // Every edge is walked once, with the inside of the piece on the same side as the inside of the rings.
+    m_triangleArea = 0.0;
+    m_walked.assign(m_adjacency.size(), 0);
+    for (unsigned int v = 0; v < vertexCount; v++)
+    {
+        for (unsigned int edge = m_adjacencyStart[v]; edge < m_adjacencyStart[v + 1]; edge++)
+        {
+            if (m_walked[edge] != 0 || m_adjacency[edge] == m_sweep[v].prev)
+            {
+                continue;
+            }
+
+            m_piece.clear();
+            unsigned int from = v;
+            unsigned int current = edge;
+            do
+            {
+                if (m_walked[current] != 0)
+                {
+                    return false;
+                }
+                m_walked[current] = 1;
+                m_piece.push_back(from);
+
+                const unsigned int to = m_adjacency[current];
+                current = NextPieceEdge(to, from);
+                from = to;
+                if (current == NONE)
+                {
+                    return false;
+                }
+            } while (current != edge);
+
+            if (m_piece.size() < 3)
+            {
+                return false;
+            }
+            TriangulateMonotone();
+        }
+    }
+
+    // Overlapping or missing pieces mean the rings were not a valid polygon.
+    return std::abs(m_triangleArea - m_polygonArea) <= m_polygonArea * 1e-6;
+}
+
+/**
+ * @brief   Whether the direction from v to a comes before the direction from v to b, counterclockwise from the east.
+ */
+bool Triangulator::IsCounterclockwise(unsigned int v, unsigned int a, unsigned int b) const
+{
+    const double ax = double(m_sweep[a].x) - m_sweep[v].x;
+    const double ay = double(m_sweep[a].y) - m_sweep[v].y;
+    const double bx = double(m_sweep[b].x) - m_sweep[v].x;
+    const double by = double(m_sweep[b].y) - m_sweep[v].y;
+    const bool aLower = ay < 0.0 || (ay == 0.0 && ax < 0.0);
+    const bool bLower = by < 0.0 || (by == 0.0 && bx < 0.0);
+    if (aLower != bLower)
+    {
+        return bLower;
+    }
+    return ax * by - ay * bx > 0.0;
+}
+
+/**
+ * @brief   Find the edge that follows the edge from `from` to v around the piece being walked:
+ *          the first one clockwise from it.
+ * @retval  The edge, NONE if it leaves the polygon.
+ */
+unsigned int Triangulator::NextPieceEdge(unsigned int v, unsigned int from) const
+{
+    const unsigned int first = m_adjacencyStart[v];
+    const unsigned int end = m_adjacencyStart[v + 1];
+    unsigned int next = NONE;
+    if (end - first == 2)
+    {
+        next = m_adjacency[first] == from ? first + 1 : NONE;
+    }
+    else
+    {
+        auto begin = m_adjacency.begin() + first;
+        auto found = std::lower_bound(begin, m_adjacency.begin() + end, from, [this, v](unsigned int a, unsigned int b)
+                                      {
+                                          return IsCounterclockwise(v, a, b);
+                                      });
+        unsigned int index = (unsigned int)(found - m_adjacency.begin());
+        if (index == end || m_adjacency[index] != from)
+        {
+            // Neighbours in the same direction.
+            index = (unsigned int)(std::find(begin, m_adjacency.begin() + end, from) - m_adjacency.begin());
+        }
+        if (index < end)
+        {
+            next = index == first ? end - 1 : index - 1;
+        }
+    }
+
+    if (next == NONE || m_adjacency[next] == m_sweep[v].prev)
+    {
+        return NONE;
+    }
+    return next;
+}
+
+/**
+ * @brief   Triangulate the monotone piece in m_piece, from top to bottom, with a stack of the vertices left to link.
+ */
+void Triangulator::TriangulateMonotone()
+{
+    const size_t count = m_piece.size();
+    size_t top = 0;
+    size_t bottom = 0;
+    for (size_t k = 1; k < count; k++)
+    {
+        top = Before(m_piece[k], m_piece[top]) ? k : top;
+        bottom = Before(m_piece[bottom], m_piece[k]) ? k : bottom;
+    }
+
+    // Merge the chain that follows the piece from top to bottom with the one that goes back.
+    m_chain.clear();
+    m_chain.emplace_back(m_piece[top], true);
+    size_t forward = (top + 1) % count;
+    size_t backward = (top + count - 1) % count;
+    while (forward != bottom || backward != bottom)
+    {
+        if (forward != bottom && (backward == bottom || Before(m_piece[forward], m_piece[backward])))
+        {
+            m_chain.emplace_back(m_piece[forward], true);
+            forward = (forward + 1) % count;
+        }
+        else
+        {
+            m_chain.emplace_back(m_piece[backward], false);
+            backward = (backward + count - 1) % count;
+        }
+    }
+    m_chain.emplace_back(m_piece[bottom], true);
+
+    m_stack.clear();
+    m_stack.push_back(m_chain[0]);
+    m_stack.push_back(m_chain[1]);
+    for (size_t k = 2; k + 1 < count; k++)
+    {
+        const std::pair<unsigned int, bool> vertex = m_chain[k];
+        if (vertex.second != m_stack.back().second)
+        {
+            // Opposite chain: every vertex on the stack can be linked to the vertex.
+            for (size_t s = 0; s + 1 < m_stack.size(); s++)
+            {
+                AddSweepTriangle(vertex.first, m_stack[s].first, m_stack[s + 1].first);
+            }
+            m_stack.clear();
+            m_stack.push_back(m_chain[k - 1]);
+            m_stack.push_back(vertex);
+        }
+        else
+        {
+            // Same chain: link the vertex to the stack as long as the diagonals stay inside.
+            std::pair<unsigned int, bool> last = m_stack.back();
+            m_stack.pop_back();
+            while (m_stack.empty() == false)
+            {
+                const unsigned int previous = m_stack.back().first;
+                const double area = vertex.second ? SweepArea(previous, last.first, vertex.first)
+                                                  : SweepArea(vertex.first, last.first, previous);
+                if (area >= 0.0)
+                {
+                    break;
+                }
+                AddSweepTriangle(vertex.first, last.first, previous);
+                last = m_stack.back();
+                m_stack.pop_back();
+            }
+            m_stack.push_back(last);
+            m_stack.push_back(vertex);
+        }
+    }
+
+    for (size_t s = 0; s + 1 < m_stack.size(); s++)
+    {
+        AddSweepTriangle(m_chain.back().first, m_stack[s].first, m_stack[s + 1].first);
+    }
+}
+
+/**
+ * @brief   Add a triangle of sweep vertices, turning the way the rings are built.
+ */
+void Triangulator::AddSweepTriangle(unsigned int a, unsigned int b, unsigned int c)
+{
+    const double area = SweepArea(a, b, c);
+    if (area > 0.0)
+    {
+        std::swap(b, c);
+    }
+    m_triangleArea += std::abs(area);
+    m_indices.push_back(m_sweep[a].i);
+    m_indices.push_back(m_sweep[b].i);
+    m_indices.push_back(m_sweep[c].i);
+}
+}
@@ -0,0 +1,182 @@
+// The ear clipping is ported from earcut, https://github.com/mapbox/earcut, under the following license:
+//
+// ISC License
+//
+// Copyright (c) 2016, Mapbox
+//
+// Permission to use, copy, modify, and/or distribute this software for any purpose
+// with or without fee is hereby granted, provided that the above copyright notice
+// and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND ISC DISCLAIMS ALL WARRANTIES WITH REGARD TO
+// THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+// IN NO EVENT SHALL ISC BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+// DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+// WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+// OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+#include "utils/rendering/Meshes.h"
+#include "vendor/imgui/imgui.h"
+#include <memory>
+#include <vector>
+
+namespace Renderer
+{
+
+/**
+ * @class   Triangulator
+ * @brief   Triangulates simple polygons, with or without holes.
+ *          Large polygons are split into y-monotone pieces by a sweep line, which are then triangulated
+ *          along their two chains, in O(n log n) whatever the number of reflex vertices and holes.
+ *          Small polygons, and the ones the sweep rejects, are triangulated by ear clipping, ported from earcut:
+ *          holes are merged into the outline through bridges, and self-intersections and degenerate points
+ *          are handled like earcut does: local intersections are cut off, and polygons that can't be
+ *          clipped are split in two.
+ *
+ *          The nodes are kept between calls, so the same Triangulator can regenerate a
+ *          polygon every frame without allocating once it has seen its largest polygon.
+ */
+class Triangulator
+{
+public:
+    Triangulator() = default;
+    Triangulator(const Triangulator&) = delete;
+    Triangulator& operator=(const Triangulator&) = delete;
+
+    /**
+     * @brief   Triangulate a polygon.
+     * @param   outline: The outer ring, in either winding. The last point must not repeat the first one.
+     * @param   count: The number of points in the outer ring.
+     * @param   holes: The inner rings, in either winding.
+     * @retval  Indices of the vertices of every triangle, 3 per triangle. The outline's points come first,
+     *          followed by the points of every hole, in order. Valid until the next call.
+     */
+    const std::vector<unsigned int>& Triangulate(const ImVec2* outline, size_t count,
+                                                 const std::vector<std::vector<ImVec2>>& holes = {});
+    inline const std::vector<unsigned int>& Triangulate(const std::vector<ImVec2>& outline,
+                                                        const std::vector<std::vector<ImVec2>>& holes = {})
+    {
+        return Triangulate(outline.data(), outline.size(), holes);
+    }
+
+    /**
+     * @brief   Triangulate a polygon into triangles in mesh coordinates,
+     *          the bounding box of the outline being mapped to [0..1] on both axes.
+     * @param   outline: The outer ring.
+     * @param   holes: The inner rings.
+     * @param   color: The color of every triangle.
+     * @param   out: The triangles. Cleared first.
+     */
+    void Triangulate(const std::vector<ImVec2>& outline, const std::vector<std::vector<ImVec2>>& holes,
+                     ImU32 color, std::vector<Triangle>& out);
+
+private:
+    struct Node
+    {
+        unsigned int i;         //!< Index of the vertex in the input.
+        float x;
+        float y;
+        Node* prev;             //!< Previous vertex of the ring.
+        Node* next;             //!< Next vertex of the ring.
+        int32_t z;              //!< Position on the z-order curve.
+        Node* prevZ;            //!< Previous node in z-order.
+        Node* nextZ;            //!< Next node in z-order.
+        bool steiner;           //!< Set for a hole made of a single point.
+    };
+
+    struct SweepVertex
+    {
+        unsigned int i;         //!< Index of the vertex in the input.
+        float x;
+        float y;
+        unsigned int prev;      //!< Previous vertex of the ring.
+        unsigned int next;      //!< Next vertex of the ring.
+        bool merge;             //!< Set for a vertex with both neighbours above it and the inside below.
+        // The edge to the next vertex, in the sweep status.
+        unsigned int helper;    //!< Lowest vertex seen between the edge and the next one to its east.
+        unsigned int west;      //!< Subtree of the edges west of this one.
+        unsigned int east;      //!< Subtree of the edges east of this one.
+        uint32_t priority;
+    };
+
+    static constexpr unsigned int NONE = ~0u;
+    static constexpr size_t BLOCK_SIZE = 1024;
+    static constexpr size_t HASH_THRESHOLD = 80;    //!< Below this many points, ears are checked against every vertex.
+
+    Node* NewNode(unsigned int i, float x, float y);
+    Node* InsertNode(unsigned int i, float x, float y, Node* last);
+    static void RemoveNode(Node* p);
+    Node* LinkedList(const ImVec2* points, size_t count, unsigned int first, bool clockwise);
+    Node* FilterPoints(Node* start, Node* end = nullptr);
+    void EarcutLinked(Node* ear, int pass);
+    bool IsEar(Node* ear) const;
+    bool IsEarHashed(Node* ear) const;
+    Node* CureLocalIntersections(Node* start);
+    void SplitEarcut(Node* start);
+    Node* EliminateHoles(const std::vector<std::vector<ImVec2>>& holes, unsigned int first, Node* outerNode);
+    Node* EliminateHole(Node* hole, Node* outerNode);
+    static Node* FindHoleBridge(Node* hole, Node* outerNode);
+    void IndexCurve(Node* start) const;
+    static Node* SortLinked(Node* list);
+    int32_t ZOrder(float x, float y) const;
+    Node* SplitPolygon(Node* a, Node* b);
+    void AddTriangle(const Node* a, const Node* b, const Node* c);
+
+    bool SweepTriangulate(Node* outerNode, const std::vector<std::vector<ImVec2>>& holes, unsigned int first);
+    bool AddSweepRing(Node* start);
+    bool Before(unsigned int a, unsigned int b) const;
+    double SweepArea(unsigned int p, unsigned int q, unsigned int r) const;
+    double EdgeX(unsigned int edge) const;
+    bool IsWestOf(unsigned int a, unsigned int b) const;
+    void InsertStatus(unsigned int edge, unsigned int helper);
+    void EndStatus(unsigned int edge, unsigned int vertex);
+    void SplitStatus(unsigned int tree, unsigned int edge, unsigned int& west, unsigned int& east);
+    unsigned int MergeStatus(unsigned int west, unsigned int east);
+    unsigned int EraseStatus(unsigned int tree, unsigned int edge);
+    unsigned int FindWestEdge() const;
+    void AddDiagonal(unsigned int a, unsigned int b);
+    bool TriangulatePieces();
+    bool IsCounterclockwise(unsigned int v, unsigned int a, unsigned int b) const;
+    unsigned int NextPieceEdge(unsigned int v, unsigned int from) const;
+    void TriangulateMonotone();
+    void AddSweepTriangle(unsigned int a, unsigned int b, unsigned int c);
+
+    static float Area(const Node* p, const Node* q, const Node* r);
+    static bool Equals(const Node* a, const Node* b);
+    static bool PointInTriangle(float ax, float ay, float bx, float by, float cx, float cy, float px, float py);
+    static bool Intersects(const Node* p1, const Node* q1, const Node* p2, const Node* q2);
+    static bool IntersectsPolygon(const Node* a, const Node* b);
+    static bool LocallyInside(const Node* a, const Node* b);
+    static bool MiddleInside(const Node* a, const Node* b);
+    static bool IsValidDiagonal(const Node* a, const Node* b);
+    static bool SectorContainsSector(const Node* m, const Node* p);
+
+private:
+    std::vector<std::unique_ptr<Node[]>> m_blocks = std::vector<std::unique_ptr<Node[]>>(); //!< Node pool, kept between calls.
+    size_t m_usedNodes = 0;
+    std::vector<unsigned int> m_indices = std::vector<unsigned int>();
+    std::vector<Node*> m_holeQueue = std::vector<Node*>();
+    std::vector<ImVec2> m_points = std::vector<ImVec2>();   //!< Scratch, every input point in index order.
+    float m_minX = 0.0f;
+    float m_minY = 0.0f;
+    float m_invSize = 0.0f;                                 //!< Scale of the z-order curve, 0 when it isn't used.
+
+    // Monotone decomposition, see SweepTriangulate.
+    std::vector<SweepVertex> m_sweep = std::vector<SweepVertex>();
+    std::vector<unsigned int> m_sweepOrder = std::vector<unsigned int>();
+    std::vector<std::pair<unsigned int, unsigned int>> m_diagonals = std::vector<std::pair<unsigned int, unsigned int>>();
+    std::vector<unsigned int> m_adjacencyStart = std::vector<unsigned int>();   //!< Where the neighbours of every vertex start.
+    std::vector<unsigned int> m_adjacency = std::vector<unsigned int>();        //!< Neighbours through the rings and the diagonals.
+    std::vector<uint8_t> m_walked = std::vector<uint8_t>();                     //!< Set for every neighbour already walked to.
+    std::vector<unsigned int> m_piece = std::vector<unsigned int>();
+    std::vector<std::pair<unsigned int, bool>> m_chain = std::vector<std::pair<unsigned int, bool>>();  //!< Set on the forward chain.
+    std::vector<std::pair<unsigned int, bool>> m_stack = std::vector<std::pair<unsigned int, bool>>();
+    unsigned int m_statusRoot = NONE;
+    bool m_statusError = false;
+    double m_sweepX = 0.0;
+    double m_sweepY = 0.0;
+    double m_polygonArea = 0.0;                             //!< Twice the area of the rings.
+    double m_triangleArea = 0.0;                            //!< Twice the area of the triangles of the pieces.
+};
+}
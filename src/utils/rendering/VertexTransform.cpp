@@ -0,0 +1,306 @@
+#include "VertexTransform.h"
+#include "utils/JobSystem.h"
+#include <chrono>
+#include <random>
+#include <string.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define VERTEX_TRANSFORM_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC lets any function use any intrinsic.
+#define TARGET(isa)
+#elif defined(__clang__)
+#define TARGET(isa) __attribute__((target(isa)))
+#else
+// GCC enables FMA along with AVX-512 and would fuse the multiplies and adds,
+// which changes the rounding compared to the scalar code.
+#define TARGET(isa) __attribute__((target(isa), optimize("fp-contract=off")))
+#endif
+#endif
+
+namespace Renderer::VertexTransform
+{
+typedef void (*KernelFunc)(const Transform& transform, const ImVec2* in, ImVec2* out, size_t count);
+
+static void ApplyScalar(const Transform& transform, const ImVec2* in, ImVec2* out, size_t count);
+#ifdef VERTEX_TRANSFORM_X86
+static void ApplySse2(const Transform& transform, const ImVec2* in, ImVec2* out, size_t count);
+static void ApplyAvx2(const Transform& transform, const ImVec2* in, ImVec2* out, size_t count);
+static void ApplyAvx512(const Transform& transform, const ImVec2* in, ImVec2* out, size_t count);
+#endif
+static KernelFunc GetKernel(InstructionSetEnum_t set);
+static unsigned int UlpDistance(float a, float b);
+
+
+void Apply(const Transform& transform, const ImVec2* in, ImVec2* out, size_t count)
+{
+    static const KernelFunc kernel = GetKernel(GetBestInstructionSet());
+    if ( count == 0 )
+    {
+        return;
+    }
+    if ( count < PARALLEL_VERTEX_COUNT )
+    {
+        kernel(transform, in, out, count);
+        return;
+    }
+    // Large meshes are split in ranges transformed as jobs, the points are independent.
+    Jobs::ParallelFor(count, PARALLEL_VERTEX_COUNT / 2, [&](size_t begin, size_t end)
+                      {
+                          kernel(transform, in + begin, out + begin, end - begin);
+                      });
+}
+
+void Apply(InstructionSetEnum_t set, const Transform& transform, const ImVec2* in, ImVec2* out, size_t count)
+{
+    if ( count == 0 )
+    {
+        return;
+    }
+    GetKernel(set)(transform, in, out, count);
+}
+
+bool IsSupported(InstructionSetEnum_t set)
+{
+    if ( set == INSTRUCTION_SET_SCALAR )
+    {
+        return true;
+    }
+#ifdef VERTEX_TRANSFORM_X86
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool hasSse2 = (info[3] & (1 << 26)) != 0;
+    const bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+    // The OS must save the YMM (and ZMM) registers on context switches for AVX to be usable.
+    const unsigned long long xcr0 = hasOsxsave ? _xgetbv(0) : 0;
+    bool hasAvx2 = false;
+    bool hasAvx512 = false;
+    if ( maxLeaf >= 7 )
+    {
+        __cpuidex(info, 7, 0);
+        hasAvx2 = ((info[1] & (1 << 5)) != 0) && ((xcr0 & 0x06) == 0x06);
+        hasAvx512 = ((info[1] & (1 << 16)) != 0) && ((xcr0 & 0xE6) == 0xE6);
+    }
+#else
+    const bool hasSse2 = __builtin_cpu_supports("sse2");
+    const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    const bool hasAvx512 = __builtin_cpu_supports("avx512f");
+#endif
+    switch ( set )
+    {
+        case INSTRUCTION_SET_SSE2:
+            return hasSse2;
+        case INSTRUCTION_SET_AVX2:
+            return hasAvx2;
+        case INSTRUCTION_SET_AVX512:
+            return hasAvx512;
+        default:
+            return false;
+    }
+#else
+    return false;
+#endif
+}
+
+InstructionSetEnum_t GetBestInstructionSet(void)
+{
+    for ( int set = INSTRUCTION_SET_COUNT - 1; set > INSTRUCTION_SET_SCALAR; set-- )
+    {
+        if ( IsSupported(InstructionSetEnum_t(set)) == true )
+        {
+            return InstructionSetEnum_t(set);
+        }
+    }
+    return INSTRUCTION_SET_SCALAR;
+}
+
+const char* GetInstructionSetName(InstructionSetEnum_t set)
+{
+    static const char* names[] = { "Scalar", "SSE2", "AVX2", "AVX-512" };
+    return set < INSTRUCTION_SET_COUNT ? names[set] : "Unknown";
+}
+
+std::vector<BenchmarkResult> Benchmark(size_t vertexCount, int iterations)
+{
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> dist(-1.0f, 2.0f);
+    std::vector<ImVec2> in(vertexCount);
+    for ( ImVec2& p : in )
+    {
+        p = ImVec2(dist(rng), dist(rng));
+    }
+    Transform transform = Transform::FromMesh(ImVec2(960.0f, 540.0f), ImVec2(300.0f, 200.0f),
+                                              ImVec2(0.5f, 0.5f), 37.5f);
+
+    std::vector<ImVec2> reference(vertexCount);
+    ApplyScalar(transform, in.data(), reference.data(), vertexCount);
+
+    std::vector<BenchmarkResult> results;
+    std::vector<ImVec2> out(vertexCount);
+    for ( int set = INSTRUCTION_SET_SCALAR; set < INSTRUCTION_SET_COUNT; set++ )
+    {
+        if ( IsSupported(InstructionSetEnum_t(set)) == false )
+        {
+            continue;
+        }
+        KernelFunc kernel = GetKernel(InstructionSetEnum_t(set));
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for ( int i = 0; i < iterations; i++ )
+        {
+            kernel(transform, in.data(), out.data(), vertexCount);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        BenchmarkResult result;
+        result.set = InstructionSetEnum_t(set);
+        result.nsPerVertex = std::chrono::duration<double, std::nano>(end - start).count() /
+            (double(vertexCount) * double(iterations));
+        for ( size_t i = 0; i < vertexCount; i++ )
+        {
+            unsigned int ulpX = UlpDistance(out[i].x, reference[i].x);
+            unsigned int ulpY = UlpDistance(out[i].y, reference[i].y);
+            result.maxUlpError = ulpX > result.maxUlpError ? ulpX : result.maxUlpError;
+            result.maxUlpError = ulpY > result.maxUlpError ? ulpY : result.maxUlpError;
+        }
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+/**
+ * The SIMD kernels work directly on the interleaved (x, y) pairs:
+ *      out = (x, y) * (A, D) + (y, x) * (B, C) + (Tx, Ty)
+ * Which is the same as the scalar ((A * x) + (B * y)) + Tx for x and ((C * x) + (D * y)) + Ty for y.
+ * Swapping the pairs stays within 128-bit lanes, so the same kernel works for every register width.
+ */
+static void ApplyScalar(const Transform& transform, const ImVec2* in, ImVec2* out, size_t count)
+{
+    transform.Apply(in, out, count);
+}
+
+#ifdef VERTEX_TRANSFORM_X86
+TARGET("sse2")
+static void ApplySse2(const Transform& transform, const ImVec2* in, ImVec2* out, size_t count)
+{
+    const __m128 ad = _mm_setr_ps(transform.A(), transform.D(), transform.A(), transform.D());
+    const __m128 bc = _mm_setr_ps(transform.B(), transform.C(), transform.B(), transform.C());
+    const __m128 t = _mm_setr_ps(transform.Tx(), transform.Ty(), transform.Tx(), transform.Ty());
+    const float* src = &in[0].x;
+    float* dst = &out[0].x;
+
+    size_t i = 0;
+    // 4 vertices per iteration.
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        __m128 v0 = _mm_loadu_ps(src + (i * 2));
+        __m128 v1 = _mm_loadu_ps(src + (i * 2) + 4);
+        __m128 s0 = _mm_shuffle_ps(v0, v0, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 s1 = _mm_shuffle_ps(v1, v1, _MM_SHUFFLE(2, 3, 0, 1));
+        v0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(v0, ad), _mm_mul_ps(s0, bc)), t);
+        v1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(v1, ad), _mm_mul_ps(s1, bc)), t);
+        _mm_storeu_ps(dst + (i * 2), v0);
+        _mm_storeu_ps(dst + (i * 2) + 4, v1);
+    }
+    transform.Apply(in + i, out + i, count - i);
+}
+
+TARGET("avx2")
+static void ApplyAvx2(const Transform& transform, const ImVec2* in, ImVec2* out, size_t count)
+{
+    const __m256 ad = _mm256_setr_ps(transform.A(), transform.D(), transform.A(), transform.D(),
+                                     transform.A(), transform.D(), transform.A(), transform.D());
+    const __m256 bc = _mm256_setr_ps(transform.B(), transform.C(), transform.B(), transform.C(),
+                                     transform.B(), transform.C(), transform.B(), transform.C());
+    const __m256 t = _mm256_setr_ps(transform.Tx(), transform.Ty(), transform.Tx(), transform.Ty(),
+                                    transform.Tx(), transform.Ty(), transform.Tx(), transform.Ty());
+    const float* src = &in[0].x;
+    float* dst = &out[0].x;
+
+    size_t i = 0;
+    // 8 vertices per iteration.
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        __m256 v0 = _mm256_loadu_ps(src + (i * 2));
+        __m256 v1 = _mm256_loadu_ps(src + (i * 2) + 8);
+        __m256 s0 = _mm256_permute_ps(v0, _MM_SHUFFLE(2, 3, 0, 1));
+        __m256 s1 = _mm256_permute_ps(v1, _MM_SHUFFLE(2, 3, 0, 1));
+        // No FMA here, the rounding must stay the same as the scalar code.
+        v0 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(v0, ad), _mm256_mul_ps(s0, bc)), t);
+        v1 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(v1, ad), _mm256_mul_ps(s1, bc)), t);
+        _mm256_storeu_ps(dst + (i * 2), v0);
+        _mm256_storeu_ps(dst + (i * 2) + 8, v1);
+    }
+    ApplySse2(transform, in + i, out + i, count - i);
+}
+
+TARGET("avx512f")
+static void ApplyAvx512(const Transform& transform, const ImVec2* in, ImVec2* out, size_t count)
+{
+    const __m512 ad = _mm512_setr_ps(transform.A(), transform.D(), transform.A(), transform.D(),
+                                     transform.A(), transform.D(), transform.A(), transform.D(),
+                                     transform.A(), transform.D(), transform.A(), transform.D(),
+                                     transform.A(), transform.D(), transform.A(), transform.D());
+    const __m512 bc = _mm512_setr_ps(transform.B(), transform.C(), transform.B(), transform.C(),
+                                     transform.B(), transform.C(), transform.B(), transform.C(),
+                                     transform.B(), transform.C(), transform.B(), transform.C(),
+                                     transform.B(), transform.C(), transform.B(), transform.C());
+    const __m512 t = _mm512_setr_ps(transform.Tx(), transform.Ty(), transform.Tx(), transform.Ty(),
+                                    transform.Tx(), transform.Ty(), transform.Tx(), transform.Ty(),
+                                    transform.Tx(), transform.Ty(), transform.Tx(), transform.Ty(),
+                                    transform.Tx(), transform.Ty(), transform.Tx(), transform.Ty());
+    const float* src = &in[0].x;
+    float* dst = &out[0].x;
+
+    size_t i = 0;
+    // 16 vertices per iteration.
+    for ( ; i + 16 <= count; i += 16 )
+    {
+        __m512 v0 = _mm512_loadu_ps(src + (i * 2));
+        __m512 v1 = _mm512_loadu_ps(src + (i * 2) + 16);
+        __m512 s0 = _mm512_permute_ps(v0, _MM_SHUFFLE(2, 3, 0, 1));
+        __m512 s1 = _mm512_permute_ps(v1, _MM_SHUFFLE(2, 3, 0, 1));
+        v0 = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(v0, ad), _mm512_mul_ps(s0, bc)), t);
+        v1 = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(v1, ad), _mm512_mul_ps(s1, bc)), t);
+        _mm512_storeu_ps(dst + (i * 2), v0);
+        _mm512_storeu_ps(dst + (i * 2) + 16, v1);
+    }
+    ApplySse2(transform, in + i, out + i, count - i);
+}
+#endif
+
+static KernelFunc GetKernel(InstructionSetEnum_t set)
+{
+    switch ( set )
+    {
+#ifdef VERTEX_TRANSFORM_X86
+        case INSTRUCTION_SET_SSE2:
+            return ApplySse2;
+        case INSTRUCTION_SET_AVX2:
+            return ApplyAvx2;
+        case INSTRUCTION_SET_AVX512:
+            return ApplyAvx512;
+#endif
+        default:
+            return ApplyScalar;
+    }
+}
+
+static unsigned int UlpDistance(float a, float b)
+{
+    // Map the floats to integers that are ordered the same way, then subtract.
+    int ia;
+    int ib;
+    memcpy(&ia, &a, sizeof(float));
+    memcpy(&ib, &b, sizeof(float));
+    ia = ia < 0 ? int(0x80000000u - (unsigned int)ia) : ia;
+    ib = ib < 0 ? int(0x80000000u - (unsigned int)ib) : ib;
+    return ia > ib ? (unsigned int)ia - (unsigned int)ib : (unsigned int)ib - (unsigned int)ia;
+}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "utils/rendering/Transform.h"
+#include "vendor/imgui/imgui.h"
+#include <vector>
+
+/**
+ * Vectorized mesh-to-screen transform.
+ * The widest instruction set supported by the CPU is picked the first time Apply is called,
+ * falling back to the scalar Transform::Apply when no SIMD extension is available.
+ * Every variant does the same operations in the same order as the scalar code,
+ * so the results are identical to it.
+ * Meshes of PARALLEL_VERTEX_COUNT vertices or more are transformed in parallel on the job system.
+ */
+namespace Renderer::VertexTransform
+{
+static constexpr size_t PARALLEL_VERTEX_COUNT = 16384;  //!< Vertices from which Apply splits the work in jobs.
+
+typedef enum
+{
+    INSTRUCTION_SET_SCALAR = 0,
+    INSTRUCTION_SET_SSE2,
+    INSTRUCTION_SET_AVX2,
+    INSTRUCTION_SET_AVX512,
+    INSTRUCTION_SET_COUNT,
+}InstructionSetEnum_t;
+
+struct BenchmarkResult
+{
+    InstructionSetEnum_t set = INSTRUCTION_SET_SCALAR;
+    double nsPerVertex = 0.0;       //!< Average time to transform one vertex, in nanoseconds.
+    unsigned int maxUlpError = 0;   //!< Largest difference with the scalar reference, in units in the last place.
+};
+
+/**
+ * @brief   Transform count points from mesh coordinates to screen coordinates
+ *          using the widest instruction set supported by the CPU.
+ * @param   transform: The transform to apply.
+ * @param   in: The points to transform.
+ * @param   out: Where to write the transformed points. Can be the same as in.
+ * @param   count: The number of points.
+ */
+void Apply(const Transform& transform, const ImVec2* in, ImVec2* out, size_t count);
+
+/**
+ * @brief   Same as Apply, but with a specific instruction set.
+ *          The instruction set must be supported by the CPU, see IsSupported.
+ */
+void Apply(InstructionSetEnum_t set, const Transform& transform, const ImVec2* in, ImVec2* out, size_t count);
+
+bool IsSupported(InstructionSetEnum_t set);
+InstructionSetEnum_t GetBestInstructionSet(void);
+const char* GetInstructionSetName(InstructionSetEnum_t set);
+
+/**
+ * @brief   Time every supported variant on vertexCount random vertices and
+ *          compare their output with the scalar reference.
+ * @param   vertexCount: Number of vertices to transform per iteration.
+ * @param   iterations: Number of times each variant transforms the vertices.
+ * @retval  One result per supported instruction set.
+ */
+std::vector<BenchmarkResult> Benchmark(size_t vertexCount, int iterations);
+}
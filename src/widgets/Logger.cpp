@@ -2,14 +2,18 @@
 #include "Application.h"
 #include "utils/Config.h"
 #include "utils/Fonts.h"
+#include "utils/JobSystem.h"
 #include "widgets/MainMenu.h"
 #include <iostream>
+#include <iterator>
 #include <stdexcept>
 
 
 Logger logger;
 
 static Logging::LogLevelEnum_t logLevel = Logging::LOG_LEVEL_DEBUG;
+static std::mutex postMutex;
+static Jobs::JobHandle lastPost;    // Every log job waits for the previous one, to keep the lines in order.
 static bool isReadyToGoDownToFlavortown = false;
 static int hitCount = 0;
 static double timeElapsed = 0;
@@ -40,6 +44,9 @@ Logger::~Logger(void)
 
 void Logger::Clear(void)
 {
+    std::unique_lock<std::mutex> lock(m_BufMutex);
+    m_Pending.clear();
+    lock.unlock();
     m_Buf.clear();
     m_LineOffsets.clear();
     m_LineOffsets.push_back(0);
@@ -47,15 +54,25 @@ void Logger::Clear(void)
 
 void Logger::AddLog(const char* fmt)
 {
-    m_Buf.push_back(fmt);
-    if ( m_AutoScroll == true )
-    {
-        m_ScrollToBottom = true;
-    }
+    std::lock_guard<std::mutex> lock(m_BufMutex);
+    m_Pending.push_back(fmt);
 }
 
 void Logger::Draw(const char* title)
 {
+    // Only the new lines are taken under the lock, the log jobs never wait for the rendering.
+    std::vector<std::string> added;
+    std::unique_lock<std::mutex> lock(m_BufMutex);
+    added.swap(m_Pending);
+    lock.unlock();
+    if ( added.empty() == false )
+    {
+        m_Buf.insert(m_Buf.end(), std::make_move_iterator(added.begin()), std::make_move_iterator(added.end()));
+        if ( m_AutoScroll == true )
+        {
+            m_ScrollToBottom = true;
+        }
+    }
 
     if ( m_Open == false )
     {
@@ -174,62 +191,37 @@ void Logging::SetLogLevel(LogLevelEnum_t level)
     logLevel = level;
 }
 
-namespace Logging
+bool Logging::IsEnabled(LogLevelEnum_t level)
 {
-    LogSource System("[SYSTEM     ]");
-    LogSource TestBench("[TEST_BENCH ]");
-    LogSource Interpreter("[INTERPRETER]");
-
-    void Logging::Debug(const std::string& fmt)
-    {
-        if ( logLevel > LOG_LEVEL_DEBUG )
-        {
-            return;
-        }
-
-        logger.AddLog(fmt.c_str());
-    }
-
-    void Logging::Info(const std::string& fmt)
-    {
-        if ( logLevel > LOG_LEVEL_INFO )
-        {
-            return;
-        }
-
-        logger.AddLog(fmt.c_str());
-    }
-
-    void Logging::Warning(const std::string& fmt)
-    {
-        if ( logLevel > LOG_LEVEL_WARNING )
-        {
-            return;
-        }
-
-        logger.AddLog(fmt.c_str());
-    }
+    return level >= logLevel;
+}
 
-    void Logging::Error(const std::string& fmt)
+void Logging::Post(LogLevelEnum_t level, const std::string& source, std::string msg)
+{
+    static const char* const tags[] = { "[DEBUG   ] ", "[INFO    ] ", "[WARNING ] ", "[ERROR   ] ", "[CRITICAL] " };
+    if ( IsEnabled(level) == false || level >= LOG_LEVEL_NONE )
     {
-        if ( logLevel > LOG_LEVEL_ERROR )
-        {
-            return;
-        }
-
-        logger.AddLog(fmt.c_str());
+        return;
     }
 
-    void Logging::Critical(const std::string& fmt)
-    {
-        if ( logLevel > LOG_LEVEL_CRITICAL )
-        {
-            return;
-        }
-
-        logger.AddLog(fmt.c_str());
-    }
+    // Stamped with the time it was posted at, not the time the job runs.
+    const time_t now = time(0);
+    std::lock_guard<std::mutex> lock(postMutex);
+    lastPost = Jobs::Submit([now, level, source, msg = std::move(msg)]()
+                            {
+                                std::ostringstream line;
+                                line << StringUtils::GetTimeFormated(now) << source
+                                    << tags[level]
+                                    << msg << "\n\r";
+                                logger.AddLog(line.str().c_str());
+                            }, { lastPost });
+}
 
+namespace Logging
+{
+    LogSource System("[SYSTEM     ]");
+    LogSource TestBench("[TEST_BENCH ]");
+    LogSource Interpreter("[INTERPRETER]");
 }
 
 void RenderColoredText(const std::string& msg)
@@ -3,6 +3,7 @@
 #include "imgui/imgui.h"
 #include "utils/StringUtils.h"
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <vector>
 
@@ -22,7 +23,9 @@ public:
     }
 
 private:
-    std::vector<std::string> m_Buf;
+    std::mutex      m_BufMutex;     // Guards m_Pending, lines are added by the log jobs, from any thread.
+    std::vector<std::string> m_Pending; // Lines added since the last frame, taken by Draw.
+    std::vector<std::string> m_Buf;     // Lines taken, only used by the UI thread.
     ImGuiTextFilter m_Filter;
     ImVector<int>   m_LineOffsets;  // Index to lines offset.
     bool            m_AutoScroll;
@@ -48,11 +51,12 @@ namespace Logging
     void OpenConsole(void);
     void SetLogLevel(LogLevelEnum_t level);
 
-    void Debug(const std::string& fmt);
-    void Info(const std::string& fmt);
-    void Warning(const std::string& fmt);
-    void Error(const std::string& fmt);
-    void Critical(const std::string& fmt);
+    bool IsEnabled(LogLevelEnum_t level);
+    /**
+     * @brief   Queue a message to be stamped, formatted and added to the logs by a job,
+     *          after the messages posted before it.
+     */
+    void Post(LogLevelEnum_t level, const std::string& source, std::string msg);
 
     class LogSource
     {
@@ -64,61 +68,67 @@ namespace Logging
         template<typename T = std::string>
         void Debug(const std::string& str, T val = "")
         {
+            if ( Logging::IsEnabled(LOG_LEVEL_DEBUG) == false )
+            {
+                return;
+            }
+            // The value might not outlive the call, so it's formatted now and the rest is left to a job.
             std::ostringstream msg;
+            msg << str << val;
 
-            msg << StringUtils::GetCurrentTimeFormated() << m_Source
-                << "[DEBUG   ] "
-                << str << val << "\n\r";
-
-            Logging::Debug(msg.str());
+            Logging::Post(LOG_LEVEL_DEBUG, m_Source, msg.str());
         }
 
         template<typename T = std::string>
         void Info(const std::string& str, T val = "")
         {
+            if ( Logging::IsEnabled(LOG_LEVEL_INFO) == false )
+            {
+                return;
+            }
             std::ostringstream msg;
+            msg << str << val;
 
-            msg << StringUtils::GetCurrentTimeFormated() << m_Source
-                << "[INFO    ] "
-                << str << val << "\n\r";
-
-            Logging::Info(msg.str());
+            Logging::Post(LOG_LEVEL_INFO, m_Source, msg.str());
         }
 
         template<typename T = std::string>
         void Warning(const std::string& str, T val = "")
         {
+            if ( Logging::IsEnabled(LOG_LEVEL_WARNING) == false )
+            {
+                return;
+            }
             std::ostringstream msg;
+            msg << str << val;
 
-            msg << StringUtils::GetCurrentTimeFormated() << m_Source
-                << "[WARNING ] "
-                << str << val << "\n\r";
-
-            Logging::Warning(msg.str());
+            Logging::Post(LOG_LEVEL_WARNING, m_Source, msg.str());
         }
 
         template<typename T = std::string>
         void Error(const std::string& str, T val = "")
         {
+            if ( Logging::IsEnabled(LOG_LEVEL_ERROR) == false )
+            {
+                return;
+            }
             std::ostringstream msg;
+            msg << str << val;
 
-            msg << StringUtils::GetCurrentTimeFormated() << m_Source
-                << "[ERROR   ] "
-                << str << val << "\n\r";
-
-            Logging::Error(msg.str());
+            Logging::Post(LOG_LEVEL_ERROR, m_Source, msg.str());
         }
 
         template<typename T = std::string>
         void Critical(const std::string& str, T val = "")
         {
+            if ( Logging::IsEnabled(LOG_LEVEL_CRITICAL) == false )
+            {
+                return;
+            }
             std::ostringstream msg;
+            msg << str << val;
 
-            msg << StringUtils::GetCurrentTimeFormated() << m_Source
-                << "[CRITICAL] "
-                << str << val << "\n\r";
-
-            Logging::Critical(msg.str());
+            Logging::Post(LOG_LEVEL_CRITICAL, m_Source, msg.str());
         }
 
     private:
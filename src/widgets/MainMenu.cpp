@@ -4,6 +4,8 @@
 #include "widgets/Options.h"
 
 
+static bool isMetricsOpen = false;
+
 MainMenu::MainMenu(void)
 = default;
 
@@ -28,6 +30,11 @@ void MainMenu::Process(void)
         }
     }
     ImGui::EndMenuBar();
+
+    if ( isMetricsOpen == true )
+    {
+        ImGui::ShowMetricsWindow(&isMetricsOpen);
+    }
 }
 
 void MainMenu::FileMenu(void)
@@ -55,4 +62,6 @@ void MainMenu::HelpMenu(void)
     if ( ImGui::MenuItem("About") )
     {
     }
+    ImGui::Separator();
+    ImGui::MenuItem("Metrics", nullptr, &isMetricsOpen);
 }
\ No newline at end of file